@@ -0,0 +1,125 @@
+#pragma once
+
+#include <stdint.h>
+
+// Airtime estimate per received frame, in integer arithmetic and free of ESP-IDF so the
+// host tests cover it.
+//
+// The blended busy score counts a 1 Mbps beacon and an HE MCS 11 frame of the same
+// length alike, though the beacon holds the channel ~30x longer. Every PHY rate has one
+// table entry: fixed overhead (preamble, PHY headers, SERVICE and tail bits, the 6 us
+// 2.4 GHz signal extension) plus microseconds per PSDU byte, so a frame costs one
+// lookup, one multiply and a shift. OFDM symbol padding and HE packet extension are left
+// out (at most one symbol per frame). Interframe spaces, backoff and frames that never
+// reach the aggregator (shorter than a MAC header: ACK, CTS) are not counted, so even a
+// saturated channel reads well below 100%.
+//
+// The RX callback only picks the table index (airtimeRateIndex) from rx_ctrl; the
+// aggregator turns index and length into microseconds (frameAirtimeUs).
+
+struct AirtimeRate {
+    uint16_t overheadUs;
+    uint16_t usPerByteQ12;  // 8 / Mbps in Q4.12
+};
+
+// Entry for a PHY rate of kbps; tailBits are sent at that rate after the PSDU.
+constexpr AirtimeRate airtimeEntry(uint32_t fixedUs, uint32_t kbps, uint32_t tailBits) {
+    return AirtimeRate{static_cast<uint16_t>(fixedUs + (tailBits * 1000 + kbps / 2) / kbps),
+                       static_cast<uint16_t>((8u * 1000 * 4096 + kbps / 2) / kbps)};
+}
+
+constexpr uint32_t kAirDsssLongUs = 192;    // Long preamble + PLCP header
+constexpr uint32_t kAirDsssShortUs = 96;
+constexpr uint32_t kAirOfdmUs = 16 + 4 + 6;             // L-STF/LTF, L-SIG, signal extension
+constexpr uint32_t kAirHtUs = 16 + 4 + 8 + 4 + 4 + 6;   // + HT-SIG, HT-STF, one HT-LTF
+constexpr uint32_t kAirHeSuUs = 16 + 4 + 4 + 8 + 4 + 8 + 6;  // + RL-SIG, HE-SIG-A, HE-STF, HE-LTF
+constexpr uint32_t kAirHeErSuUs = kAirHeSuUs + 8;       // HE-SIG-A sent twice as long
+constexpr uint32_t kAirOfdmTailBits = 16 + 6;           // SERVICE + tail
+
+// Table layout: non-HT frames by rx_ctrl.rate code (wifi_phy_rate_t), then HT 20/40 MHz
+// MCS 0-7 and HE SU MCS 0-11 (one spatial stream, 0.8 us GI), then HE ER SU MCS 0-2.
+constexpr uint8_t kAirtimeLegacy = 0;
+constexpr uint8_t kAirtimeHt20 = 16;
+constexpr uint8_t kAirtimeHt40 = 24;
+constexpr uint8_t kAirtimeHeSu = 32;
+constexpr uint8_t kAirtimeHeErSu = 44;
+constexpr uint8_t kAirtimeUnknown = 47;     // Counted as HE SU MCS 0
+constexpr uint8_t kAirtimeRateCount = 48;
+
+constexpr AirtimeRate kAirtimeRates[kAirtimeRateCount] = {
+    // 0x00-0x07: DSSS/CCK 1, 2, 5.5, 11 Mbps long preamble, (unused), 2, 5.5, 11 short
+    airtimeEntry(kAirDsssLongUs, 1000, 0), airtimeEntry(kAirDsssLongUs, 2000, 0),
+    airtimeEntry(kAirDsssLongUs, 5500, 0), airtimeEntry(kAirDsssLongUs, 11000, 0),
+    airtimeEntry(kAirDsssLongUs, 1000, 0), airtimeEntry(kAirDsssShortUs, 2000, 0),
+    airtimeEntry(kAirDsssShortUs, 5500, 0), airtimeEntry(kAirDsssShortUs, 11000, 0),
+    // 0x08-0x0F: OFDM 48, 24, 12, 6, 54, 36, 18, 9 Mbps
+    airtimeEntry(kAirOfdmUs, 48000, kAirOfdmTailBits), airtimeEntry(kAirOfdmUs, 24000, kAirOfdmTailBits),
+    airtimeEntry(kAirOfdmUs, 12000, kAirOfdmTailBits), airtimeEntry(kAirOfdmUs, 6000, kAirOfdmTailBits),
+    airtimeEntry(kAirOfdmUs, 54000, kAirOfdmTailBits), airtimeEntry(kAirOfdmUs, 36000, kAirOfdmTailBits),
+    airtimeEntry(kAirOfdmUs, 18000, kAirOfdmTailBits), airtimeEntry(kAirOfdmUs, 9000, kAirOfdmTailBits),
+    // HT 20 MHz
+    airtimeEntry(kAirHtUs, 6500, kAirOfdmTailBits), airtimeEntry(kAirHtUs, 13000, kAirOfdmTailBits),
+    airtimeEntry(kAirHtUs, 19500, kAirOfdmTailBits), airtimeEntry(kAirHtUs, 26000, kAirOfdmTailBits),
+    airtimeEntry(kAirHtUs, 39000, kAirOfdmTailBits), airtimeEntry(kAirHtUs, 52000, kAirOfdmTailBits),
+    airtimeEntry(kAirHtUs, 58500, kAirOfdmTailBits), airtimeEntry(kAirHtUs, 65000, kAirOfdmTailBits),
+    // HT 40 MHz
+    airtimeEntry(kAirHtUs, 13500, kAirOfdmTailBits), airtimeEntry(kAirHtUs, 27000, kAirOfdmTailBits),
+    airtimeEntry(kAirHtUs, 40500, kAirOfdmTailBits), airtimeEntry(kAirHtUs, 54000, kAirOfdmTailBits),
+    airtimeEntry(kAirHtUs, 81000, kAirOfdmTailBits), airtimeEntry(kAirHtUs, 108000, kAirOfdmTailBits),
+    airtimeEntry(kAirHtUs, 121500, kAirOfdmTailBits), airtimeEntry(kAirHtUs, 135000, kAirOfdmTailBits),
+    // HE SU 20 MHz
+    airtimeEntry(kAirHeSuUs, 8600, kAirOfdmTailBits), airtimeEntry(kAirHeSuUs, 17200, kAirOfdmTailBits),
+    airtimeEntry(kAirHeSuUs, 25800, kAirOfdmTailBits), airtimeEntry(kAirHeSuUs, 34400, kAirOfdmTailBits),
+    airtimeEntry(kAirHeSuUs, 51600, kAirOfdmTailBits), airtimeEntry(kAirHeSuUs, 68800, kAirOfdmTailBits),
+    airtimeEntry(kAirHeSuUs, 77400, kAirOfdmTailBits), airtimeEntry(kAirHeSuUs, 86000, kAirOfdmTailBits),
+    airtimeEntry(kAirHeSuUs, 103200, kAirOfdmTailBits), airtimeEntry(kAirHeSuUs, 114700, kAirOfdmTailBits),
+    airtimeEntry(kAirHeSuUs, 129000, kAirOfdmTailBits), airtimeEntry(kAirHeSuUs, 143400, kAirOfdmTailBits),
+    // HE ER SU
+    airtimeEntry(kAirHeErSuUs, 8600, kAirOfdmTailBits), airtimeEntry(kAirHeErSuUs, 17200, kAirOfdmTailBits),
+    airtimeEntry(kAirHeErSuUs, 25800, kAirOfdmTailBits),
+    // Unknown
+    airtimeEntry(kAirHeSuUs, 8600, kAirOfdmTailBits),
+};
+
+// rx_ctrl.cur_bb_format values on the C6 (wifi_rx_bb_format_t).
+constexpr uint8_t kAirtimeBb11b = 0;
+constexpr uint8_t kAirtimeBb11g = 1;
+constexpr uint8_t kAirtimeBbHt = 2;
+constexpr uint8_t kAirtimeBbHeSu = 4;
+constexpr uint8_t kAirtimeBbHeErSu = 6;
+
+// Table index for a frame, from rx_ctrl: bbFormat = cur_bb_format, rate = rate (valid
+// for non-HT only), sig = he_siga1 (HT-SIG1 for HT frames, HE-SIG-A1 for HE). HE bandwidth
+// is not decoded: the C6 receives HE at 20 MHz only. VHT, HE MU/TB (whose SIG-A carries
+// no per-user MCS) and two-stream HT are kAirtimeUnknown. Plain ifs, no tables: this runs
+// in the RX callback.
+inline uint8_t airtimeRateIndex(uint8_t bbFormat, uint8_t rate, uint32_t sig) {
+    if (bbFormat == kAirtimeBb11b || bbFormat == kAirtimeBb11g) {
+        return static_cast<uint8_t>(kAirtimeLegacy + (rate & 0x0F));
+    }
+    if (bbFormat == kAirtimeBbHt) {
+        const uint8_t mcs = sig & 0x7F;        // HT-SIG1 bits 0-6; bit 7 is 40 MHz
+        if (mcs > 7) return kAirtimeUnknown;
+        return static_cast<uint8_t>(((sig & 0x80) ? kAirtimeHt40 : kAirtimeHt20) + mcs);
+    }
+    const uint8_t heMcs = (sig >> 3) & 0x0F;   // HE-SIG-A1 bits 3-6
+    if (bbFormat == kAirtimeBbHeSu && heMcs <= 11) return static_cast<uint8_t>(kAirtimeHeSu + heMcs);
+    if (bbFormat == kAirtimeBbHeErSu && heMcs <= 2) return static_cast<uint8_t>(kAirtimeHeErSu + heMcs);
+    return kAirtimeUnknown;
+}
+
+// Table index for a non-HT rate in 500 kbps units (radiotap Rate); kAirtimeUnknown for
+// anything else. DSSS rates are taken as long preamble.
+inline uint8_t airtimeLegacyIndex(uint8_t halfMbps) {
+    static const uint8_t kRates[16] = {2, 4, 11, 22, 0, 0, 0, 0, 96, 48, 24, 12, 108, 72, 36, 18};
+    for (uint8_t i = 0; i < 16; i++) {
+        if (kRates[i] != 0 && kRates[i] == halfMbps) return static_cast<uint8_t>(kAirtimeLegacy + i);
+    }
+    return kAirtimeUnknown;
+}
+
+// Estimated time on air of a len-byte frame sent at table index `index`.
+inline uint32_t frameAirtimeUs(uint8_t index, uint16_t len) {
+    const AirtimeRate& r = kAirtimeRates[index < kAirtimeRateCount ? index : kAirtimeUnknown];
+    return r.overheadUs + ((static_cast<uint32_t>(len) * r.usPerByteQ12 + 2048) >> 12);
+}
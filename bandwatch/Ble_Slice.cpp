@@ -0,0 +1,215 @@
+#include "Ble_Slice.h"
+
+#if BANDWATCH_BLE
+
+#include "HLL_Sketch.h"
+#include "Boot_Timing.h"
+
+#include <Arduino.h>
+#include <esp_timer.h>
+
+#if __has_include(<NimBLEDevice.h>)
+  #include <NimBLEDevice.h>
+  #define BANDWATCH_USE_NIMBLE 1
+#else
+  #include <BLEDevice.h>
+  #include <BLEScan.h>
+  #define BANDWATCH_USE_NIMBLE 0
+#endif
+
+namespace {
+
+// Inside a window the scanner listens continuously (window == interval, 0.625 ms units).
+constexpr uint16_t kBleScanInterval = 16;
+constexpr uint16_t kBleScanWindow = 16;
+
+TaskHandle_t g_bleTask = nullptr;
+uint32_t g_minFreeHeap = 0;
+volatile bool g_ready = false;
+volatile bool g_wantScan = false;   // Set by the hop timer; the BLE task follows it
+volatile uint32_t g_slices = 0;
+volatile uint32_t g_adverts = 0;
+volatile uint32_t g_scanUs = 0;
+
+// Written by the BT host task in the advert callback, read and cleared under the lock.
+portMUX_TYPE g_statsMux = portMUX_INITIALIZER_UNLOCKED;
+HllSketch<6> g_uniqueDevices;
+
+void noteAdvert(const uint8_t mac[6]) {
+    const uint32_t h = hashMac48(mac);
+    portENTER_CRITICAL(&g_statsMux);
+    g_uniqueDevices.add(h);
+    portEXIT_CRITICAL(&g_statsMux);
+    g_adverts = g_adverts + 1;
+}
+
+#if BANDWATCH_USE_NIMBLE
+
+class SliceAdvCallbacks : public NimBLEAdvertisedDeviceCallbacks {
+    void onResult(NimBLEAdvertisedDevice* dev) override {
+        if (!dev) return;
+        const NimBLEAddress addr = dev->getAddress();
+        noteAdvert(addr.getNative());
+    }
+};
+
+using BleScanner = NimBLEScan;
+using ScanResults = NimBLEScanResults;
+
+BleScanner* initStack() {
+    NimBLEDevice::init("");
+    return NimBLEDevice::getScan();
+}
+
+#else
+
+class SliceAdvCallbacks : public BLEAdvertisedDeviceCallbacks {
+    void onResult(BLEAdvertisedDevice dev) override {
+        uint8_t mac[6];
+        memcpy(mac, *dev.getAddress().getNative(), sizeof(mac));
+        noteAdvert(mac);
+    }
+};
+
+using BleScanner = BLEScan;
+using ScanResults = BLEScanResults;
+
+BleScanner* initStack() {
+    BLEDevice::init("");
+    return BLEDevice::getScan();
+}
+
+#endif
+
+SliceAdvCallbacks g_advCb;
+
+void scanDone(ScanResults results) {
+    (void)results;
+}
+
+// Starts an open-ended, non-blocking scan. Libraries with a completion-callback
+// overload take it; newer NimBLE starts(duration, continue) without blocking.
+template <typename T>
+auto startOpenScan(T* scan, int) -> decltype(scan->start(0, scanDone, false), void()) {
+    scan->start(0, scanDone, false);
+}
+
+template <typename T>
+void startOpenScan(T* scan, ...) {
+    scan->start(0, false);
+}
+
+// Same duplicate-reporting overload split as BLEwatch.
+template <typename T, typename Cb>
+auto setCallbacksWithDuplicates(T* scan, Cb* cb, int) -> decltype(scan->setAdvertisedDeviceCallbacks(cb, true), void()) {
+    scan->setAdvertisedDeviceCallbacks(cb, true);
+}
+
+template <typename T, typename Cb>
+void setCallbacksWithDuplicates(T* scan, Cb* cb, ...) {
+    scan->setAdvertisedDeviceCallbacks(cb);
+}
+
+void bleTask(void* param) {
+    (void)param;
+    const uint32_t heapBefore = ESP.getFreeHeap();
+    BleScanner* scan = initStack();
+    const uint32_t heapAfter = ESP.getFreeHeap();
+    printf("ble: stack uses %lu B heap, %lu B left\r\n",
+           static_cast<unsigned long>(heapBefore - heapAfter), static_cast<unsigned long>(heapAfter));
+    if (heapAfter < g_minFreeHeap) {
+        // Keep Wi-Fi capture healthy rather than run both stacks starved.
+        printf("ble: below the %lu B heap budget, BLE slices disabled\r\n",
+               static_cast<unsigned long>(g_minFreeHeap));
+        g_bleTask = nullptr;
+        vTaskDelete(nullptr);
+        return;
+    }
+    setCallbacksWithDuplicates(scan, &g_advCb, 0);
+    scan->setActiveScan(false);  // Passive: no scan requests eating into Wi-Fi slices
+    scan->setInterval(kBleScanInterval);
+    scan->setWindow(kBleScanWindow);
+    g_ready = true;
+    Boot_Mark("ble slices ready");
+
+    bool scanning = false;
+    int64_t startedUs = 0;
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        // Follow the latest requested state; notifications that pile up collapse into one.
+        const bool want = g_wantScan;
+        if (!want && scanning) {
+            scan->stop();
+            scan->clearResults();
+            g_scanUs = g_scanUs + static_cast<uint32_t>(esp_timer_get_time() - startedUs);
+            g_slices = g_slices + 1;
+            scanning = false;
+        } else if (want && !scanning) {
+            startedUs = esp_timer_get_time();
+            startOpenScan(scan, 0);
+            scanning = true;
+        }
+    }
+}
+
+} // namespace
+
+bool BleSlice_Init(uint32_t minFreeHeap) {
+    if (g_bleTask) return true;
+    g_minFreeHeap = minFreeHeap;
+    g_uniqueDevices.clear();
+    // Stack init blocks for tens of ms; keep it off the capture and UI paths.
+    return xTaskCreatePinnedToCore(
+        bleTask,
+        "bw_ble",
+        4096,
+        nullptr,
+        2,
+        &g_bleTask,
+        0
+    ) == pdPASS;
+}
+
+bool BleSlice_Ready() {
+    return g_ready;
+}
+
+void BleSlice_Begin() {
+    if (!g_ready) return;
+    g_wantScan = true;
+    xTaskNotifyGive(g_bleTask);
+}
+
+void BleSlice_End() {
+    if (!g_ready) return;
+    g_wantScan = false;
+    xTaskNotifyGive(g_bleTask);
+}
+
+void BleSlice_TakeStats(BleSliceStats* out) {
+    out->slices = g_slices;
+    out->adverts = g_adverts;
+    out->scanUs = g_scanUs;
+    out->ready = g_ready;
+    portENTER_CRITICAL(&g_statsMux);
+    const HllSketch<6> window = g_uniqueDevices;
+    g_uniqueDevices.clear();
+    portEXIT_CRITICAL(&g_statsMux);
+    const uint32_t unique = window.estimate();
+    out->uniqueDevices = static_cast<uint16_t>(unique > 0xFFFF ? 0xFFFF : unique);
+}
+
+#else
+
+bool BleSlice_Init(uint32_t minFreeHeap) {
+    (void)minFreeHeap;
+    return false;
+}
+bool BleSlice_Ready() { return false; }
+void BleSlice_Begin() {}
+void BleSlice_End() {}
+void BleSlice_TakeStats(BleSliceStats* out) {
+    *out = BleSliceStats{};
+}
+
+#endif
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+
+// Set to 1 to build Bandwatch with BLE scan slices (one image watching Wi-Fi and BLE).
+// Costs ~250 KB (NimBLE) to ~500 KB (Bluedroid) of flash and 40-100 KB of heap.
+#ifndef BANDWATCH_BLE
+#define BANDWATCH_BLE 0
+#endif
+
+// BLE side of the radio time-slicer. The hop timer owns the schedule: it calls
+// BleSlice_Begin() when a BLE window starts and BleSlice_End() when Wi-Fi takes the
+// radio back; both only notify the BLE task, so they are safe from esp_timer context.
+// The scan runs continuously inside a window and is stopped between windows, so BLE
+// only contends for the shared radio during its own slices.
+
+struct BleSliceStats {
+    uint32_t slices;        // Completed BLE windows
+    uint32_t adverts;       // Advertisements received inside them
+    uint32_t scanUs;        // Radio time given to BLE (measured start to stop)
+    uint16_t uniqueDevices; // Distinct addresses over the last stats window
+    bool ready;             // Stack initialised and within the heap budget
+};
+
+// Initialises the BLE stack on its own task. Slices are skipped (Wi-Fi keeps the
+// radio) until ready, or for good if less than minFreeHeap bytes remain afterwards.
+bool BleSlice_Init(uint32_t minFreeHeap);
+bool BleSlice_Ready();
+void BleSlice_Begin();
+void BleSlice_End();
+
+// Cumulative counters; uniqueDevices is reset on every call (stats window).
+void BleSlice_TakeStats(BleSliceStats* out);
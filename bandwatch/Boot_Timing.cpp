@@ -0,0 +1,44 @@
+#include "Boot_Timing.h"
+#include <esp_timer.h>
+
+#define BOOT_MAX_MARKS 12
+
+struct BootMark {
+  const char* stage;
+  int64_t us;
+};
+
+static BootMark bootMarks[BOOT_MAX_MARKS];
+static uint8_t bootMarkCount = 0;
+static bool bootReported = false;
+static portMUX_TYPE bootMux = portMUX_INITIALIZER_UNLOCKED;  // Marks come from several tasks
+
+void Boot_Mark(const char* stage)
+{
+  const int64_t now = esp_timer_get_time();
+  portENTER_CRITICAL(&bootMux);
+  if (!bootReported && bootMarkCount < BOOT_MAX_MARKS) {
+    bootMarks[bootMarkCount].stage = stage;
+    bootMarks[bootMarkCount].us = now;
+    bootMarkCount++;
+  }
+  portEXIT_CRITICAL(&bootMux);
+}
+
+void Boot_Report(void)
+{
+  portENTER_CRITICAL(&bootMux);
+  const bool skip = bootReported || bootMarkCount == 0;
+  bootReported = true;
+  portEXIT_CRITICAL(&bootMux);
+  if (skip) return;
+  // esp_timer starts at 0 on reset, so the first column is time since power-on.
+  printf("boot: %-16s %7s %7s\r\n", "stage", "t(ms)", "+ms");
+  int64_t prev = 0;
+  for (uint8_t i = 0; i < bootMarkCount; i++) {
+    printf("boot: %-16s %7lu %7lu\r\n", bootMarks[i].stage,
+           (unsigned long)(bootMarks[i].us / 1000),
+           (unsigned long)((bootMarks[i].us - prev) / 1000));
+    prev = bootMarks[i].us;
+  }
+}
@@ -0,0 +1,8 @@
+#pragma once
+#include <Arduino.h>
+
+// Boot-time breakdown: stages are stamped with esp_timer time since reset and printed
+// once on serial by Boot_Report(), so regressions in time-to-first-frame show up
+// on every power cycle.
+void Boot_Mark(const char* stage);
+void Boot_Report(void);
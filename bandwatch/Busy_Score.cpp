@@ -0,0 +1,144 @@
+#include "Busy_Score.h"
+
+#ifdef BUSY_SCORE_FLOAT_REFERENCE
+#include <math.h>
+#endif
+
+namespace {
+
+// round(log2(1 + k/64) * 65536), k = 0..64
+constexpr uint32_t kLog2Table[65] = {
+    0, 1466, 2909, 4331, 5732, 7112, 8473, 9814,
+    11136, 12440, 13727, 14996, 16248, 17484, 18704, 19909,
+    21098, 22272, 23433, 24579, 25711, 26830, 27936, 29029,
+    30109, 31178, 32234, 33279, 34312, 35334, 36346, 37346,
+    38336, 39316, 40286, 41246, 42196, 43137, 44068, 44990,
+    45904, 46809, 47705, 48593, 49472, 50344, 51207, 52063,
+    52911, 53751, 54584, 55410, 56229, 57040, 57845, 58643,
+    59434, 60219, 60997, 61769, 62534, 63294, 64047, 64794,
+    65536,
+};
+
+// round(2^40 / (log2(ref) * 65536)): multiply a Q16 log2 by this and shift by 24
+// to get log2(x) / log2(ref) in Q16.
+constexpr uint32_t kInvLog2PpsQ24 = 1817915;     // ref 600
+constexpr uint32_t kInvLog2BpsQ24 = 1074799;     // ref 50000
+constexpr uint32_t kInvLog2UniqueQ24 = 2796203;  // ref 64
+
+// Term weights in Q16 (0.40, 0.30, 0.20, 0.10; sum 65536).
+constexpr uint32_t kWeightPps = 26214;
+constexpr uint32_t kWeightBps = 19661;
+constexpr uint32_t kWeightStrong = 13107;
+constexpr uint32_t kWeightUnique = 6554;
+
+constexpr uint32_t kOneQ16 = 65536;
+constexpr uint64_t kUsPerSec = 1000000;
+
+inline int clz64(uint64_t x) {
+    const uint32_t hi = static_cast<uint32_t>(x >> 32);
+    if (hi) return __builtin_clz(hi);
+    return 32 + __builtin_clz(static_cast<uint32_t>(x));
+}
+
+// log2(x) / log2(ref), clamped to [0, 1], Q16.
+inline uint32_t scaledTerm(uint32_t log2q16, uint32_t invLog2RefQ24) {
+    const uint64_t t = (static_cast<uint64_t>(log2q16) * invLog2RefQ24) >> 24;
+    return (t > kOneQ16) ? kOneQ16 : static_cast<uint32_t>(t);
+}
+
+// log2(1 + count / dwellSec) = log2(dwellUs + count * 1e6) - log2(dwellUs); no divides.
+inline uint32_t log1pRateQ16(uint32_t count, uint32_t dwellUs, uint32_t log2Dwell) {
+    const uint32_t l = log2Q16(static_cast<uint64_t>(dwellUs) + static_cast<uint64_t>(count) * kUsPerSec);
+    return (l > log2Dwell) ? (l - log2Dwell) : 0;
+}
+
+} // namespace
+
+uint32_t log2Q16(uint64_t x) {
+    if (x == 0) return 0;
+    const int n = 63 - clz64(x);
+    const uint64_t m = x << (63 - n);                             // Leading one at bit 63
+    const uint32_t idx = static_cast<uint32_t>(m >> 57) & 0x3F;    // Next 6 bits
+    const uint32_t rem = static_cast<uint32_t>(m >> 41) & 0xFFFF;  // Next 16 bits
+    const uint32_t lo = kLog2Table[idx];
+    const uint32_t hi = kLog2Table[idx + 1];
+    return (static_cast<uint32_t>(n) << 16) + lo + (((hi - lo) * rem) >> 16);
+}
+
+uint16_t computeBusyScoreQ8(const ChannelMetrics& m, uint32_t nominalDwellUs) {
+    const uint32_t dwellUs = (m.dwellUs > 0) ? m.dwellUs : nominalDwellUs;
+    if (dwellUs == 0) return 0;
+    const uint32_t log2Dwell = log2Q16(dwellUs);
+
+    const uint32_t ppsTerm = scaledTerm(log1pRateQ16(m.frames, dwellUs, log2Dwell), kInvLog2PpsQ24);
+    const uint32_t bpsTerm = scaledTerm(log1pRateQ16(m.bytes, dwellUs, log2Dwell), kInvLog2BpsQ24);
+    const uint32_t uniqueTerm = scaledTerm(log2Q16(static_cast<uint64_t>(m.unique) + 1), kInvLog2UniqueQ24);
+    uint32_t strongTerm = 0;
+    if (m.frames > 0) {
+        // One divide per dwell; strong <= frames so the ratio is already in [0, 1].
+        strongTerm = static_cast<uint32_t>((static_cast<uint64_t>(m.strong) << 16) / m.frames);
+        if (strongTerm > kOneQ16) strongTerm = kOneQ16;
+    }
+
+    const uint64_t raw = static_cast<uint64_t>(kWeightPps) * ppsTerm + static_cast<uint64_t>(kWeightBps) * bpsTerm +
+                         static_cast<uint64_t>(kWeightStrong) * strongTerm +
+                         static_cast<uint64_t>(kWeightUnique) * uniqueTerm;  // Q32
+    const uint32_t rawQ16 = static_cast<uint32_t>(raw >> 16);
+    const uint32_t score = (rawQ16 * static_cast<uint32_t>(100) + (kOneQ16 >> 9)) >> 8;  // Q16 -> Q8.8 points
+    return static_cast<uint16_t>(score > kBusyScoreMax ? kBusyScoreMax : score);
+}
+
+uint16_t computeAirtimeScoreQ8(const ChannelMetrics& m, uint32_t nominalDwellUs) {
+    const uint32_t dwellUs = (m.dwellUs > 0) ? m.dwellUs : nominalDwellUs;
+    if (dwellUs == 0) return 0;
+    const uint64_t score = (static_cast<uint64_t>(m.airtimeUs) * kBusyScoreMax + dwellUs / 2) / dwellUs;
+    return static_cast<uint16_t>(score > kBusyScoreMax ? kBusyScoreMax : score);
+}
+
+void updateBusyEma(uint16_t& ema, uint32_t& var, bool& hasData, uint16_t score, uint16_t alphaQ16) {
+    if (!hasData) {
+        ema = score;
+        var = 0;
+        hasData = true;
+        return;
+    }
+    const int32_t delta = static_cast<int32_t>(score) - static_cast<int32_t>(ema);
+    const int32_t step = (delta * static_cast<int32_t>(alphaQ16)) / static_cast<int32_t>(kOneQ16);
+    ema = static_cast<uint16_t>(static_cast<int32_t>(ema) + step);
+    // var' = (1 - a) * (var + a * delta^2), delta^2 kept as Q8 of points^2.
+    const uint32_t d2 = static_cast<uint32_t>(delta * delta) >> 8;
+    const uint32_t inner = var + static_cast<uint32_t>((static_cast<uint64_t>(d2) * alphaQ16) >> 16);
+    var = static_cast<uint32_t>((static_cast<uint64_t>(inner) * (kOneQ16 - alphaQ16)) >> 16);
+}
+
+uint16_t isqrt32(uint32_t v) {
+    uint32_t res = 0;
+    uint32_t bit = 1u << 30;
+    while (bit > v) bit >>= 2;
+    while (bit != 0) {
+        if (v >= res + bit) {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return static_cast<uint16_t>(res);
+}
+
+#ifdef BUSY_SCORE_FLOAT_REFERENCE
+float computeBusyScoreRef(const ChannelMetrics& m, uint32_t nominalDwellUs) {
+    const uint32_t dwellUs = (m.dwellUs > 0) ? m.dwellUs : nominalDwellUs;
+    const float dwellSec = static_cast<float>(dwellUs) / 1000000.0f;
+    const float pps = m.frames / dwellSec;
+    const float bps = m.bytes / dwellSec;
+    const float strongRatio = (m.frames > 0) ? (static_cast<float>(m.strong) / static_cast<float>(m.frames)) : 0.0f;
+    auto clamp01 = [](float v) { return v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v); };
+    const float ppsScore = clamp01(log1pf(pps) / logf(static_cast<float>(kBusyPpsRef)));
+    const float bpsScore = clamp01(log1pf(bps) / logf(static_cast<float>(kBusyBpsRef)));
+    const float uniqueScore = clamp01(log1pf(static_cast<float>(m.unique)) / logf(static_cast<float>(kBusyUniqueRef)));
+    const float raw = 0.40f * ppsScore + 0.30f * bpsScore + 0.20f * strongRatio + 0.10f * uniqueScore;
+    return clamp01(raw) * 100.0f;
+}
+#endif
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+
+// Busy-score engine in integer / Q-format arithmetic.
+//
+// The ESP32-C6 RISC-V core has no FPU, so the float formula (log1pf/logf and divides
+// per channel) ran entirely in soft-float. This engine uses a 65-entry log2 table with
+// linear interpolation, integer multiplies and one divide per dwell, and is bit-for-bit
+// reproducible on any target. The float formula is kept as computeBusyScoreRef() for
+// host-side comparison only.
+
+struct ChannelMetrics {
+    uint32_t frames = 0;
+    uint32_t bytes = 0;
+    uint16_t strong = 0;
+    uint16_t unique = 0;
+    uint32_t dwellUs = 0;      // Measured dwell duration (hop to hop)
+    uint32_t airtimeUs = 0;    // Estimated on-air time of the dwell's frames (Airtime.h)
+};
+
+// Scores are Q8.8 points: 0 .. 100 << 8.
+constexpr uint16_t kBusyScoreOne = 256;
+constexpr uint16_t kBusyScoreMax = 100 * kBusyScoreOne;
+
+// Reference points where each log-scaled term saturates.
+constexpr uint32_t kBusyPpsRef = 600;       // ~600 pps -> near 1
+constexpr uint32_t kBusyBpsRef = 50000;     // ~50 KB/s -> near 1
+constexpr uint32_t kBusyUniqueRef = 64;     // Talkers per dwell where the unique term saturates
+
+// log2(x) in Q16.16 for x >= 1 (returns 0 for x == 0). Max error ~2e-5.
+uint32_t log2Q16(uint64_t x);
+
+// Busy score (Q8.8 points) for one dwell. dwellUs == 0 falls back to nominalDwellUs.
+uint16_t computeBusyScoreQ8(const ChannelMetrics& m, uint32_t nominalDwellUs);
+
+// Estimated airtime as a share of the dwell (Q8.8 points, i.e. percent), the
+// alternative busy score: one divide, no logs. dwellUs == 0 falls back to nominalDwellUs.
+uint16_t computeAirtimeScoreQ8(const ChannelMetrics& m, uint32_t nominalDwellUs);
+
+// Exponentially weighted mean and variance of the score, alpha in Q16.
+// var is in Q8.8-points squared >> 8 (i.e. Q8 of points^2).
+void updateBusyEma(uint16_t& ema, uint32_t& var, bool& hasData, uint16_t score, uint16_t alphaQ16);
+
+// floor(sqrt(v)).
+uint16_t isqrt32(uint32_t v);
+
+// Standard deviation of the score in Q8.8 points, from updateBusyEma()'s var.
+inline uint16_t busyStdDevQ8(uint32_t var) { return isqrt32(var << 8); }
+
+// Rounded integer points for display.
+inline unsigned busyScorePoints(uint16_t q8) { return (static_cast<unsigned>(q8) + kBusyScoreOne / 2) >> 8; }
+
+#ifdef BUSY_SCORE_FLOAT_REFERENCE
+// Original float formula (0–100), for host tests only.
+float computeBusyScoreRef(const ChannelMetrics& m, uint32_t nominalDwellUs);
+#endif
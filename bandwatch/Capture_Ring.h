@@ -0,0 +1,119 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+
+// Single-producer / single-consumer ring of fixed-size records.
+//
+// The producer (Wi-Fi RX callback) only writes head_, the consumer (aggregation task)
+// only writes tail_, so neither side ever takes a lock or masks interrupts. When the
+// ring is full the record is discarded and counted in dropped() instead of blocking.
+template <typename T, size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+public:
+    // Producer side. Returns false (and counts a drop) when the ring is full.
+    inline bool push(const T& item) {
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        const uint32_t tail = tail_.load(std::memory_order_acquire);
+        if ((head - tail) >= N) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        slots_[head & (N - 1)] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false when the ring is empty.
+    inline bool pop(T& out) {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        const uint32_t head = head_.load(std::memory_order_acquire);
+        if (tail == head) return false;
+        out = slots_[tail & (N - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() const {
+        return static_cast<size_t>(head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire));
+    }
+
+    static constexpr size_t capacity() { return N; }
+
+    // Total records discarded because the consumer fell behind (monotonic).
+    uint32_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    T slots_[N];
+    std::atomic<uint32_t> head_{0};
+    std::atomic<uint32_t> tail_{0};
+    std::atomic<uint32_t> dropped_{0};
+};
+
+// Single-producer / single-consumer ring of variable-length byte records.
+//
+// Same ownership rules as SpscRing. push() copies a header and payload as one record
+// or drops it whole (counted in dropped()/droppedBytes()), so the consumer never sees
+// a partial record: once the first byte of a record is readable, all of it is.
+template <size_t N>
+class SpscByteRing {
+    static_assert(N >= 64 && (N & (N - 1)) == 0, "SpscByteRing size must be a power of two");
+
+public:
+    // Producer side.
+    inline bool push(const void* hdr, size_t hdrLen, const void* data, size_t dataLen) {
+        const uint32_t need = static_cast<uint32_t>(hdrLen + dataLen);
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        const uint32_t tail = tail_.load(std::memory_order_acquire);
+        if (need > N - (head - tail)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            droppedBytes_.fetch_add(need, std::memory_order_relaxed);
+            return false;
+        }
+        copyIn(head, hdr, hdrLen);
+        copyIn(head + static_cast<uint32_t>(hdrLen), data, dataLen);
+        head_.store(head + need, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: bytes readable right now.
+    size_t available() const {
+        return static_cast<size_t>(head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed));
+    }
+
+    // Consumer side. Copies and consumes len bytes; false (nothing consumed) if fewer are readable.
+    bool read(void* out, size_t len) {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        const uint32_t head = head_.load(std::memory_order_acquire);
+        if ((head - tail) < len) return false;
+        const uint32_t off = tail & (N - 1);
+        const size_t first = (len < N - off) ? len : N - off;
+        memcpy(out, buf_ + off, first);
+        memcpy(static_cast<uint8_t*>(out) + first, buf_, len - first);
+        tail_.store(tail + static_cast<uint32_t>(len), std::memory_order_release);
+        return true;
+    }
+
+    static constexpr size_t capacity() { return N; }
+    uint32_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint32_t droppedBytes() const { return droppedBytes_.load(std::memory_order_relaxed); }
+
+private:
+    inline void copyIn(uint32_t pos, const void* src, size_t len) {
+        if (len == 0) return;
+        const uint32_t off = pos & (N - 1);
+        const size_t first = (len < N - off) ? len : N - off;
+        memcpy(buf_ + off, src, first);
+        memcpy(buf_, static_cast<const uint8_t*>(src) + first, len - first);
+    }
+
+    uint8_t buf_[N];
+    std::atomic<uint32_t> head_{0};
+    std::atomic<uint32_t> tail_{0};
+    std::atomic<uint32_t> dropped_{0};
+    std::atomic<uint32_t> droppedBytes_{0};
+};
@@ -1,6 +1,5 @@
 #pragma once
 #include <Arduino.h>
-#include <SPI.h>
 #define LCD_WIDTH   172 //LCD width
 #define LCD_HEIGHT  320 //LCD height
 
@@ -18,15 +17,54 @@
 #define VERTICAL   0
 #define HORIZONTAL 1
 
+// Panel orientation, resolved at compile time (window math and MADCTL).
+#ifndef LCD_ORIENTATION
+#define LCD_ORIENTATION HORIZONTAL
+#endif
+
 #define Offset_X 34
 #define Offset_Y 0
 
 
 void LCD_SetCursor(uint16_t x1, uint16_t y1, uint16_t x2,uint16_t y2);
 
-void LCD_Init(void);
+// One command and its parameter bytes. A list is sent with CS held asserted for the
+// whole list and one bus acquisition, instead of a transaction per byte.
+typedef struct {
+  uint8_t cmd;
+  uint8_t len;
+  uint8_t data[14];
+  uint8_t delayMs;      // Settle time after this command (honoured by the init sequence)
+} LCD_Cmd;
+
+void LCD_WriteCommandList(const LCD_Cmd* cmds, uint8_t count);
+
+void LCD_Init(void);                  // Blocking init (runs LCD_InitStep to completion)
+void LCD_InitAsync(void);             // Configure pins/SPI and start the panel reset
+bool LCD_InitStep(void);              // Advance the init sequence; true once the panel is ready
+bool LCD_IsReady(void);
 void LCD_SetCursor(uint16_t Xstart, uint16_t Ystart, uint16_t Xend, uint16_t  Yend);
 void LCD_addWindow(uint16_t Xstart, uint16_t Ystart, uint16_t Xend, uint16_t Yend,uint16_t* color);
 
+// Async flush: queued on the SPI DMA; cb runs from the SPI interrupt once the pixels
+// have been sent (buffer may be reused from then on).
+typedef void (*LCD_FlushDoneCb)(void* arg);
+void LCD_addWindowAsync(uint16_t Xstart, uint16_t Ystart, uint16_t Xend, uint16_t Yend,
+                        const uint16_t* color, LCD_FlushDoneCb cb, void* arg);
+void LCD_WaitIdle(void);              // Block until every queued transfer has finished
+
+// Hardware vertical scrolling (VSCRDEF 0x33 / VSCSAD 0x37). Rows [top, top + lines)
+// become a ring the panel rotates by itself; the rows above and below stay fixed.
+// LCD_ScrollPushRows() writes new rows in at the top of the region and moves the
+// start address, so the older rows shift down without being resent. While a region
+// is defined the LVGL flush skips it (LCD_ScrollRegion), so LVGL owns only the fixed
+// bands. The panel scrolls along its 320 rows, i.e. vertically in portrait only.
+#define LCD_SCROLL_LINES  320             // Frame memory rows: top + scroll + bottom
+#define LCD_CAN_SCROLL    (LCD_ORIENTATION == HORIZONTAL)
+bool LCD_ScrollDefine(uint16_t top, uint16_t lines);   // Start address reset to the region top
+void LCD_ScrollReset(void);                             // Whole panel static again
+bool LCD_ScrollRegion(uint16_t* top, uint16_t* lines);  // False when no region is defined
+void LCD_ScrollPushRows(const uint16_t* color, uint16_t rows);  // rows x LCD_WIDTH px, blocking
+
 void Backlight_Init(void);
 void Set_Backlight(uint8_t Light);
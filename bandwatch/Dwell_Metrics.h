@@ -0,0 +1,100 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include "Airtime.h"
+#include "Busy_Score.h"
+#include "HLL_Sketch.h"
+
+// Per-dwell aggregation and per-channel state, free of ESP-IDF and LVGL so the same
+// code runs in the firmware and in the host tests and benchmarks (tests/, bench/).
+//
+// The RX callback turns each frame into a FrameRecord; the aggregator folds records
+// into a DwellAccum, and when the dwell closes its snapshot is scored and folded
+// into the channel's ChannelState (EMA and variance of the busy score).
+
+constexpr uint8_t kDwellSketchBits = 7;     // 128-register HLL per dwell (~9% error, exact when small)
+using DwellSketch = HllSketch<kDwellSketchBits>;
+
+// Compact per-frame record handed from promiscuousCb to the aggregator task.
+struct FrameRecord {
+    uint16_t len;
+    int8_t rssi;
+    uint8_t type;
+    uint8_t epoch;      // Dwell generation the frame was captured in
+    uint8_t ta[6];      // Transmitter address (addr2)
+    uint8_t rate;       // Airtime table index (airtimeRateIndex)
+};
+static_assert(sizeof(FrameRecord) == 12, "FrameRecord should stay compact");
+
+struct DwellAccum {
+    uint32_t frames = 0;
+    uint32_t bytes = 0;
+    uint16_t strong = 0;
+    uint32_t airtimeUs = 0;
+    DwellSketch talkers;   // Unique transmitters (full 48-bit TA) this dwell
+
+    inline void add(const FrameRecord& rec, int strongThresholdDbm) {
+        frames += 1;
+        bytes += rec.len;
+        airtimeUs += frameAirtimeUs(rec.rate, rec.len);
+        if (rec.rssi >= strongThresholdDbm) {
+            strong += 1;
+        }
+        talkers.add(hashMac48(rec.ta));
+    }
+
+    void clear() {
+        frames = 0;
+        bytes = 0;
+        strong = 0;
+        airtimeUs = 0;
+        talkers.clear();
+    }
+
+    ChannelMetrics snapshot(uint32_t dwellUs) const {
+        ChannelMetrics m{};
+        m.frames = frames;
+        m.bytes = bytes;
+        m.strong = strong;
+        const uint32_t unique = talkers.estimate();
+        m.unique = static_cast<uint16_t>(unique > 0xFFFF ? 0xFFFF : unique);
+        m.dwellUs = dwellUs;
+        m.airtimeUs = airtimeUs;
+        return m;
+    }
+};
+
+struct ChannelState {
+    ChannelMetrics metrics;
+    uint16_t busyCurrent = 0;  // Last dwell busy score (Q8.8 points, 0–100)
+    uint16_t busyEma = 0;      // Smoothed busy score (Q8.8 points)
+    uint32_t busyVar = 0;      // Exponentially weighted variance (see updateBusyEma)
+    bool hasData = false;
+    uint16_t talkerEstimate = 0;  // Per-channel transmitters, refreshed every dwell
+    uint16_t ctrlFrames = 0;      // Control frames tallied last dwell (not part of the score)
+    uint16_t airtimeQ8 = 0;       // Estimated airtime of the last dwell (Q8.8 percent of the dwell)
+
+    // Records a finished dwell and its score, and updates the smoothed score.
+    void applyDwell(const ChannelMetrics& m, uint16_t score, uint16_t alphaQ16) {
+        metrics = m;
+        busyCurrent = score;
+        updateBusyEma(busyEma, busyVar, hasData, score, alphaQ16);
+    }
+};
+
+// Indices of the three channels with the highest smoothed score (-1 where fewer
+// than three have data). Ties keep the lower channel first.
+inline void sortTop3(const ChannelState* chans, int count, int outIdx[3]) {
+    for (int i = 0; i < 3; i++) outIdx[i] = -1;
+    for (int i = 0; i < count; i++) {
+        if (!chans[i].hasData) continue;
+        for (int pos = 0; pos < 3; pos++) {
+            if (outIdx[pos] == -1 || chans[i].busyEma > chans[outIdx[pos]].busyEma) {
+                for (int shift = 2; shift > pos; shift--) outIdx[shift] = outIdx[shift - 1];
+                outIdx[pos] = i;
+                break;
+            }
+        }
+    }
+}
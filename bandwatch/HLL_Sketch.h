@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include "Busy_Score.h"  // log2Q16
+
+// Fixed-memory HyperLogLog cardinality sketch (2^P one-byte registers).
+//
+// add() is O(1) and branch-light so it can run on the capture path; estimate() is
+// O(2^P) and meant for dwell/UI cadence. Relative standard error is ~1.04/sqrt(2^P),
+// and small cardinalities fall back to linear counting, which is near exact. The
+// estimate is all integer (log2Q16 for linear counting), since the C6 has no FPU.
+template <uint8_t P>
+class HllSketch {
+    static_assert(P >= 4 && P <= 12, "HllSketch precision out of range");
+
+public:
+    static constexpr uint16_t kRegisters = static_cast<uint16_t>(1u << P);
+
+    void clear() { memset(regs_, 0, sizeof(regs_)); }
+
+    inline void add(uint32_t hash) {
+        const uint32_t idx = hash >> (32 - P);
+        // Guard bit keeps clz() defined and bounds the rank at 32 - P + 1.
+        const uint32_t w = (hash << P) | (1u << (P - 1));
+        const uint8_t rank = static_cast<uint8_t>(__builtin_clz(w) + 1);
+        if (rank > regs_[idx]) regs_[idx] = rank;
+    }
+
+    // Register-wise max: the result estimates the union of both sets.
+    void merge(const HllSketch& other) {
+        for (uint16_t i = 0; i < kRegisters; i++) {
+            if (other.regs_[i] > regs_[i]) regs_[i] = other.regs_[i];
+        }
+    }
+
+    uint32_t estimate() const {
+        // sum(2^-M[j]) scaled by 2^32 so it accumulates exactly in integers.
+        uint64_t sum = 0;
+        uint16_t zeros = 0;
+        for (uint16_t i = 0; i < kRegisters; i++) {
+            sum += static_cast<uint64_t>(1) << (32 - regs_[i]);
+            if (regs_[i] == 0) zeros++;
+        }
+        // alpha * m^2 * 2^32 / sum, with alpha * m^2 in Q16.
+        const uint64_t raw = ((kAlphaMm2Q16 << 16) + sum / 2) / sum;
+        if (raw * 2 <= 5ull * kRegisters && zeros > 0) {
+            // m * ln(m / zeros) = m * ln2 * (P - log2(zeros))
+            const uint64_t log2Ratio = (static_cast<uint64_t>(P) << 16) - log2Q16(zeros);  // Q16
+            return static_cast<uint32_t>((kRegisters * kLn2Q16 * log2Ratio + (1ull << 31)) >> 32);
+        }
+        return static_cast<uint32_t>(raw);
+    }
+
+private:
+    static constexpr double alpha() {
+        return (kRegisters == 16) ? 0.673
+             : (kRegisters == 32) ? 0.697
+             : (kRegisters == 64) ? 0.709
+             : 0.7213 / (1.0 + 1.079 / kRegisters);
+    }
+
+    // Folded at compile time; nothing here runs in floating point.
+    static constexpr uint64_t kAlphaMm2Q16 =
+        static_cast<uint64_t>(alpha() * kRegisters * kRegisters * 65536.0 + 0.5);
+    static constexpr uint64_t kLn2Q16 = 45426;  // round(ln 2 * 2^16)
+
+    uint8_t regs_[kRegisters] = {0};
+};
+
+// 32-bit hash of a full 48-bit MAC (murmur3 finalizer over both halves).
+inline uint32_t hashMac48(const uint8_t mac[6]) {
+    const uint32_t hi = (static_cast<uint32_t>(mac[0]) << 8) | mac[1];
+    const uint32_t lo = (static_cast<uint32_t>(mac[2]) << 24) | (static_cast<uint32_t>(mac[3]) << 16) |
+                        (static_cast<uint32_t>(mac[4]) << 8) | mac[5];
+    uint32_t h = lo ^ (hi * 0x9E3779B1u);
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
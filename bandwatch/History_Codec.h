@@ -0,0 +1,139 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// One history entry: a channel's totals over one history slot (one or more dwells).
+struct HistoryRecord {
+    uint32_t bootId;     // Boot counter; there is no RTC, so (bootId, timeMs) orders records
+    uint32_t timeMs;     // Uptime at the end of the slot (10 ms resolution once stored)
+    uint8_t channel;     // 1..13
+    uint16_t dwells;     // Dwells folded into this record
+    uint32_t frames;
+    uint32_t bytes;
+    uint32_t strong;
+    uint16_t unique;     // Largest per-dwell unique-transmitter estimate
+    uint16_t scoreQ8;    // Mean per-dwell busy score (Q8.8 points)
+};
+
+constexpr uint32_t kHistoryTimeUnitMs = 10;
+constexpr uint8_t kHistoryMaxChannel = 14;
+// Tag byte + time + dwells + five deltas, all at their longest varint length.
+constexpr size_t kHistoryMaxRecordBytes = 1 + 5 + 3 + 5 * 5;
+
+// Delta state shared by encoder and decoder. It is reset at the start of every flash
+// sector, so each sector decodes without reading the ones before it.
+struct HistoryCodecState {
+    struct Prev {
+        uint32_t frames;
+        uint32_t bytes;
+        uint32_t strong;
+        uint16_t unique;
+        uint16_t score;
+    };
+    uint32_t timeUnits;
+    Prev prev[kHistoryMaxChannel + 1];
+
+    void reset(uint32_t baseUnits) {
+        timeUnits = baseUnits;
+        memset(prev, 0, sizeof(prev));
+    }
+};
+
+inline size_t historyPutVarint(uint8_t* out, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = static_cast<uint8_t>(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = static_cast<uint8_t>(v);
+    return n;
+}
+
+inline bool historyGetVarint(const uint8_t*& p, const uint8_t* end, uint32_t& v) {
+    v = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7) {
+        if (p >= end) return false;
+        const uint8_t b = *p++;
+        v |= static_cast<uint32_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+// Signed deltas map to small unsigned varints: 0, -1, 1, -2, ... -> 0, 1, 2, 3, ...
+inline uint32_t historyZigzag(uint32_t cur, uint32_t prev) {
+    const int32_t d = static_cast<int32_t>(cur - prev);
+    return (static_cast<uint32_t>(d) << 1) ^ static_cast<uint32_t>(d >> 31);
+}
+
+inline uint32_t historyUnzigzag(uint32_t z, uint32_t prev) {
+    return prev + ((z >> 1) ^ (0u - (z & 1)));
+}
+
+// Record layout: channel byte (never 0xFF), varint time delta in kHistoryTimeUnitMs
+// units, varint dwells, then zigzag deltas against the previous record of the same
+// channel for frames, bytes, strong, unique and score. Returns the encoded length
+// (at most kHistoryMaxRecordBytes). Records must arrive in time order.
+inline size_t historyEncode(HistoryCodecState& st, const HistoryRecord& r, uint8_t* out) {
+    const uint8_t ch = (r.channel <= kHistoryMaxChannel) ? r.channel : 0;
+    HistoryCodecState::Prev& p = st.prev[ch];
+    const uint32_t units = r.timeMs / kHistoryTimeUnitMs;
+    size_t n = 0;
+    out[n++] = ch;
+    n += historyPutVarint(out + n, units - st.timeUnits);
+    n += historyPutVarint(out + n, r.dwells);
+    n += historyPutVarint(out + n, historyZigzag(r.frames, p.frames));
+    n += historyPutVarint(out + n, historyZigzag(r.bytes, p.bytes));
+    n += historyPutVarint(out + n, historyZigzag(r.strong, p.strong));
+    n += historyPutVarint(out + n, historyZigzag(r.unique, p.unique));
+    n += historyPutVarint(out + n, historyZigzag(r.scoreQ8, p.score));
+    st.timeUnits = units;
+    p.frames = r.frames;
+    p.bytes = r.bytes;
+    p.strong = r.strong;
+    p.unique = r.unique;
+    p.score = r.scoreQ8;
+    return n;
+}
+
+// Decodes one record at p (advanced past it). False on truncated or corrupt input.
+inline bool historyDecode(HistoryCodecState& st, const uint8_t*& p, const uint8_t* end, HistoryRecord& r) {
+    if (p >= end || *p > kHistoryMaxChannel) return false;
+    const uint8_t ch = *p++;
+    HistoryCodecState::Prev& prev = st.prev[ch];
+    uint32_t dt, dwells, frames, bytes, strong, unique, score;
+    if (!historyGetVarint(p, end, dt) || !historyGetVarint(p, end, dwells) ||
+        !historyGetVarint(p, end, frames) || !historyGetVarint(p, end, bytes) ||
+        !historyGetVarint(p, end, strong) || !historyGetVarint(p, end, unique) ||
+        !historyGetVarint(p, end, score)) {
+        return false;
+    }
+    st.timeUnits += dt;
+    prev.frames = historyUnzigzag(frames, prev.frames);
+    prev.bytes = historyUnzigzag(bytes, prev.bytes);
+    prev.strong = historyUnzigzag(strong, prev.strong);
+    prev.unique = static_cast<uint16_t>(historyUnzigzag(unique, prev.unique));
+    prev.score = static_cast<uint16_t>(historyUnzigzag(score, prev.score));
+
+    r.timeMs = st.timeUnits * kHistoryTimeUnitMs;
+    r.channel = ch;
+    r.dwells = static_cast<uint16_t>(dwells);
+    r.frames = prev.frames;
+    r.bytes = prev.bytes;
+    r.strong = prev.strong;
+    r.unique = prev.unique;
+    r.scoreQ8 = prev.score;
+    return true;
+}
+
+// CRC-8 (poly 0x07) guarding each flash chunk against torn writes.
+inline uint8_t historyCrc8(const uint8_t* p, size_t len) {
+    uint8_t crc = 0;
+    while (len--) {
+        crc ^= *p++;
+        for (uint8_t i = 0; i < 8; i++) crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x07) : static_cast<uint8_t>(crc << 1);
+    }
+    return crc;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <stdint.h>
+
+enum class HopMode : uint8_t {
+    RoundRobin = 0,   // Strict 1..N sweep, equal dwell
+    Weighted = 1,     // Smooth weighted round-robin on per-channel activity weights
+    Focus = 2,        // Only the focus set (e.g. current top 3) carries weight
+};
+
+// Chooses the channel for each successive dwell.
+//
+// Weighted/Focus use smooth weighted round-robin: every hop each channel earns its
+// weight in credit, the richest channel is picked and pays back the total. Visits are
+// therefore proportional to weight and evenly interleaved. To keep a minimum revisit
+// rate for quiet channels, any channel unseen for longer than revisitMs is forced in,
+// at most once every forceSpacing hops so catch-up visits do not arrive as a burst.
+//
+// allowMask limits the picks to a channel subset (bit i = channel index i), e.g. the
+// share a node was given in a multi-node setup; a single bit pins the channel.
+//
+// Channel indices are 0-based. Not thread-safe; owned by the hop timer.
+template <int N>
+class HopScheduler {
+    static_assert(N > 0 && N <= 16, "focus mask is 16 bits");
+
+public:
+    void reset(uint32_t nowMs) {
+        for (int i = 0; i < N; i++) {
+            credit_[i] = 0;
+            lastVisitMs_[i] = nowMs;
+        }
+        hopsSinceForced_ = 0;
+    }
+
+    int next(HopMode mode, int current, uint32_t nowMs, const uint16_t weights[N], uint16_t focusMask,
+             uint32_t revisitMs, uint8_t forceSpacing, uint16_t allowMask = 0xFFFF) {
+        allowMask &= static_cast<uint16_t>((1u << N) - 1);
+        if (allowMask == 0) allowMask = static_cast<uint16_t>((1u << N) - 1);
+        int pick = -1;
+        if (mode == HopMode::RoundRobin) {
+            pick = nextAllowed(current, allowMask);
+        } else {
+            if (hopsSinceForced_ >= forceSpacing) pick = mostOverdue(nowMs, revisitMs, current, allowMask);
+            if (pick >= 0) {
+                hopsSinceForced_ = 0;
+            } else {
+                if (hopsSinceForced_ < 0xFF) hopsSinceForced_++;
+                pick = weightedPick(mode, weights, focusMask, allowMask);
+                if (pick < 0) pick = nextAllowed(current, allowMask);  // Nothing weighted yet
+            }
+        }
+        lastVisitMs_[pick] = nowMs;
+        return pick;
+    }
+
+private:
+    // First allowed channel after current, wrapping (current itself when it is the only one).
+    static int nextAllowed(int current, uint16_t allowMask) {
+        for (int step = 1; step <= N; step++) {
+            const int i = (current + step) % N;
+            if (allowMask & (1u << i)) return i;
+        }
+        return current;
+    }
+
+    int mostOverdue(uint32_t nowMs, uint32_t revisitMs, int current, uint16_t allowMask) const {
+        int best = -1;
+        uint32_t bestAge = revisitMs;
+        for (int i = 0; i < N; i++) {
+            if (i == current || !(allowMask & (1u << i))) continue;
+            const uint32_t age = nowMs - lastVisitMs_[i];
+            if (age > bestAge) {
+                bestAge = age;
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    int weightedPick(HopMode mode, const uint16_t weights[N], uint16_t focusMask, uint16_t allowMask) {
+        int32_t total = 0;
+        int best = -1;
+        for (int i = 0; i < N; i++) {
+            if (!(allowMask & (1u << i))) continue;
+            int32_t w = weights[i];
+            if (mode == HopMode::Focus) w = (focusMask & (1u << i)) ? 1 : 0;
+            if (w <= 0) continue;
+            credit_[i] += w;
+            total += w;
+            if (best < 0 || credit_[i] > credit_[best]) best = i;
+        }
+        if (best >= 0) credit_[best] -= total;
+        return best;
+    }
+
+    int32_t credit_[N] = {0};
+    uint32_t lastVisitMs_[N] = {0};
+    uint8_t hopsSinceForced_ = 0;
+};
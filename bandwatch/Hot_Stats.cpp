@@ -0,0 +1,159 @@
+#include "Hot_Stats.h"
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#define STATS_MAX_TIMERS 8
+#define STATS_MAX_COUNTERS 12
+#define STATS_MAX_TASKS 24
+
+struct StatsTimerEntry {
+  const char* name;
+  Stats_Timer* timer;
+  uint32_t lastCount;
+  uint32_t lastCycles;
+};
+
+struct StatsCounterEntry {
+  const char* name;
+  Stats_CounterFn read;
+  uint32_t last;
+};
+
+static const char* statsApp = "app";
+static StatsTimerEntry statsTimers[STATS_MAX_TIMERS];
+static uint8_t statsTimerCount = 0;
+static StatsCounterEntry statsCounters[STATS_MAX_COUNTERS];
+static uint8_t statsCounterCount = 0;
+static uint32_t statsLastDumpMs = 0;
+
+#if configUSE_TRACE_FACILITY
+struct StatsTaskPrev {
+  TaskHandle_t handle;
+  uint32_t runTime;
+};
+// Static: uxTaskGetSystemState needs ~36 B per task, too much for a caller's stack.
+static TaskStatus_t statsTaskStatus[STATS_MAX_TASKS];
+static StatsTaskPrev statsTaskPrev[STATS_MAX_TASKS];
+static uint8_t statsTaskPrevCount = 0;
+static uint32_t statsLastTotalRunTime = 0;
+#endif
+
+void Stats_Init(const char* app)
+{
+  statsApp = app;
+  statsLastDumpMs = millis();
+}
+
+void Stats_AddTimer(const char* name, Stats_Timer* t)
+{
+  if (statsTimerCount >= STATS_MAX_TIMERS) return;
+  StatsTimerEntry& e = statsTimers[statsTimerCount++];
+  e.name = name;
+  e.timer = t;
+  e.lastCount = t->count;
+  e.lastCycles = t->cycles;
+}
+
+void Stats_AddCounter(const char* name, Stats_CounterFn read)
+{
+  if (statsCounterCount >= STATS_MAX_COUNTERS) return;
+  StatsCounterEntry& e = statsCounters[statsCounterCount++];
+  e.name = name;
+  e.read = read;
+  e.last = read();
+}
+
+static void Stats_DumpTimers(uint32_t mhz)
+{
+  printf(",\"timers\":{");
+  for (uint8_t i = 0; i < statsTimerCount; i++) {
+    StatsTimerEntry& e = statsTimers[i];
+    // Plain reads: a sample landing mid-read shifts it into the next window.
+    const uint32_t count = e.timer->count;
+    const uint32_t cycles = e.timer->cycles;
+    const uint32_t maxCycles = e.timer->maxCycles;
+    e.timer->maxCycles = 0;
+    const uint32_t n = count - e.lastCount;
+    const uint32_t c = cycles - e.lastCycles;
+    e.lastCount = count;
+    e.lastCycles = cycles;
+    const uint32_t meanNs = n ? (uint32_t)((uint64_t)c * 1000 / mhz / n) : 0;
+    const uint32_t maxNs = (uint32_t)((uint64_t)maxCycles * 1000 / mhz);
+    printf("%s\"%s\":[%lu,%lu,%lu]", i ? "," : "", e.name,
+           (unsigned long)n, (unsigned long)meanNs, (unsigned long)maxNs);
+  }
+  printf("}");
+}
+
+static void Stats_DumpCounters(uint32_t windowMs)
+{
+  printf(",\"counters\":{");
+  for (uint8_t i = 0; i < statsCounterCount; i++) {
+    StatsCounterEntry& e = statsCounters[i];
+    const uint32_t v = e.read();
+    const uint32_t perS = windowMs ? (uint32_t)((uint64_t)(v - e.last) * 1000 / windowMs) : 0;
+    e.last = v;
+    printf("%s\"%s\":[%lu,%lu]", i ? "," : "", e.name, (unsigned long)v, (unsigned long)perS);
+  }
+  printf("}");
+}
+
+#if configUSE_TRACE_FACILITY
+static void Stats_DumpTasks(void)
+{
+  uint32_t totalRunTime = 0;
+  const UBaseType_t n = uxTaskGetSystemState(statsTaskStatus, STATS_MAX_TASKS, &totalRunTime);
+  const uint32_t totalDelta = totalRunTime - statsLastTotalRunTime;
+  statsLastTotalRunTime = totalRunTime;
+
+  printf(",\"tasks\":{");
+  StatsTaskPrev next[STATS_MAX_TASKS];
+  for (UBaseType_t i = 0; i < n; i++) {
+    const TaskStatus_t& t = statsTaskStatus[i];
+    uint32_t cpu = 0;
+#if configGENERATE_RUN_TIME_STATS
+    for (uint8_t j = 0; j < statsTaskPrevCount; j++) {
+      if (statsTaskPrev[j].handle != t.xHandle) continue;
+      if (totalDelta) cpu = (uint32_t)((uint64_t)(t.ulRunTimeCounter - statsTaskPrev[j].runTime) * 100 / totalDelta);
+      break;
+    }
+#endif
+    next[i].handle = t.xHandle;
+    next[i].runTime = t.ulRunTimeCounter;
+    // IDF counts stack in bytes.
+    printf("%s\"%s\":[%lu,%lu]", i ? "," : "", t.pcTaskName, (unsigned long)cpu,
+           (unsigned long)t.usStackHighWaterMark);
+  }
+  printf("}");
+  memcpy(statsTaskPrev, next, n * sizeof(StatsTaskPrev));
+  statsTaskPrevCount = (uint8_t)n;
+}
+#endif
+
+void Stats_Dump(void)
+{
+  const uint32_t nowMs = millis();
+  const uint32_t windowMs = nowMs - statsLastDumpMs;
+  statsLastDumpMs = nowMs;
+  uint32_t mhz = getCpuFrequencyMhz();
+  if (mhz == 0) mhz = 1;
+
+  printf("{\"stats\":\"%s\",\"t\":%lu,\"win\":%lu,\"mhz\":%lu,\"heap\":[%lu,%lu]", statsApp,
+         (unsigned long)nowMs, (unsigned long)windowMs, (unsigned long)mhz,
+         (unsigned long)heap_caps_get_free_size(MALLOC_CAP_8BIT),
+         (unsigned long)heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT));
+  Stats_DumpTimers(mhz);
+  Stats_DumpCounters(windowMs);
+#if configUSE_TRACE_FACILITY
+  Stats_DumpTasks();
+#endif
+  printf("}\r\n");
+}
+
+void Stats_Poll(void)
+{
+#if HOT_STATS_REPORT_MS > 0
+  if ((millis() - statsLastDumpMs) >= HOT_STATS_REPORT_MS) Stats_Dump();
+#endif
+}
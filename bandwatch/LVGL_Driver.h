@@ -11,9 +11,25 @@
 
 #define LVGL_WIDTH    (LCD_WIDTH )
 #define LVGL_HEIGHT   LCD_HEIGHT
+#ifndef LVGL_BUF_LEN
 #define LVGL_BUF_LEN  (LVGL_WIDTH * LVGL_HEIGHT / 20)
+#endif
+#ifndef LVGL_RENDER_MODE
+#define LVGL_RENDER_MODE  LV_DISPLAY_RENDER_MODE_PARTIAL
+#endif
 
-#define EXAMPLE_LVGL_TICK_PERIOD_MS  5
+// Render/flush performance HUD: a small overlay plus a serial line every second with
+// render time (includes any wait for the previous transfer), flush count and bytes,
+// SPI busy time, lv_timer_handler time and the idle slack left in Timer_Loop.
+// 0 compiles all of it out.
+#ifndef LVGL_PERF_HUD
+#define LVGL_PERF_HUD 0
+#endif
+
+// Longest the LVGL task sleeps when no LVGL timer is due sooner.
+#ifndef LVGL_MAX_SLEEP_MS
+#define LVGL_MAX_SLEEP_MS  500
+#endif
 
 
 void Lvgl_print(const char * buf);
@@ -22,7 +38,17 @@ void Lvgl_print(const char * buf);
 // compilation failures due to removed v8 types (lv_disp_drv_t, lv_indev_drv_t, etc.).
 void Lvgl_Display_LCD( lv_display_t *disp, const lv_area_t *area, uint8_t *px_map );          // Displays LVGL content on the LCD
 void Lvgl_Touchpad_Read( lv_indev_t * indev, lv_indev_data_t * data );                        // Read the touchpad
-void example_increase_lvgl_tick(void *arg);
 
 void Lvgl_Init(void);
-void Timer_Loop(void);
+// One lv_timer_handler pass; returns the ms until LVGL next needs service.
+uint32_t Timer_Loop(void);
+
+// LVGL runs in its own task once the panel is ready: it calls the service hook, then
+// lv_timer_handler, and sleeps for the shorter of the two intervals they return.
+// All LVGL calls after Lvgl_StartTask() must come from the hook or LVGL timers.
+// The hook returns LV_NO_TIMER_READY when it has nothing scheduled.
+typedef uint32_t (*Lvgl_ServiceFn)(void);
+void Lvgl_SetService(Lvgl_ServiceFn fn);
+void Lvgl_StartTask(void);
+// Wakes the LVGL task early (new data or input); callable from any task.
+void Lvgl_Wake(void);
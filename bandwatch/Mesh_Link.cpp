@@ -0,0 +1,346 @@
+#include "Mesh_Link.h"
+
+#if BANDWATCH_MESH
+
+#include "Capture_Ring.h"
+
+#include <Arduino.h>
+#include <esp_now.h>
+#include <esp_wifi.h>
+#include <esp_timer.h>
+#include <esp_random.h>
+
+namespace {
+
+constexpr uint32_t kJoinMinMs = 2500;          // Longer than one sync period (8 x 260 ms)
+constexpr uint32_t kJoinJitterMs = 2000;       // Spreads simultaneous power-ups apart
+constexpr uint8_t kLostSyncPeriods = 4;        // Silence before a node or the coordinator is given up
+constexpr uint32_t kBeaconDelayUs = 2000;      // Into the sync slot, once every node has retuned
+constexpr uint32_t kReportDelayUs = 20000;     // First report; later ranks follow kReportStepUs apart
+constexpr uint32_t kReportStepUs = 12000;
+constexpr uint32_t kAirtimeUs = 400;           // Beacon build-to-receive latency, taken off the offset
+constexpr TickType_t kIdleWaitTicks = pdMS_TO_TICKS(50);
+
+const uint8_t kBroadcast[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+// Received frame, copied out of the Wi-Fi task as-is.
+struct RxFrame {
+    uint8_t src[6];
+    uint8_t len;
+    uint8_t reserved;
+    int64_t rxUs;
+    uint8_t data[kMeshMaxPayload];
+};
+
+MeshLinkHooks g_hooks{};
+TaskHandle_t g_meshTask = nullptr;
+uint8_t g_selfMac[6];
+uint16_t g_syncMask = 0;
+int g_channelCount = 13;
+uint32_t g_lostAfterMs = 0;              // kLostSyncPeriods sync periods
+
+SpscRing<RxFrame, 8> g_rx;               // Wi-Fi task -> mesh task
+SpscRing<MeshDwell, 16> g_localDwells;   // Aggregator -> mesh task
+
+// Sync slot handed over by the hop timer.
+portMUX_TYPE g_slotMux = portMUX_INITIALIZER_UNLOCKED;
+bool g_slotPending = false;
+uint32_t g_pendingSlot = 0;
+int64_t g_pendingStartUs = 0;
+
+// Mesh task state.
+MeshRole g_role = MeshRole::Off;
+MeshNodeTable g_table;                   // Coordinator only
+uint8_t g_coordMac[6];                   // Worker: whose beacons we follow
+volatile uint16_t g_mask = 0;
+volatile bool g_owned = false;           // g_mask is an assignment, not just the sync channel
+uint8_t g_nodes = 0;
+uint8_t g_rank = 0;                      // Position in the beacon list: report order
+uint32_t g_slot = 0;                     // Latest sync slot
+int64_t g_slotStartUs = 0;
+uint32_t g_joinStartedMs = 0;
+uint32_t g_joinWindowMs = 0;
+uint32_t g_lastBeaconMs = 0;
+int64_t g_beaconDueUs = 0;               // 0 = nothing scheduled
+int64_t g_reportDueUs = 0;
+
+volatile uint32_t g_reports = 0;
+volatile uint32_t g_dwells = 0;
+volatile uint32_t g_sendErrors = 0;
+
+void onRecv(const esp_now_recv_info_t* info, const uint8_t* data, int len) {
+    if (!info || len <= 0 || len > static_cast<int>(kMeshMaxPayload)) return;
+    if (!meshCheck(data, static_cast<size_t>(len))) return;  // Other ESP-NOW users on the air
+    RxFrame f;
+    memcpy(f.src, info->src_addr, sizeof(f.src));
+    f.len = static_cast<uint8_t>(len);
+    f.reserved = 0;
+    f.rxUs = esp_timer_get_time();
+    memcpy(f.data, data, static_cast<size_t>(len));
+    if (g_rx.push(f)) xTaskNotifyGive(g_meshTask);
+}
+
+void setMask(uint16_t mask) {
+    if (mask == g_mask) return;
+    g_mask = mask;
+    g_hooks.setChannelMask(mask);
+}
+
+void send(const void* msg, size_t len) {
+    if (esp_now_send(kBroadcast, static_cast<const uint8_t*>(msg), len) != ESP_OK) g_sendErrors = g_sendErrors + 1;
+}
+
+void printMask(const char* what) {
+    char list[48];
+    size_t n = 0;
+    list[0] = '\0';
+    for (int ch = 0; ch < g_channelCount && n + 4 < sizeof(list); ch++) {
+        if (g_mask & (1u << ch)) n += snprintf(list + n, sizeof(list) - n, n ? ",%d" : "%d", ch + 1);
+    }
+    printf("mesh: %s, %u node(s), channels %s\r\n", what, g_nodes, list);
+}
+
+void startJoin() {
+    g_role = MeshRole::Joining;
+    g_joinStartedMs = millis();
+    g_joinWindowMs = kJoinMinMs + esp_random() % kJoinJitterMs;
+    g_nodes = 0;
+    g_beaconDueUs = 0;
+    g_reportDueUs = 0;
+    g_owned = false;
+    setMask(g_syncMask);  // Listen where beacons are sent
+}
+
+void becomeCoordinator() {
+    g_role = MeshRole::Coordinator;
+    g_table.reset(g_selfMac, g_slot, g_channelCount);
+    g_nodes = g_table.count();
+    g_owned = true;
+    setMask(g_table.maskFor(g_selfMac));
+    printMask("coordinating");
+}
+
+void handleBeacon(const RxFrame& f) {
+    MeshBeacon b{};
+    memcpy(&b, f.data, f.len < sizeof(b) ? f.len : sizeof(b));
+    if (g_role == MeshRole::Coordinator) {
+        // Two coordinators: the lower MAC keeps the role, the other joins it.
+        if (meshMacCompare(f.src, g_selfMac) > 0) return;
+        printf("mesh: %02x:%02x:%02x:%02x:%02x:%02x coordinates, stepping down\r\n",
+               f.src[0], f.src[1], f.src[2], f.src[3], f.src[4], f.src[5]);
+    } else if (g_role == MeshRole::Worker && meshMacCompare(f.src, g_coordMac) > 0) {
+        return;  // A second coordinator that will step down once it hears ours
+    }
+    const bool joined = (g_role != MeshRole::Worker);
+    g_role = MeshRole::Worker;
+    memcpy(g_coordMac, f.src, sizeof(g_coordMac));
+    g_lastBeaconMs = millis();
+
+    // Slot clock: the coordinator's slot began slotOffsetUs (plus the time on air) ago.
+    g_hooks.align(b.hdr.slot, f.rxUs - static_cast<int64_t>(b.slotOffsetUs) - kAirtimeUs);
+
+    uint16_t mask = g_syncMask;  // Not assigned yet: stay where the next beacon comes
+    g_rank = b.nodeCount;
+    for (uint8_t i = 0; i < b.nodeCount; i++) {
+        if (meshMacCompare(b.nodes[i].mac, g_selfMac) == 0) {
+            mask = b.nodes[i].channelMask;
+            g_rank = i;
+        }
+    }
+    const bool changed = joined || mask != g_mask || b.nodeCount != g_nodes;
+    g_nodes = b.nodeCount;
+    g_owned = g_rank < b.nodeCount;
+    setMask(mask);
+    if (changed) printMask(g_owned ? "worker" : "worker, awaiting channels");
+    // This beacon opened a sync slot here too: report in rank order after it.
+    g_reportDueUs = f.rxUs + kReportDelayUs + static_cast<int64_t>(g_rank) * kReportStepUs;
+}
+
+void handleReport(const RxFrame& f) {
+    MeshReport r{};
+    memcpy(&r, f.data, f.len < sizeof(r) ? f.len : sizeof(r));
+    g_reports = g_reports + 1;
+    for (uint8_t i = 0; i < r.count; i++) {
+        const MeshDwell& d = r.dwells[i];
+        if (d.channel < 1 || d.channel > g_channelCount) continue;
+        if (g_mask & (1u << (d.channel - 1))) continue;  // Ours: a stale assignment overlapped
+        g_hooks.remoteDwell(d);
+        g_dwells = g_dwells + 1;
+    }
+    if (g_role == MeshRole::Coordinator && g_table.heard(f.src, g_slot)) {
+        g_nodes = g_table.count();
+        setMask(g_table.maskFor(g_selfMac));
+        printMask("node joined");
+    }
+}
+
+void sendBeacon() {
+    MeshBeacon b{};
+    meshInitHeader(b.hdr, kMeshBeacon, g_slot);
+    b.nodeCount = g_table.fill(b.nodes);
+    b.slotOffsetUs = static_cast<uint32_t>(esp_timer_get_time() - g_slotStartUs);
+    send(&b, meshBeaconLen(b.nodeCount));
+}
+
+void sendReport() {
+    MeshReport r{};
+    meshInitHeader(r.hdr, kMeshReport, g_slot);
+    while (r.count < kMeshMaxDwells && g_localDwells.pop(r.dwells[r.count])) r.count++;
+    send(&r, meshReportLen(r.count));  // Sent even when empty: it is also the keep-alive
+}
+
+void onSyncSlot(uint32_t slot, int64_t startUs) {
+    g_slot = slot;
+    g_slotStartUs = startUs;
+    if (g_role == MeshRole::Coordinator) {
+        if (g_table.expire(slot, static_cast<uint32_t>(kLostSyncPeriods) * kMeshSyncEvery)) {
+            g_nodes = g_table.count();
+            setMask(g_table.maskFor(g_selfMac));
+            printMask("node lost");
+        }
+        g_beaconDueUs = startUs + kBeaconDelayUs;
+        g_reportDueUs = startUs + kReportDelayUs;  // Rank 0
+    }
+    // Workers time their report from the beacon; a worker that misses it stays quiet
+    // this period rather than guess.
+}
+
+void housekeeping() {
+    const uint32_t nowMs = millis();
+    if (g_role == MeshRole::Joining && (nowMs - g_joinStartedMs) >= g_joinWindowMs) {
+        becomeCoordinator();
+    } else if (g_role == MeshRole::Worker && (nowMs - g_lastBeaconMs) > g_lostAfterMs) {
+        printf("mesh: coordinator lost, rejoining\r\n");
+        startJoin();
+    }
+}
+
+void meshTask(void* param) {
+    (void)param;
+    startJoin();
+    while (true) {
+        // Sleep until the next scheduled send, or a frame or sync slot arrives.
+        TickType_t wait = kIdleWaitTicks;
+        const int64_t nowUs = esp_timer_get_time();
+        const int64_t dueUs = (g_beaconDueUs && (!g_reportDueUs || g_beaconDueUs < g_reportDueUs)) ? g_beaconDueUs
+                                                                                                  : g_reportDueUs;
+        if (dueUs) {
+            const int64_t ms = (dueUs > nowUs) ? (dueUs - nowUs + 999) / 1000 : 0;
+            wait = (ms < 50) ? pdMS_TO_TICKS(ms) : kIdleWaitTicks;
+        }
+        ulTaskNotifyTake(pdTRUE, wait);
+
+        bool slot = false;
+        uint32_t slotNo = 0;
+        int64_t slotStartUs = 0;
+        portENTER_CRITICAL(&g_slotMux);
+        if (g_slotPending) {
+            g_slotPending = false;
+            slot = true;
+            slotNo = g_pendingSlot;
+            slotStartUs = g_pendingStartUs;
+        }
+        portEXIT_CRITICAL(&g_slotMux);
+        if (slot) onSyncSlot(slotNo, slotStartUs);
+
+        RxFrame f;
+        while (g_rx.pop(f)) {
+            const uint8_t type = meshCheck(f.data, f.len);
+            if (type == kMeshBeacon) {
+                handleBeacon(f);
+            } else if (type == kMeshReport) {
+                handleReport(f);
+            }
+        }
+
+        const int64_t t = esp_timer_get_time();
+        if (g_beaconDueUs && t >= g_beaconDueUs) {
+            g_beaconDueUs = 0;
+            if (g_role == MeshRole::Coordinator) sendBeacon();
+        }
+        if (g_reportDueUs && t >= g_reportDueUs) {
+            g_reportDueUs = 0;
+            if (g_role == MeshRole::Coordinator || g_role == MeshRole::Worker) sendReport();
+        }
+        housekeeping();
+    }
+}
+
+} // namespace
+
+bool MeshLink_Init(const MeshLinkHooks& hooks, const MeshLinkConfig& cfg) {
+    if (g_meshTask) return true;
+    g_hooks = hooks;
+    g_channelCount = cfg.channelCount;
+    g_syncMask = static_cast<uint16_t>(1u << (cfg.syncChannel - 1));
+    g_lostAfterMs = static_cast<uint32_t>(kLostSyncPeriods) * kMeshSyncEvery * cfg.dwellMs;
+    esp_wifi_get_mac(WIFI_IF_STA, g_selfMac);
+
+    if (esp_now_init() != ESP_OK) {
+        printf("mesh: ESP-NOW init failed, running standalone\r\n");
+        return false;
+    }
+    esp_now_peer_info_t peer{};
+    memcpy(peer.peer_addr, kBroadcast, sizeof(peer.peer_addr));
+    peer.channel = 0;             // Whatever channel the radio is on
+    peer.ifidx = WIFI_IF_STA;
+    peer.encrypt = false;
+    esp_now_add_peer(&peer);
+    esp_now_register_recv_cb(onRecv);
+
+    return xTaskCreatePinnedToCore(
+        meshTask,
+        "bw_mesh",
+        3072,
+        nullptr,
+        4,
+        &g_meshTask,
+        0
+    ) == pdPASS;
+}
+
+void MeshLink_SyncSlot(uint32_t slot, int64_t startUs) {
+    if (!g_meshTask) return;
+    portENTER_CRITICAL(&g_slotMux);
+    g_slotPending = true;
+    g_pendingSlot = slot;
+    g_pendingStartUs = startUs;
+    portEXIT_CRITICAL(&g_slotMux);
+    xTaskNotifyGive(g_meshTask);
+}
+
+void MeshLink_PostDwell(const MeshDwell& dwell) {
+    // Only the owner reports a channel; the others were just passing (sync slots).
+    if (!g_owned || dwell.channel < 1 || !(g_mask & (1u << (dwell.channel - 1)))) return;
+    g_localDwells.push(dwell);  // Counted in dwellsDropped when reports fall behind
+}
+
+void MeshLink_GetStats(MeshLinkStats* out) {
+    out->role = g_role;
+    out->nodes = g_nodes;
+    out->channelMask = g_mask;
+    out->reports = g_reports;
+    out->dwells = g_dwells;
+    out->sendErrors = g_sendErrors;
+    out->dwellsDropped = g_localDwells.dropped();
+}
+
+#else
+
+bool MeshLink_Init(const MeshLinkHooks& hooks, const MeshLinkConfig& cfg) {
+    (void)hooks;
+    (void)cfg;
+    return false;
+}
+void MeshLink_SyncSlot(uint32_t slot, int64_t startUs) {
+    (void)slot;
+    (void)startUs;
+}
+void MeshLink_PostDwell(const MeshDwell& dwell) {
+    (void)dwell;
+}
+void MeshLink_GetStats(MeshLinkStats* out) {
+    *out = MeshLinkStats{};
+}
+
+#endif
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdint.h>
+#include "Mesh_Protocol.h"
+
+// Set to 1 to build Bandwatch for several boards sharing the band over ESP-NOW.
+#ifndef BANDWATCH_MESH
+#define BANDWATCH_MESH 0
+#endif
+
+// Multi-node channel partitioning. Boards running the same image find each other on
+// the sync channel, elect the one that was up first as coordinator, and split the 13
+// channels between them (with 13 boards each one sits on a single channel and never
+// hops). Each node measures its own channels and, in every sync slot, broadcasts
+// their finished dwells; every node folds the reports it hears into its own
+// per-channel state, so any display shows the full band.
+//
+//   - Joining: a new node stays on the sync channel for a random 2.5-4.5 s. Hearing a
+//     beacon makes it a worker, aligned to the coordinator's slot clock; hearing none
+//     makes it the coordinator (alone, it owns all channels, i.e. plain Bandwatch).
+//   - A node missing from reports for 4 sync periods is dropped and its channels are
+//     dealt out again; workers that lose the coordinator for as long rejoin.
+//   - Two coordinators resolve when one hears the other: the higher MAC steps down.
+//
+// The hop timer owns slot numbering and calls MeshLink_SyncSlot() when a sync slot
+// starts; everything else runs on the bw_mesh task, which calls back through the hooks.
+struct MeshLinkHooks {
+    void (*setChannelMask)(uint16_t mask);              // Channels to measure (bit i = channel i + 1)
+    void (*align)(uint32_t slot, int64_t slotStartUs);  // The coordinator's `slot` began at local time slotStartUs
+    void (*remoteDwell)(const MeshDwell& dwell);        // Dwell another node measured
+};
+
+struct MeshLinkConfig {
+    uint8_t syncChannel;    // Where beacons and reports are exchanged (1..13)
+    int channelCount;       // Channels shared out (1..channelCount)
+    uint32_t dwellMs;       // Slot length, for the loss timeouts
+};
+
+enum class MeshRole : uint8_t {
+    Off = 0,
+    Joining = 1,
+    Coordinator = 2,
+    Worker = 3,
+};
+
+struct MeshLinkStats {
+    MeshRole role;
+    uint8_t nodes;          // Nodes in the last assignment (coordinator: its table)
+    uint16_t channelMask;   // This node's share
+    uint32_t reports;       // Reports received
+    uint32_t dwells;        // Remote dwells handed to remoteDwell
+    uint32_t sendErrors;
+    uint32_t dwellsDropped; // Local dwells lost before a report went out
+};
+
+// Starts ESP-NOW and the mesh task; call once Wi-Fi is started. The hooks must stay valid.
+bool MeshLink_Init(const MeshLinkHooks& hooks, const MeshLinkConfig& cfg);
+
+// Hop timer: a sync slot has just started (the radio is on the sync channel).
+void MeshLink_SyncSlot(uint32_t slot, int64_t startUs);
+
+// Aggregator: a dwell finished (any channel); queued for the next report when this
+// node owns the channel.
+void MeshLink_PostDwell(const MeshDwell& dwell);
+
+void MeshLink_GetStats(MeshLinkStats* out);
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// Wire format and coordinator bookkeeping for multi-node Bandwatch (Mesh_Link.h).
+// Free of ESP-IDF so the host tests cover it. All nodes are ESP32s, so messages are
+// the little-endian structs below, guarded by magic and version.
+//
+// Time is divided into dwell slots numbered by the coordinator. Every
+// kMeshSyncEvery-th slot is a sync slot: all nodes tune to the sync channel, the
+// coordinator broadcasts a beacon (slot clock plus channel assignment) and every
+// node broadcasts a report of the dwells it measured since the previous sync slot.
+
+constexpr uint16_t kMeshMagic = 0x5742;     // "BW"
+constexpr uint8_t kMeshVersion = 2;
+constexpr uint8_t kMeshMaxNodes = 13;       // One per channel: beyond that nodes would only duplicate
+constexpr size_t kMeshMaxPayload = 250;     // ESP-NOW v1 frame limit
+constexpr uint8_t kMeshSyncEvery = 8;       // One sync slot per 8 dwells (~2 s at 260 ms)
+
+enum MeshMsgType : uint8_t {
+    kMeshBeacon = 1,   // Coordinator: slot clock and assignment
+    kMeshReport = 2,   // Any node: finished dwells on its channels (doubles as hello)
+};
+
+struct MeshHeader {
+    uint16_t magic;
+    uint8_t version;
+    uint8_t type;
+    uint32_t slot;          // Sender's current slot number
+};
+static_assert(sizeof(MeshHeader) == 8, "MeshHeader layout");
+
+struct MeshAssignment {
+    uint8_t mac[6];
+    uint16_t channelMask;   // Bit i = channel i + 1
+};
+static_assert(sizeof(MeshAssignment) == 8, "MeshAssignment layout");
+
+struct MeshBeacon {
+    MeshHeader hdr;
+    uint32_t slotOffsetUs;  // Time into hdr.slot when the beacon was built
+    uint8_t nodeCount;
+    uint8_t reserved[3];
+    MeshAssignment nodes[kMeshMaxNodes];
+};
+static_assert(sizeof(MeshBeacon) <= kMeshMaxPayload, "MeshBeacon too large");
+
+// One finished dwell: ChannelMetrics plus its channel, 24 bytes.
+struct MeshDwell {
+    uint32_t frames;
+    uint32_t bytes;
+    uint32_t dwellUs;
+    uint16_t strong;
+    uint16_t unique;
+    uint8_t channel;        // 1..13
+    uint8_t reserved;
+    uint16_t talkers;       // Owner's windowed transmitter estimate for the channel
+    uint32_t airtimeUs;
+};
+static_assert(sizeof(MeshDwell) == 24, "MeshDwell layout");
+
+constexpr uint8_t kMeshMaxDwells = 9;      // More than kMeshSyncEvery, so nothing waits two periods
+
+struct MeshReport {
+    MeshHeader hdr;
+    uint8_t count;
+    uint8_t reserved[3];
+    MeshDwell dwells[kMeshMaxDwells];
+};
+static_assert(sizeof(MeshReport) <= kMeshMaxPayload, "MeshReport too large");
+
+inline bool meshIsSyncSlot(uint32_t slot) {
+    return (slot % kMeshSyncEvery) == 0;
+}
+
+inline void meshInitHeader(MeshHeader& h, MeshMsgType type, uint32_t slot) {
+    h.magic = kMeshMagic;
+    h.version = kMeshVersion;
+    h.type = type;
+    h.slot = slot;
+}
+
+// Bytes actually sent: the used part of the variable-length arrays only.
+inline size_t meshBeaconLen(uint8_t nodeCount) {
+    return offsetof(MeshBeacon, nodes) + nodeCount * sizeof(MeshAssignment);
+}
+
+inline size_t meshReportLen(uint8_t count) {
+    return offsetof(MeshReport, dwells) + count * sizeof(MeshDwell);
+}
+
+// Message type of a received frame, or 0 when it is not a well-formed Bandwatch message.
+// The length must match the counts exactly, so a message always fits its struct.
+inline uint8_t meshCheck(const uint8_t* p, size_t len) {
+    if (len < sizeof(MeshHeader) || len > kMeshMaxPayload) return 0;
+    MeshHeader h;
+    memcpy(&h, p, sizeof(h));
+    if (h.magic != kMeshMagic || h.version != kMeshVersion) return 0;
+    if (h.type == kMeshBeacon) {
+        if (len < offsetof(MeshBeacon, nodes)) return 0;
+        const uint8_t n = p[offsetof(MeshBeacon, nodeCount)];
+        return (n <= kMeshMaxNodes && len == meshBeaconLen(n)) ? kMeshBeacon : 0;
+    }
+    if (h.type == kMeshReport) {
+        if (len < offsetof(MeshReport, dwells)) return 0;
+        const uint8_t n = p[offsetof(MeshReport, count)];
+        return (n <= kMeshMaxDwells && len == meshReportLen(n)) ? kMeshReport : 0;
+    }
+    return 0;
+}
+
+inline int meshMacCompare(const uint8_t a[6], const uint8_t b[6]) {
+    return memcmp(a, b, 6);
+}
+
+// Coordinator's view of the nodes: itself plus every node heard in the last few sync
+// periods. Channels are dealt round-robin in MAC order (1, 1+n, 1+2n, ... to the first
+// node), so every channel has exactly one owner and shares differ by at most one.
+class MeshNodeTable {
+public:
+    struct Node {
+        uint8_t mac[6];
+        uint16_t channelMask;
+        uint32_t lastHeardSlot;
+    };
+
+    void reset(const uint8_t selfMac[6], uint32_t slot, int channelCount) {
+        channelCount_ = channelCount;
+        count_ = 1;
+        memcpy(nodes_[0].mac, selfMac, 6);
+        nodes_[0].lastHeardSlot = slot;
+        assign();
+    }
+
+    // A report from mac; true when it is new and the assignment changed. Nodes beyond
+    // kMeshMaxNodes are ignored (they keep listening and stay unassigned).
+    bool heard(const uint8_t mac[6], uint32_t slot) {
+        for (uint8_t i = 0; i < count_; i++) {
+            if (meshMacCompare(nodes_[i].mac, mac) == 0) {
+                nodes_[i].lastHeardSlot = slot;
+                return false;
+            }
+        }
+        if (count_ >= kMeshMaxNodes) return false;
+        memcpy(nodes_[count_].mac, mac, 6);
+        nodes_[count_].lastHeardSlot = slot;
+        count_++;
+        assign();
+        return true;
+    }
+
+    // Drops nodes (never index 0, the coordinator) silent for more than timeoutSlots;
+    // true when any went and their channels were handed out again.
+    bool expire(uint32_t slot, uint32_t timeoutSlots) {
+        bool changed = false;
+        for (uint8_t i = 1; i < count_;) {
+            if ((slot - nodes_[i].lastHeardSlot) > timeoutSlots) {
+                nodes_[i] = nodes_[--count_];
+                changed = true;
+            } else {
+                i++;
+            }
+        }
+        if (changed) assign();
+        return changed;
+    }
+
+    uint16_t maskFor(const uint8_t mac[6]) const {
+        for (uint8_t i = 0; i < count_; i++) {
+            if (meshMacCompare(nodes_[i].mac, mac) == 0) return nodes_[i].channelMask;
+        }
+        return 0;
+    }
+
+    uint8_t count() const { return count_; }
+    const Node& node(uint8_t i) const { return nodes_[i]; }
+
+    // Fills a beacon's assignment list; returns the node count.
+    uint8_t fill(MeshAssignment* out) const {
+        for (uint8_t i = 0; i < count_; i++) {
+            memcpy(out[i].mac, nodes_[i].mac, 6);
+            out[i].channelMask = nodes_[i].channelMask;
+        }
+        return count_;
+    }
+
+private:
+    void assign() {
+        // Rank by MAC so every coordinator would deal the same way.
+        uint8_t order[kMeshMaxNodes];
+        for (uint8_t i = 0; i < count_; i++) {
+            uint8_t pos = i;
+            while (pos > 0 && meshMacCompare(nodes_[order[pos - 1]].mac, nodes_[i].mac) > 0) {
+                order[pos] = order[pos - 1];
+                pos--;
+            }
+            order[pos] = i;
+        }
+        for (uint8_t i = 0; i < count_; i++) nodes_[i].channelMask = 0;
+        for (int ch = 0; ch < channelCount_; ch++) {
+            nodes_[order[ch % count_]].channelMask |= static_cast<uint16_t>(1u << ch);
+        }
+    }
+
+    Node nodes_[kMeshMaxNodes];
+    uint8_t count_ = 0;
+    int channelCount_ = 13;
+};
@@ -0,0 +1,280 @@
+#include "Metric_History.h"
+#include "Capture_Ring.h"
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <esp_partition.h>
+#include <freertos/semphr.h>
+
+namespace {
+
+constexpr const char* kPartitionLabel = "history";
+constexpr uint8_t kPartitionSubtype = 0x40;     // Custom data subtype (partitions.csv)
+constexpr uint32_t kSectorBytes = 4096;         // Flash erase unit
+constexpr uint32_t kSectorMagic = 0x31485742;   // "BWH1"
+constexpr uint16_t kChunkUnwritten = 0xFFFF;    // Erased flash
+constexpr size_t kChunkHeaderBytes = 3;         // u16 length + u8 CRC-8
+constexpr size_t kHistoryBatchRecords = 48;     // ~500 bytes per chunk write
+constexpr uint32_t kMaxBatchAgeMs = 5 * 60 * 1000;  // Also write a part batch this often
+constexpr size_t kPendingMax = 64;
+constexpr uint32_t kPollMs = 1000;
+constexpr size_t kQueueSize = 32;
+
+struct SectorHeader {
+    uint32_t magic;
+    uint32_t seq;        // Increments by one per sector opened; the highest is the head
+    uint32_t bootId;
+    uint32_t baseUnits;  // Codec time base (kHistoryTimeUnitMs since boot)
+};
+static_assert(sizeof(SectorHeader) == 16, "SectorHeader layout");
+
+const esp_partition_t* g_part = nullptr;
+const uint8_t* g_map = nullptr;   // Whole partition, memory-mapped for reads
+esp_partition_mmap_handle_t g_mapHandle;
+uint16_t g_sectorCount = 0;
+SemaphoreHandle_t g_lock = nullptr;   // Guards flash, sector state and the pending batch
+TaskHandle_t g_task = nullptr;
+SpscRing<HistoryRecord, kQueueSize> g_queue;
+
+// Writer state (under g_lock).
+uint32_t g_bootId = 1;
+uint32_t g_seq = 0;
+uint16_t g_sector = 0;           // Sector currently appended to
+bool g_sectorOpen = false;       // A new boot always starts a fresh sector
+uint32_t g_writeOff = 0;
+HistoryCodecState g_codec;
+HistoryRecord g_pending[kPendingMax];
+size_t g_pendingCount = 0;
+uint32_t g_batchStartedMs = 0;
+uint8_t g_chunk[kHistoryBatchRecords * 12];
+
+HistoryStats g_stats{};
+
+const SectorHeader* sectorHeader(uint16_t idx) {
+    return reinterpret_cast<const SectorHeader*>(g_map + static_cast<uint32_t>(idx) * kSectorBytes);
+}
+
+bool sectorValid(uint16_t idx) {
+    return sectorHeader(idx)->magic == kSectorMagic;
+}
+
+bool flashWrite(uint32_t offset, const void* src, size_t len) {
+    if (esp_partition_write(g_part, offset, src, len) != ESP_OK) {
+        g_stats.writeErrors++;
+        return false;
+    }
+    g_stats.bytesWritten += len;
+    return true;
+}
+
+bool openSector(uint32_t baseUnits) {
+    const uint16_t next = static_cast<uint16_t>((g_sector + 1) % g_sectorCount);
+    const uint32_t offset = static_cast<uint32_t>(next) * kSectorBytes;
+    if (esp_partition_erase_range(g_part, offset, kSectorBytes) != ESP_OK) {
+        g_stats.writeErrors++;
+        return false;
+    }
+    g_stats.erases++;
+    g_sector = next;
+    SectorHeader hdr;
+    hdr.magic = kSectorMagic;
+    hdr.seq = ++g_seq;
+    hdr.bootId = g_bootId;
+    hdr.baseUnits = baseUnits;
+    if (!flashWrite(offset, &hdr, sizeof(hdr))) return false;
+    g_codec.reset(baseUnits);
+    g_writeOff = sizeof(hdr);
+    g_sectorOpen = true;
+    return true;
+}
+
+bool writeChunk(const uint8_t* payload, size_t len) {
+    if (len == 0) return true;
+    uint8_t hdr[kChunkHeaderBytes];
+    hdr[0] = static_cast<uint8_t>(len);
+    hdr[1] = static_cast<uint8_t>(len >> 8);
+    hdr[2] = historyCrc8(payload, len);
+    const uint32_t offset = static_cast<uint32_t>(g_sector) * kSectorBytes + g_writeOff;
+    // Payload first: a chunk only becomes visible once its length is written.
+    const bool ok = flashWrite(offset + kChunkHeaderBytes, payload, len) && flashWrite(offset, hdr, sizeof(hdr));
+    g_writeOff += kChunkHeaderBytes + len;   // Skip a failed chunk rather than rewrite it
+    return ok;
+}
+
+// Encodes the pending batch into as few chunks as the sector space allows.
+void flushPending() {
+    uint8_t* chunk = g_chunk;
+    size_t fill = 0;
+    for (size_t i = 0; i < g_pendingCount; i++) {
+        const HistoryRecord& r = g_pending[i];
+        if (fill + kHistoryMaxRecordBytes > sizeof(g_chunk)) {
+            writeChunk(chunk, fill);
+            fill = 0;
+        }
+        if (!g_sectorOpen ||
+            g_writeOff + kChunkHeaderBytes + fill + kHistoryMaxRecordBytes > kSectorBytes) {
+            writeChunk(chunk, fill);  // Encoded against the current sector's delta state
+            fill = 0;
+            if (!openSector(r.timeMs / kHistoryTimeUnitMs)) {
+                g_sectorOpen = false;
+                break;                // Batch lost; counted in writeErrors
+            }
+        }
+        fill += historyEncode(g_codec, r, chunk + fill);
+        g_stats.recordsWritten++;
+    }
+    writeChunk(chunk, fill);
+    g_pendingCount = 0;
+}
+
+// Decodes one sector; returns false if the visitor asked to stop.
+bool readSector(uint16_t idx, History_Visitor visit, void* ctx, uint32_t& count) {
+    const SectorHeader* hdr = sectorHeader(idx);
+    const uint8_t* base = reinterpret_cast<const uint8_t*>(hdr);
+    HistoryCodecState st;
+    st.reset(hdr->baseUnits);
+    uint32_t off = sizeof(SectorHeader);
+    while (off + kChunkHeaderBytes <= kSectorBytes) {
+        const uint16_t len = static_cast<uint16_t>(base[off] | (base[off + 1] << 8));
+        if (len == kChunkUnwritten || len == 0 || off + kChunkHeaderBytes + len > kSectorBytes) break;
+        const uint8_t crc = base[off + 2];
+        const uint8_t* p = base + off + kChunkHeaderBytes;
+        const uint8_t* end = p + len;
+        off += kChunkHeaderBytes + len;
+        if (historyCrc8(p, len) != crc) break;  // Delta chain is broken past here
+        HistoryRecord r;
+        r.bootId = hdr->bootId;
+        while (p < end && historyDecode(st, p, end, r)) {
+            count++;
+            if (!visit(r, ctx)) return false;
+        }
+    }
+    return true;
+}
+
+void historyTask(void* param) {
+    (void)param;
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS(kPollMs));
+        xSemaphoreTake(g_lock, portMAX_DELAY);
+        HistoryRecord r;
+        while (g_pendingCount < kPendingMax && g_queue.pop(r)) {
+            if (g_pendingCount == 0) g_batchStartedMs = millis();
+            g_pending[g_pendingCount++] = r;
+        }
+        if (g_pendingCount >= kHistoryBatchRecords ||
+            (g_pendingCount > 0 && (millis() - g_batchStartedMs) >= kMaxBatchAgeMs)) {
+            flushPending();
+        }
+        xSemaphoreGive(g_lock);
+    }
+}
+
+bool printCsvRow(const HistoryRecord& r, void* ctx) {
+    (void)ctx;
+    printf("%lu,%lu,%u,%u,%lu,%lu,%lu,%u,%u.%02u\r\n",
+           static_cast<unsigned long>(r.bootId), static_cast<unsigned long>(r.timeMs),
+           r.channel, r.dwells, static_cast<unsigned long>(r.frames),
+           static_cast<unsigned long>(r.bytes), static_cast<unsigned long>(r.strong), r.unique,
+           r.scoreQ8 >> 8, ((r.scoreQ8 & 0xFF) * 100) >> 8);
+    return true;
+}
+
+} // namespace
+
+bool History_Start() {
+    if (g_task) return true;
+    g_part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                      static_cast<esp_partition_subtype_t>(kPartitionSubtype), kPartitionLabel);
+    if (!g_part) {
+        printf("history: no '%s' partition, history disabled\r\n", kPartitionLabel);
+        return false;
+    }
+    const void* map = nullptr;
+    if (esp_partition_mmap(g_part, 0, g_part->size, ESP_PARTITION_MMAP_DATA, &map, &g_mapHandle) != ESP_OK) {
+        printf("history: mmap failed, history disabled\r\n");
+        return false;
+    }
+    g_map = static_cast<const uint8_t*>(map);
+    g_sectorCount = static_cast<uint16_t>(g_part->size / kSectorBytes);
+
+    // The head is the valid sector with the highest sequence number.
+    bool found = false;
+    uint16_t used = 0;
+    for (uint16_t i = 0; i < g_sectorCount; i++) {
+        if (!sectorValid(i)) continue;
+        used++;
+        const SectorHeader* h = sectorHeader(i);
+        if (!found || static_cast<int32_t>(h->seq - g_seq) > 0) {
+            found = true;
+            g_seq = h->seq;
+            g_sector = i;
+            g_bootId = h->bootId + 1;
+        }
+    }
+    if (!found) g_sector = static_cast<uint16_t>(g_sectorCount - 1);  // First sector opened is 0
+    g_stats.bootId = g_bootId;
+    g_stats.sectors = g_sectorCount;
+    g_stats.sectorsUsed = used;
+
+    g_lock = xSemaphoreCreateMutex();
+    printf("history: boot %lu, %u/%u sectors in use\r\n",
+           static_cast<unsigned long>(g_bootId), used, g_sectorCount);
+    return xTaskCreatePinnedToCore(
+        historyTask,
+        "bw_history",
+        3072,
+        nullptr,
+        1,
+        &g_task,
+        0
+    ) == pdPASS;
+}
+
+void History_Append(const HistoryRecord& r) {
+    if (!g_task) return;
+    HistoryRecord rec = r;
+    rec.bootId = g_bootId;
+    g_queue.push(rec);
+}
+
+uint32_t History_Read(uint16_t maxSectors, History_Visitor visit, void* ctx) {
+    if (!g_task) return 0;
+    uint32_t count = 0;
+    xSemaphoreTake(g_lock, portMAX_DELAY);
+    uint16_t span = g_sectorCount;
+    if (maxSectors > 0 && maxSectors < span) span = maxSectors;
+    // Ring order ends at the head; when this boot has not written yet the head is
+    // still the previous boot's last sector.
+    bool more = true;
+    for (uint16_t k = span; k > 0 && more; k--) {
+        const uint16_t idx = static_cast<uint16_t>((g_sector + g_sectorCount + 1 - k) % g_sectorCount);
+        if (sectorValid(idx)) more = readSector(idx, visit, ctx, count);
+    }
+    for (size_t i = 0; i < g_pendingCount && more; i++) {
+        count++;
+        more = visit(g_pending[i], ctx);
+    }
+    xSemaphoreGive(g_lock);
+    return count;
+}
+
+void History_ExportCsv() {
+    printf("history: boot,uptime_ms,channel,dwells,frames,bytes,strong,unique,score\r\n");
+    const uint32_t n = History_Read(0, printCsvRow, nullptr);
+    printf("history: %lu records\r\n", static_cast<unsigned long>(n));
+}
+
+void History_GetStats(HistoryStats* out) {
+    if (!g_task) {
+        *out = g_stats;
+        return;
+    }
+    xSemaphoreTake(g_lock, portMAX_DELAY);
+    *out = g_stats;
+    out->dropped = g_queue.dropped();
+    uint16_t used = 0;
+    for (uint16_t i = 0; i < g_sectorCount; i++) used += sectorValid(i) ? 1 : 0;
+    out->sectorsUsed = used;
+    xSemaphoreGive(g_lock);
+}
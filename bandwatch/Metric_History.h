@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+#include "History_Codec.h"
+
+// Persistent per-channel history in the "history" flash partition (see partitions.csv).
+//
+// The partition is a ring of 4 KB sectors. Each sector starts with a small header
+// (sequence number, boot id, time base) followed by CRC-guarded chunks of
+// delta/varint-encoded HistoryRecords (History_Codec.h, ~8-12 bytes per record).
+// History_Append() only queues the record; a low-priority task batches records in
+// RAM and writes a chunk every kHistoryBatchRecords or few minutes, so flash is
+// never written or erased from the capture path. A sector is erased only when the
+// ring reaches it, so wear is spread evenly over the partition.
+
+// Returns false when the partition is missing (history is then silently disabled).
+bool History_Start();
+
+// Aggregator side: queue one record (bootId is filled in). Never blocks.
+void History_Append(const HistoryRecord& r);
+
+// Visits records oldest to newest, including ones not yet written to flash. Only the
+// newest maxSectors sectors are decoded (0 = whole log), which gives charts a cheap
+// recent window. The visitor returns false to stop early.
+typedef bool (*History_Visitor)(const HistoryRecord& r, void* ctx);
+uint32_t History_Read(uint16_t maxSectors, History_Visitor visit, void* ctx);
+
+// Prints the whole log as CSV on serial.
+void History_ExportCsv();
+
+struct HistoryStats {
+    uint32_t bootId;
+    uint16_t sectors;          // Sectors in the partition
+    uint16_t sectorsUsed;      // Sectors holding a valid header
+    uint32_t recordsWritten;   // This boot
+    uint32_t bytesWritten;     // This boot, including chunk/sector headers
+    uint32_t erases;           // This boot
+    uint32_t writeErrors;
+    uint32_t dropped;          // Queue overflows
+};
+void History_GetStats(HistoryStats* out);
@@ -0,0 +1,336 @@
+#include "Pcap_Logger.h"
+#include "Capture_Ring.h"
+#include "SD_Card.h"
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <esp_timer.h>
+
+namespace {
+
+constexpr size_t kRingBytes = 32 * 1024;      // Frames buffered between RX callback and writer
+constexpr size_t kBlockBytes = 16 * 1024;     // Write unit: 32 sectors, one FAT cluster
+constexpr uint32_t kSyncMs = 10000;           // fsync cadence so the FAT entry tracks the file size
+constexpr uint32_t kIdlePollMs = 20;          // Writer sleep when the ring is empty
+constexpr uint32_t kDropReportMs = 5000;      // Min spacing of drop reports on serial
+constexpr uint8_t kMaxWriteErrors = 3;        // Consecutive failures before the logger stops
+constexpr uint32_t kLinkTypeRadiotap = 127;
+constexpr uint16_t kMaxSnapLen = 4095;        // sig_len is 12 bits
+constexpr uint8_t kFrameHasFcs = 0x01;
+
+// Ring record header; the captured bytes follow it.
+struct RingFrameHdr {
+    uint64_t tsUs;        // esp_timer time (64-bit math is left to the writer)
+    uint16_t capLen;
+    uint16_t origLen;
+    int8_t rssi;
+    uint8_t channel;
+    uint8_t flags;
+    uint8_t reserved;
+};
+static_assert(sizeof(RingFrameHdr) == 16, "RingFrameHdr layout");
+
+struct PcapGlobalHdr {
+    uint32_t magic;
+    uint16_t versionMajor;
+    uint16_t versionMinor;
+    int32_t thisZone;
+    uint32_t sigFigs;
+    uint32_t snapLen;
+    uint32_t linkType;
+};
+
+struct PcapRecordHdr {
+    uint32_t tsSec;
+    uint32_t tsUsec;
+    uint32_t inclLen;
+    uint32_t origLen;
+};
+
+// Radiotap: Flags, Channel, dBm antenna signal (fields naturally aligned).
+struct __attribute__((packed)) RadiotapHdr {
+    uint8_t version;
+    uint8_t pad;
+    uint16_t len;
+    uint32_t present;
+    uint8_t flags;
+    uint8_t pad1;         // Channel is 2-byte aligned
+    uint16_t chanFreq;
+    uint16_t chanFlags;
+    int8_t antSignal;
+};
+static_assert(sizeof(RadiotapHdr) == 15, "RadiotapHdr layout");
+
+constexpr uint32_t kRadiotapPresent = (1u << 1) | (1u << 3) | (1u << 5);
+constexpr uint8_t kRadiotapFlagFcs = 0x10;
+constexpr uint16_t kRadiotapChan2Ghz = 0x0080;
+
+SpscByteRing<kRingBytes> g_ring;
+PcapLoggerConfig g_cfg{};
+uint16_t g_snapLen = kMaxSnapLen;
+volatile bool g_active = false;   // Set by the writer once a file is open
+TaskHandle_t g_writerTask = nullptr;
+
+// Writer-task state.
+alignas(4) uint8_t g_block[kBlockBytes];
+size_t g_blockFill = 0;
+FILE* g_file = nullptr;
+uint32_t g_fileBytes = 0;         // Including the staged, not yet written part
+uint16_t g_fileIndex = 0;
+uint8_t g_writeFailures = 0;
+
+// Published counters (single writer each; read without a lock).
+volatile uint32_t g_framesWritten = 0;
+volatile uint32_t g_bytesWritten = 0;
+volatile uint32_t g_writeErrors = 0;
+
+// 802.11 MAC header length from the frame control field, clamped to len.
+IRAM_ATTR uint16_t macHeaderLen(const uint8_t* p, uint16_t len) {
+    if (len < 2) return len;
+    const uint8_t ftype = (p[0] >> 2) & 0x3;
+    if (ftype == 1) return len;                 // Control frames are all header
+    uint16_t h = 24;
+    if ((p[1] & 0x03) == 0x03) h += 6;          // ToDS + FromDS: fourth address
+    if (ftype == 2 && (p[0] & 0x80)) h += 2;    // QoS data
+    return (h < len) ? h : len;
+}
+
+bool flushBlock(size_t len) {
+    if (len == 0) return true;
+    if (fwrite(g_block, 1, len, g_file) != len) {
+        g_writeErrors = g_writeErrors + 1;
+        g_writeFailures++;
+        return false;
+    }
+    g_bytesWritten = g_bytesWritten + len;
+    g_writeFailures = 0;
+    g_blockFill = 0;
+    return true;
+}
+
+void emit(const void* src, size_t len) {
+    const uint8_t* p = static_cast<const uint8_t*>(src);
+    while (len > 0) {
+        const size_t n = (len < kBlockBytes - g_blockFill) ? len : kBlockBytes - g_blockFill;
+        memcpy(g_block + g_blockFill, p, n);
+        g_blockFill += n;
+        g_fileBytes += n;
+        p += n;
+        len -= n;
+        if (g_blockFill == kBlockBytes && !flushBlock(kBlockBytes)) g_blockFill = 0;  // Block lost
+    }
+}
+
+// Same as emit(), straight from the ring into the staging block.
+void emitFromRing(size_t len) {
+    while (len > 0) {
+        const size_t n = (len < kBlockBytes - g_blockFill) ? len : kBlockBytes - g_blockFill;
+        g_ring.read(g_block + g_blockFill, n);
+        g_blockFill += n;
+        g_fileBytes += n;
+        len -= n;
+        if (g_blockFill == kBlockBytes && !flushBlock(kBlockBytes)) g_blockFill = 0;
+    }
+}
+
+void filePath(uint16_t index, char* out, size_t outLen) {
+    snprintf(out, outLen, "%s/bw%04u.pcap", SD_MOUNT_POINT, static_cast<unsigned>(index));
+}
+
+// Continue numbering after the highest bwNNNN.pcap already on the card.
+uint16_t nextFreeIndex() {
+    DIR* dir = opendir(SD_MOUNT_POINT);
+    if (!dir) return 0;
+    int highest = -1;
+    struct dirent* e;
+    while ((e = readdir(dir)) != nullptr) {
+        unsigned idx = 0;
+        if (sscanf(e->d_name, "bw%4u.pcap", &idx) == 1 || sscanf(e->d_name, "BW%4u.PCA", &idx) == 1) {
+            if (static_cast<int>(idx) > highest) highest = static_cast<int>(idx);
+        }
+    }
+    closedir(dir);
+    return static_cast<uint16_t>(highest + 1);
+}
+
+bool openFile() {
+    char path[32];
+    filePath(g_fileIndex, path, sizeof(path));
+    g_file = fopen(path, "wb");
+    if (!g_file) {
+        printf("pcap: cannot create %s\r\n", path);
+        return false;
+    }
+    setvbuf(g_file, nullptr, _IONBF, 0);  // Whole blocks go straight to FATFS, no extra copy
+    g_fileBytes = 0;
+    g_blockFill = 0;
+
+    PcapGlobalHdr gh;
+    gh.magic = 0xA1B2C3D4;
+    gh.versionMajor = 2;
+    gh.versionMinor = 4;
+    gh.thisZone = 0;
+    gh.sigFigs = 0;
+    gh.snapLen = g_snapLen;
+    gh.linkType = kLinkTypeRadiotap;
+    emit(&gh, sizeof(gh));
+
+    if (g_cfg.maxFiles > 0 && g_fileIndex >= g_cfg.maxFiles) {
+        char old[32];
+        filePath(static_cast<uint16_t>(g_fileIndex - g_cfg.maxFiles), old, sizeof(old));
+        unlink(old);  // Fine if it is already gone
+    }
+    printf("pcap: writing %s\r\n", path);
+    return true;
+}
+
+void closeFile() {
+    if (!g_file) return;
+    flushBlock(g_blockFill);  // Only the tail of a file is ever written unaligned
+    fclose(g_file);
+    g_file = nullptr;
+}
+
+bool rotate() {
+    closeFile();
+    g_fileIndex++;
+    return openFile();
+}
+
+void writeFrame(const RingFrameHdr& h) {
+    const uint32_t recBytes = sizeof(PcapRecordHdr) + sizeof(RadiotapHdr) + h.capLen;
+    if (g_fileBytes + recBytes > g_cfg.fileCapBytes && g_fileBytes > sizeof(PcapGlobalHdr)) {
+        if (!rotate()) g_writeFailures++;
+    }
+    if (!g_file) {
+        uint8_t sink[64];  // No file: consume the frame so the ring keeps moving
+        for (size_t left = h.capLen; left > 0;) {
+            const size_t n = left < sizeof(sink) ? left : sizeof(sink);
+            g_ring.read(sink, n);
+            left -= n;
+        }
+        return;
+    }
+
+    PcapRecordHdr rec;
+    rec.tsSec = static_cast<uint32_t>(h.tsUs / 1000000);
+    rec.tsUsec = static_cast<uint32_t>(h.tsUs % 1000000);
+    rec.inclLen = sizeof(RadiotapHdr) + h.capLen;
+    rec.origLen = sizeof(RadiotapHdr) + h.origLen;
+    emit(&rec, sizeof(rec));
+
+    RadiotapHdr rt;
+    rt.version = 0;
+    rt.pad = 0;
+    rt.len = sizeof(RadiotapHdr);
+    rt.present = kRadiotapPresent;
+    rt.flags = (h.flags & kFrameHasFcs) ? kRadiotapFlagFcs : 0;
+    rt.pad1 = 0;
+    rt.chanFreq = static_cast<uint16_t>(2407 + 5 * h.channel);
+    rt.chanFlags = kRadiotapChan2Ghz;
+    rt.antSignal = h.rssi;
+    emit(&rt, sizeof(rt));
+
+    emitFromRing(h.capLen);
+    g_framesWritten = g_framesWritten + 1;
+}
+
+void writerTask(void* param) {
+    (void)param;
+    if (!SD_Init()) {
+        printf("pcap: no SD card, logging disabled\r\n");
+        g_writerTask = nullptr;
+        vTaskDelete(nullptr);
+        return;
+    }
+    g_fileIndex = nextFreeIndex();
+    if (!openFile()) {
+        g_writerTask = nullptr;
+        vTaskDelete(nullptr);
+        return;
+    }
+    g_active = true;
+
+    uint32_t lastSyncMs = millis();
+    uint32_t lastDropReportMs = 0;
+    uint32_t reportedDrops = 0;
+    for (;;) {
+        RingFrameHdr h;
+        bool wrote = false;
+        while (g_ring.read(&h, sizeof(h))) {
+            writeFrame(h);
+            wrote = true;
+        }
+        if (g_writeFailures >= kMaxWriteErrors) {
+            g_active = false;
+            closeFile();
+            printf("pcap: SD writes failing, logging stopped after %lu frames\r\n",
+                   static_cast<unsigned long>(g_framesWritten));
+            g_writerTask = nullptr;
+            vTaskDelete(nullptr);
+            return;
+        }
+
+        const uint32_t nowMs = millis();
+        if (g_file && (nowMs - lastSyncMs) >= kSyncMs) {
+            fsync(fileno(g_file));   // Completed blocks only; the staged block stays in RAM
+            lastSyncMs = nowMs;
+        }
+        const uint32_t drops = g_ring.dropped();
+        if (drops != reportedDrops && (nowMs - lastDropReportMs) >= kDropReportMs) {
+            printf("pcap: ring full, %lu frames (%lu KB) dropped so far\r\n",
+                   static_cast<unsigned long>(drops), static_cast<unsigned long>(g_ring.droppedBytes() / 1024));
+            reportedDrops = drops;
+            lastDropReportMs = nowMs;
+        }
+        if (!wrote) vTaskDelay(pdMS_TO_TICKS(kIdlePollMs));
+    }
+}
+
+} // namespace
+
+bool PcapLogger_Start(const PcapLoggerConfig& cfg) {
+    if (g_writerTask || g_active) return true;
+    g_cfg = cfg;
+    g_snapLen = (cfg.snapLen == 0 || cfg.snapLen > kMaxSnapLen) ? kMaxSnapLen : cfg.snapLen;
+    if (g_cfg.fileCapBytes < kBlockBytes) g_cfg.fileCapBytes = kBlockBytes;
+    // Below the aggregator: the ring absorbs SD latency, capture stats never wait on it.
+    return xTaskCreatePinnedToCore(
+        writerTask,
+        "bw_pcap",
+        4096,
+        nullptr,
+        1,
+        &g_writerTask,
+        0
+    ) == pdPASS;
+}
+
+void IRAM_ATTR PcapLogger_Capture(const wifi_promiscuous_pkt_t* pkt) {
+    if (!g_active) return;
+    const uint16_t origLen = static_cast<uint16_t>(pkt->rx_ctrl.sig_len);
+    uint16_t capLen = g_cfg.headerOnly ? macHeaderLen(pkt->payload, origLen) : origLen;
+    if (capLen > g_snapLen) capLen = g_snapLen;
+
+    RingFrameHdr h;
+    h.tsUs = static_cast<uint64_t>(esp_timer_get_time());
+    h.capLen = capLen;
+    h.origLen = origLen;
+    h.rssi = static_cast<int8_t>(pkt->rx_ctrl.rssi);
+    h.channel = static_cast<uint8_t>(pkt->rx_ctrl.channel);
+    h.flags = (capLen == origLen) ? kFrameHasFcs : 0;   // sig_len includes the FCS
+    h.reserved = 0;
+    g_ring.push(&h, sizeof(h), pkt->payload, capLen);   // All-or-nothing; drops are counted
+}
+
+void PcapLogger_GetStats(PcapLoggerStats* out) {
+    out->framesWritten = g_framesWritten;
+    out->bytesWritten = g_bytesWritten;
+    out->framesDropped = g_ring.dropped();
+    out->bytesDropped = g_ring.droppedBytes();
+    out->writeErrors = g_writeErrors;
+    out->fileIndex = g_fileIndex;
+    out->active = g_active;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdint.h>
+#include <esp_wifi_types.h>
+
+// Streams promiscuous frames to the SD card as PCAP with radiotap headers
+// (LINKTYPE_IEEE802_11_RADIOTAP, opens directly in Wireshark).
+//
+// PcapLogger_Capture() runs on the RX path: it copies the (optionally truncated) frame
+// into a lock-free byte ring and returns; a full ring drops the frame and counts it.
+// A low-priority writer task mounts the card, drains the ring into a 16 KB staging
+// block and writes whole blocks only, so every write lands sector aligned. Files are
+// rotated at fileCapBytes; timestamps are time since boot.
+struct PcapLoggerConfig {
+    bool headerOnly;         // Keep only the 802.11 MAC header of each frame
+    uint16_t snapLen;        // Per-frame cap in bytes (0 = whole frame)
+    uint32_t fileCapBytes;   // Start a new file beyond this size
+    uint16_t maxFiles;       // Oldest file is deleted beyond this many (0 = keep all)
+};
+
+struct PcapLoggerStats {
+    uint32_t framesWritten;
+    uint32_t bytesWritten;
+    uint32_t framesDropped;  // Ring full: writer or card fell behind
+    uint32_t bytesDropped;
+    uint32_t writeErrors;
+    uint16_t fileIndex;
+    bool active;
+};
+
+// Starts the writer task; logging begins once the card is mounted. Safe to call once.
+bool PcapLogger_Start(const PcapLoggerConfig& cfg);
+
+// RX callback side. Never blocks; a no-op until the logger is active.
+void PcapLogger_Capture(const wifi_promiscuous_pkt_t* pkt);
+
+void PcapLogger_GetStats(PcapLoggerStats* out);
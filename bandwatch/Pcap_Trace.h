@@ -0,0 +1,135 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "Dwell_Metrics.h"
+
+// Decoder for recorded captures (the Pcap_Logger output, or any little-endian
+// microsecond PCAP with radiotap or bare 802.11 frames). Works on bytes already in
+// memory and never allocates, so the host benchmarks and an on-device replay can
+// share it. Frames are turned into the same FrameRecord the RX callback produces.
+
+constexpr uint32_t kPcapMagicUs = 0xA1B2C3D4;
+constexpr uint32_t kPcapMagicNs = 0xA1B23C4D;
+constexpr uint32_t kPcapLinkIeee80211 = 105;
+constexpr uint32_t kPcapLinkRadiotap = 127;
+constexpr size_t kPcapGlobalHdrLen = 24;
+constexpr size_t kPcapRecordHdrLen = 16;
+
+struct PcapTraceInfo {
+    uint32_t linkType;
+    bool nanoseconds;
+};
+
+struct PcapTraceFrame {
+    uint64_t tsUs;
+    uint32_t origLen;       // 802.11 length on air (radiotap stripped)
+    int8_t rssi;            // -127 when the capture has no antenna signal
+    uint8_t channel;        // 0 when unknown
+    uint8_t airtimeRate;    // Airtime.h table index; kAirtimeUnknown without a radiotap Rate
+    const uint8_t* frame;   // 802.11 header onwards, capLen bytes
+    uint32_t capLen;
+};
+
+inline uint16_t pcapLe16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t pcapLe32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// Global header; false for other byte orders or link types.
+inline bool pcapParseGlobal(const uint8_t* p, size_t len, PcapTraceInfo& out) {
+    if (len < kPcapGlobalHdrLen) return false;
+    const uint32_t magic = pcapLe32(p);
+    if (magic != kPcapMagicUs && magic != kPcapMagicNs) return false;
+    out.nanoseconds = (magic == kPcapMagicNs);
+    out.linkType = pcapLe32(p + 20);
+    return out.linkType == kPcapLinkIeee80211 || out.linkType == kPcapLinkRadiotap;
+}
+
+// Radiotap fields up to dBm antenna signal: {align, size} by present bit.
+inline void pcapRadiotapField(int bit, uint8_t& align, uint8_t& size) {
+    static const uint8_t kFields[6][2] = {{8, 8}, {1, 1}, {1, 1}, {2, 4}, {2, 2}, {1, 1}};
+    align = kFields[bit][0];
+    size = kFields[bit][1];
+}
+
+// Pulls rate, channel and signal out of a radiotap header; the result is the header length
+// (0 = malformed).
+inline uint16_t pcapParseRadiotap(const uint8_t* p, uint32_t len, PcapTraceFrame& out) {
+    if (len < 8 || p[0] != 0) return 0;
+    const uint16_t hdrLen = pcapLe16(p + 2);
+    if (hdrLen < 8 || hdrLen > len) return 0;
+    const uint32_t present = pcapLe32(p + 4);
+    size_t off = 8;
+    for (uint32_t ext = present; ext & 0x80000000u;) {  // Extended bitmaps precede the fields
+        if (off + 4 > hdrLen) return 0;
+        ext = pcapLe32(p + off);
+        off += 4;
+    }
+    for (int bit = 0; bit <= 5; bit++) {
+        if (!(present & (1u << bit))) continue;
+        uint8_t align, size;
+        pcapRadiotapField(bit, align, size);
+        off = (off + align - 1) & ~static_cast<size_t>(align - 1);
+        if (off + size > hdrLen) break;
+        if (bit == 2) {
+            out.airtimeRate = airtimeLegacyIndex(p[off]);
+        } else if (bit == 3) {
+            const uint16_t freq = pcapLe16(p + off);
+            if (freq >= 2412 && freq <= 2472) out.channel = static_cast<uint8_t>((freq - 2407) / 5);
+            if (freq == 2484) out.channel = 14;
+        } else if (bit == 5) {
+            out.rssi = static_cast<int8_t>(p[off]);
+        }
+        off += size;
+    }
+    return hdrLen;
+}
+
+// Decodes the record at p. `consumed` is the record length including its header;
+// false at the end of the data or on a truncated record.
+inline bool pcapNextFrame(const PcapTraceInfo& info, const uint8_t* p, size_t len, PcapTraceFrame& out,
+                          size_t& consumed) {
+    if (len < kPcapRecordHdrLen) return false;
+    const uint32_t sec = pcapLe32(p);
+    const uint32_t frac = pcapLe32(p + 4);
+    const uint32_t inclLen = pcapLe32(p + 8);
+    const uint32_t origLen = pcapLe32(p + 12);
+    if (inclLen > len - kPcapRecordHdrLen) return false;
+    consumed = kPcapRecordHdrLen + inclLen;
+
+    const uint8_t* data = p + kPcapRecordHdrLen;
+    out.tsUs = static_cast<uint64_t>(sec) * 1000000 + (info.nanoseconds ? frac / 1000 : frac);
+    out.rssi = -127;
+    out.channel = 0;
+    out.airtimeRate = kAirtimeUnknown;
+    uint32_t skip = 0;
+    if (info.linkType == kPcapLinkRadiotap) {
+        skip = pcapParseRadiotap(data, inclLen, out);
+        if (skip == 0) skip = inclLen;  // Unparseable: hand back an empty frame
+    }
+    out.frame = data + skip;
+    out.capLen = inclLen - skip;
+    out.origLen = (origLen > skip) ? origLen - skip : 0;
+    return true;
+}
+
+// The FrameRecord promiscuousCb would have queued for this frame; false when it would
+// have been ignored (too short for a MAC header, or an extension frame).
+inline bool pcapToFrameRecord(const PcapTraceFrame& f, uint8_t epoch, FrameRecord& rec) {
+    if (f.capLen < 16 || f.origLen < 24) return false;  // Need addr2; sig_len check as on the device
+    const uint8_t ftype = (f.frame[0] >> 2) & 0x3;
+    if (ftype == 3) return false;
+    rec.len = static_cast<uint16_t>(f.origLen > 0xFFFF ? 0xFFFF : f.origLen);
+    rec.rssi = f.rssi;
+    rec.type = ftype;  // 802.11 type matches wifi_promiscuous_pkt_type_t (MGMT, CTRL, DATA)
+    rec.epoch = epoch;
+    memcpy(rec.ta, f.frame + 10, sizeof(rec.ta));
+    rec.rate = f.airtimeRate;
+    return true;
+}
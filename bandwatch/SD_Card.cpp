@@ -1,96 +1,102 @@
-#if 0
-// Disabled: not used by the wifi-tamagotchi build (and pulls in SD deps).
-
 #include "SD_Card.h"
+#include <dirent.h>
+#include <esp_vfs_fat.h>
+#include <sdmmc_cmd.h>
+#include <driver/sdspi_host.h>
+
+#define SD_MAX_OPEN_FILES       2
+#define SD_ALLOC_UNIT_BYTES     (16 * 1024)   // Cluster size used if the card is ever formatted
 
 uint16_t SDCard_Size;
 uint16_t Flash_Size;
 
+static sdmmc_card_t* sdCard = NULL;
+
+static void SD_Path(const char* directory, char* out, size_t outLen)
+{
+  if (strcmp(directory, "/") == 0) snprintf(out, outLen, "%s", SD_MOUNT_POINT);
+  else snprintf(out, outLen, "%s%s", SD_MOUNT_POINT, directory);
+}
+
 bool SD_Init() {
-  // SD
-  pinMode(SD_CS, OUTPUT);    
-  digitalWrite(SD_CS, HIGH);               
-  if (SD.begin(SD_CS, SPI)) {
-    printf("SD card initialization successful!\r\n");
-  } else {
-    printf("SD card initialization failed!\r\n");
-  }
-  uint8_t cardType = SD.cardType();
-  if(cardType == CARD_NONE){
-    printf("No SD card attached\r\n");
+  if (sdCard) return true;
+  sdmmc_host_t host = SDSPI_HOST_DEFAULT();
+  host.slot = SPI2_HOST;                       // Shared with the LCD; bus set up by SPI_Init()
+
+  sdspi_device_config_t slot = SDSPI_DEVICE_CONFIG_DEFAULT();
+  slot.gpio_cs = (gpio_num_t)SD_CS;
+  slot.host_id = SPI2_HOST;
+
+  esp_vfs_fat_mount_config_t mount = {};
+  mount.format_if_mount_failed = false;
+  mount.max_files = SD_MAX_OPEN_FILES;
+  mount.allocation_unit_size = SD_ALLOC_UNIT_BYTES;
+
+  const esp_err_t err = esp_vfs_fat_sdspi_mount(SD_MOUNT_POINT, &host, &slot, &mount, &sdCard);
+  if (err != ESP_OK) {
+    printf("SD card initialization failed (%d)\r\n", (int)err);
+    sdCard = NULL;
     return false;
   }
-  else{
-    printf("SD Card Type: ");
-    if(cardType == CARD_MMC){
-      printf("MMC\r\n");
-    } else if(cardType == CARD_SD){
-      printf("SDSC\r\n");
-    } else if(cardType == CARD_SDHC){
-      printf("SDHC\r\n");
-    } else {
-      printf("UNKNOWN\r\n");
-    }
-    uint64_t totalBytes = SD.totalBytes();
-    uint64_t usedBytes = SD.usedBytes();
-    SDCard_Size = totalBytes/(1024*1024);
-    printf("Total space: %llu\n", totalBytes);
-    printf("Used space: %llu\n", usedBytes);
-    printf("Free space: %llu\n", totalBytes - usedBytes);
-  }
+  const uint64_t totalBytes = (uint64_t)sdCard->csd.capacity * sdCard->csd.sector_size;
+  SDCard_Size = totalBytes / (1024 * 1024);
+  printf("SD card initialization successful! %u MB, mounted at %s\r\n", (unsigned)SDCard_Size, SD_MOUNT_POINT);
   return true;
 }
+
+bool SD_IsMounted()
+{
+  return sdCard != NULL;
+}
+
 bool File_Search(const char* directory, const char* fileName)    
 {
-  File Path = SD.open(directory);
-  if (!Path) {
+  char path[100];
+  SD_Path(directory, path, sizeof(path));
+  DIR* dir = opendir(path);
+  if (!dir) {
     printf("Path: <%s> does not exist\r\n",directory);
     return false;
   }
-  File file = Path.openNextFile();
-  while (file) {
-    if (strcmp(file.name(), fileName) == 0) {                           
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != NULL) {
+    if (strcmp(entry->d_name, fileName) == 0) {                           
       if (strcmp(directory, "/") == 0)
         printf("File '%s%s' found in root directory.\r\n",directory,fileName);  
       else
         printf("File '%s/%s' found in root directory.\r\n",directory,fileName); 
-      Path.close();                                                     
+      closedir(dir);                                                     
       return true;                                                     
     }
-    file = Path.openNextFile();                                        
   }
   if (strcmp(directory, "/") == 0)
     printf("File '%s%s' not found in root directory.\r\n",directory,fileName);           
   else
     printf("File '%s/%s' not found in root directory.\r\n",directory,fileName);          
-  Path.close();                                                         
+  closedir(dir);                                                         
   return false;                                                         
 }
 uint16_t Folder_retrieval(const char* directory, const char* fileExtension, char File_Name[][100],uint16_t maxFiles)    
 {
-  File Path = SD.open(directory);
-  if (!Path) {
+  char path[100];
+  SD_Path(directory, path, sizeof(path));
+  DIR* dir = opendir(path);
+  if (!dir) {
     printf("Path: <%s> does not exist\r\n",directory);
     return false;
   }
   
   uint16_t fileCount = 0;
-  char filePath[100];
-  File file = Path.openNextFile();
-  while (file && fileCount < maxFiles) {
-    if (!file.isDirectory() && strstr(file.name(), fileExtension)) {
-      strncpy(File_Name[fileCount], file.name(), sizeof(File_Name[fileCount])); 
-      if (strcmp(directory, "/") == 0) {                                      
-        snprintf(filePath, 100, "%s%s", directory, file.name());   
-      } else {                                                            
-        snprintf(filePath, 100, "%s/%s", directory, file.name());
-      }
-      printf("File found: %s\r\n", filePath);
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != NULL && fileCount < maxFiles) {
+    if (entry->d_type != DT_DIR && strstr(entry->d_name, fileExtension)) {
+      strncpy(File_Name[fileCount], entry->d_name, sizeof(File_Name[fileCount]) - 1); 
+      File_Name[fileCount][sizeof(File_Name[fileCount]) - 1] = '\0';
+      printf("File found: %s/%s\r\n", path, entry->d_name);
       fileCount++;
     }
-    file = Path.openNextFile();                                      
   }
-  Path.close();                                                         
+  closedir(dir);                                                         
   if (fileCount > 0) {
     printf(" %d <%s> files were retrieved\r\n",fileCount,fileExtension);
     return fileCount;                                                 
@@ -117,5 +123,3 @@ void Flash_test()
 
   printf("/******* RAM Test Over********/\r\n\r\n");
 }
-
-#endif
\ No newline at end of file
@@ -2,18 +2,22 @@
 #include "Arduino.h"
 #include <cstring>
 #include "Display_ST7789.h"
-#include "SD.h"
-#include "FS.h"
 
 // Digital I/O used
 #define SD_CS     4        //                SD_D3:
 
+// FAT volume on the microSD slot, mounted through the IDF sdspi driver on the same
+// SPI2 bus as the panel (LCD_InitAsync() must have initialized the bus first).
+#define SD_MOUNT_POINT   "/sd"
+
 extern uint16_t SDCard_Size;
 extern uint16_t Flash_Size;
 
 bool SD_Init();
+bool SD_IsMounted();
 void Flash_test();
 
+// directory is relative to the card root ("/" or "/dir").
 bool File_Search(const char* directory, const char* fileName);
 uint16_t Folder_retrieval(const char* directory, const char* fileExtension, char File_Name[][100],uint16_t maxFiles);
-void remove_file_extension(char *file_name);
\ No newline at end of file
+void remove_file_extension(char *file_name);
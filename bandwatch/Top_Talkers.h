@@ -0,0 +1,175 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include "HLL_Sketch.h"
+
+// Space-Saving heavy hitters over full 48-bit transmitter addresses: K counters,
+// each with frames, bytes and the channel the transmitter was last heard on.
+//
+// Any transmitter with more than 1/K of all frames is guaranteed to hold a counter.
+// A counter's frames overestimate the truth by at most its `error` (the count it
+// inherited when it took over the slot); bytes only cover the time since then.
+// Lookups go through a 2K-slot open-addressing index, so a hit is O(1). Misses
+// replace a minimum counter; one O(K) scan collects every counter tied at the
+// minimum and later misses use them up, which keeps misses O(1) amortized under the
+// long tail of one-off transmitters. No allocation; the aggregator owns it.
+template <uint8_t K>
+class TopTalkers {
+    static_assert(K >= 4 && K <= 64, "TopTalkers size out of range");
+
+public:
+    struct Entry {
+        uint8_t mac[6];
+        uint8_t channel;    // Last channel heard on (0 until its first dwell closes)
+        uint8_t epoch;      // Dwell generation it was last heard in
+        uint32_t frames;
+        uint32_t bytes;
+        uint32_t error;     // frames may be over by up to this much
+        bool pending;       // Heard in the open dwell; channel not assigned yet
+        uint8_t home;       // Index slot its hash maps to
+    };
+
+    void clear() {
+        count_ = 0;
+        minDepth_ = 0;
+        memset(index_, kEmpty, sizeof(index_));
+    }
+
+    TopTalkers() { clear(); }
+
+    inline void add(const uint8_t mac[6], uint16_t len, uint8_t epoch) {
+        const uint8_t h = home(mac);
+        uint8_t slot = findSlot(mac, h);
+        Entry* e;
+        if (index_[slot] != kEmpty) {
+            e = &entries_[index_[slot]];
+        } else if (count_ < K) {
+            index_[slot] = count_;
+            e = &entries_[count_++];
+            *e = Entry{{mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]}, 0, epoch, 0, 0, 0, false, h};
+            minDepth_ = 0;  // New zero counter: the collected minimum is stale
+        } else {
+            const uint8_t victim = takeMinimum();
+            e = &entries_[victim];
+            unindex(*e);
+            slot = findSlot(mac, h);  // The delete may have shifted the probe run
+            index_[slot] = victim;
+            memcpy(e->mac, mac, 6);
+            e->home = h;
+            e->channel = 0;
+            e->error = e->frames;
+            e->bytes = 0;
+        }
+        e->frames += 1;
+        e->bytes += len;
+        e->epoch = epoch;
+        e->pending = true;
+    }
+
+    // Dwell `epoch` closed on `channel`: everyone heard in it gets that channel.
+    // Pending marks from discarded dwells are dropped. O(K), once per dwell.
+    void assignChannel(uint8_t epoch, uint8_t channel) {
+        for (uint8_t i = 0; i < count_; i++) {
+            Entry& e = entries_[i];
+            if (!e.pending) continue;
+            if (e.epoch == epoch) e.channel = channel;
+            e.pending = false;
+        }
+    }
+
+    // Halves every count so the ranking follows current traffic.
+    void decay() {
+        for (uint8_t i = 0; i < count_; i++) {
+            entries_[i].frames >>= 1;
+            entries_[i].bytes >>= 1;
+            entries_[i].error >>= 1;
+        }
+        minDepth_ = 0;
+    }
+
+    // Up to n heaviest counters by frames, heaviest first. O(K·n), for dwell cadence.
+    uint8_t top(Entry* out, uint8_t n) const {
+        uint64_t taken = 0;
+        uint8_t got = 0;
+        for (; got < n; got++) {
+            int best = -1;
+            for (uint8_t i = 0; i < count_; i++) {
+                if ((taken >> i) & 1) continue;
+                if (entries_[i].frames == 0) continue;
+                if (best < 0 || entries_[i].frames > entries_[best].frames) best = i;
+            }
+            if (best < 0) break;
+            taken |= static_cast<uint64_t>(1) << best;
+            out[got] = entries_[best];
+        }
+        return got;
+    }
+
+    uint8_t size() const { return count_; }
+
+    // Counter for mac, or nullptr when it holds none.
+    const Entry* find(const uint8_t mac[6]) const {
+        const uint8_t i = index_[findSlot(mac, home(mac))];
+        return (i == kEmpty) ? nullptr : &entries_[i];
+    }
+
+private:
+    static constexpr uint8_t kSlots = static_cast<uint8_t>(K * 2);
+    static constexpr uint8_t kMask = static_cast<uint8_t>(kSlots - 1);
+    static constexpr uint8_t kEmpty = 0xFF;
+    static_assert((K & (K - 1)) == 0, "TopTalkers size must be a power of two");
+
+    static uint8_t home(const uint8_t mac[6]) { return static_cast<uint8_t>(hashMac48(mac) & kMask); }
+
+    // Slot holding mac, or the empty slot where it would go.
+    uint8_t findSlot(const uint8_t mac[6], uint8_t h) const {
+        uint8_t s = h;
+        while (index_[s] != kEmpty && memcmp(entries_[index_[s]].mac, mac, 6) != 0) {
+            s = static_cast<uint8_t>((s + 1) & kMask);
+        }
+        return s;
+    }
+
+    // Backward-shift delete, so probes never need tombstones.
+    void unindex(const Entry& gone) {
+        uint8_t hole = findSlot(gone.mac, gone.home);
+        uint8_t s = hole;
+        for (;;) {
+            s = static_cast<uint8_t>((s + 1) & kMask);
+            if (index_[s] == kEmpty) break;
+            const uint8_t h = entries_[index_[s]].home;
+            // Move it into the hole unless its home lies cyclically in (hole, s].
+            const bool stays = (hole < s) ? (h > hole && h <= s) : (h > hole || h <= s);
+            if (!stays) {
+                index_[hole] = index_[s];
+                hole = s;
+            }
+        }
+        index_[hole] = kEmpty;
+    }
+
+    // A counter at the current minimum. Counts only grow between scans, so a
+    // collected counter still at minFrames_ is still a minimum.
+    uint8_t takeMinimum() {
+        while (minDepth_ > 0) {
+            const uint8_t i = minStack_[--minDepth_];
+            if (entries_[i].frames == minFrames_) return i;
+        }
+        minFrames_ = entries_[0].frames;
+        for (uint8_t i = 1; i < count_; i++) {
+            if (entries_[i].frames < minFrames_) minFrames_ = entries_[i].frames;
+        }
+        for (uint8_t i = 0; i < count_; i++) {
+            if (entries_[i].frames == minFrames_) minStack_[minDepth_++] = i;
+        }
+        return minStack_[--minDepth_];
+    }
+
+    Entry entries_[K];
+    uint8_t index_[kSlots];
+    uint8_t minStack_[K];
+    uint8_t count_ = 0;
+    uint8_t minDepth_ = 0;
+    uint32_t minFrames_ = 0;
+};
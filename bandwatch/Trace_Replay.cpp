@@ -0,0 +1,293 @@
+#include "Trace_Replay.h"
+#include "Pcap_Trace.h"
+#include "SD_Card.h"
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <esp_partition.h>
+#include <esp_timer.h>
+
+namespace {
+
+constexpr const char* kPartitionLabel = "trace";
+constexpr uint8_t kPartitionSubtype = 0x42;    // Custom data subtype (partitions.csv)
+constexpr const char* kSdTraceFile = SD_MOUNT_POINT "/replay.pcap";
+constexpr uint32_t kReplayMaxFrames = 4096;    // 16 B each: 64 KB of heap at most
+constexpr uint32_t kReplayMinFrames = 256;     // Smallest buffer worth trying when heap is short
+constexpr uint32_t kSdKeepBytes = 128;        // Radiotap plus MAC header; payload is skipped
+constexpr uint32_t kReplayMaxGapUs = 100000;   // Longer recorded pauses are shortened to this
+constexpr uint32_t kReplayReportMs = 5000;     // Timed mode progress line
+constexpr uint32_t kSweepStartPps = 1000;
+constexpr uint32_t kSweepMaxPps = 200000;
+constexpr uint32_t kSweepStepMs = 3000;        // ~11 dwells per rate
+constexpr uint32_t kSweepSettleMs = 500;       // Ignored at the start of each step
+constexpr uint32_t kSweepSlipLimitUs = 2000;   // Hop timer lateness that fails a step
+constexpr UBaseType_t kReplayTaskPriority = 5; // Above the aggregator (3), like the Wi-Fi task
+
+struct ReplayFrame {
+    uint32_t gapUs;   // Since the previous frame in the recording
+    FrameRecord rec;
+};
+static_assert(sizeof(ReplayFrame) == 16, "ReplayFrame layout");
+
+ReplayFrame* g_frames = nullptr;
+uint32_t g_frameCount = 0;
+TraceReplayTarget g_target{};
+TraceReplayConfig g_cfg{};
+TaskHandle_t g_task = nullptr;
+volatile bool g_stopRequested = false;
+volatile uint32_t g_injected = 0;
+volatile uint32_t g_bestPps = 0;
+
+// Appends one decoded frame; false once the buffer is full.
+bool appendFrame(const PcapTraceFrame& f, uint64_t& lastTsUs, uint32_t capacity) {
+    if (g_frameCount >= capacity) return false;
+    ReplayFrame& out = g_frames[g_frameCount];
+    if (!pcapToFrameRecord(f, 0, out.rec)) return true;  // Skipped, keep going
+    const uint64_t gap = (g_frameCount == 0 || f.tsUs < lastTsUs) ? 0 : f.tsUs - lastTsUs;
+    out.gapUs = static_cast<uint32_t>(gap > kReplayMaxGapUs ? kReplayMaxGapUs : gap);
+    lastTsUs = f.tsUs;
+    g_frameCount++;
+    return true;
+}
+
+uint32_t allocFrames() {
+    for (uint32_t cap = kReplayMaxFrames; cap >= kReplayMinFrames; cap /= 2) {
+        g_frames = static_cast<ReplayFrame*>(malloc(cap * sizeof(ReplayFrame)));
+        if (g_frames) return cap;
+    }
+    return 0;
+}
+
+void shrinkFrames() {
+    ReplayFrame* p = static_cast<ReplayFrame*>(realloc(g_frames, g_frameCount * sizeof(ReplayFrame)));
+    if (p) g_frames = p;
+}
+
+bool loadFromFlash(uint32_t capacity) {
+    const esp_partition_t* part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+        static_cast<esp_partition_subtype_t>(kPartitionSubtype), kPartitionLabel);
+    if (!part) return false;
+    const void* map = nullptr;
+    esp_partition_mmap_handle_t handle;
+    if (esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &map, &handle) != ESP_OK) return false;
+    const uint8_t* base = static_cast<const uint8_t*>(map);
+    PcapTraceInfo info;
+    if (!pcapParseGlobal(base, part->size, info)) {
+        esp_partition_munmap(handle);
+        return false;
+    }
+    // Erased flash after the last record reads as an oversized record and ends the walk.
+    size_t off = kPcapGlobalHdrLen;
+    size_t used = 0;
+    uint64_t lastTsUs = 0;
+    PcapTraceFrame f;
+    while (pcapNextFrame(info, base + off, part->size - off, f, used) && appendFrame(f, lastTsUs, capacity)) {
+        off += used;
+    }
+    esp_partition_munmap(handle);
+    printf("replay: %lu frames from the '%s' partition\r\n", static_cast<unsigned long>(g_frameCount), kPartitionLabel);
+    return g_frameCount > 0;
+}
+
+bool loadFromSd(uint32_t capacity) {
+    if (!SD_Init()) return false;
+    FILE* file = fopen(kSdTraceFile, "rb");
+    if (!file) return false;
+    uint8_t hdr[kPcapGlobalHdrLen];
+    PcapTraceInfo info;
+    if (fread(hdr, 1, sizeof(hdr), file) != sizeof(hdr) || !pcapParseGlobal(hdr, sizeof(hdr), info)) {
+        fclose(file);
+        return false;
+    }
+    // pcapToFrameRecord needs the MAC header only, so only a prefix of each record is read.
+    static uint8_t buf[kPcapRecordHdrLen + kSdKeepBytes];
+    uint64_t lastTsUs = 0;
+    for (;;) {
+        if (fread(buf, 1, kPcapRecordHdrLen, file) != kPcapRecordHdrLen) break;
+        const uint32_t inclLen = pcapLe32(buf + 8);
+        const uint32_t keep = inclLen < kSdKeepBytes ? inclLen : kSdKeepBytes;
+        if (fread(buf + kPcapRecordHdrLen, 1, keep, file) != keep) break;
+        if (inclLen > keep && fseek(file, static_cast<long>(inclLen - keep), SEEK_CUR) != 0) break;
+        // Decode the kept prefix as if it were the whole capture; origLen is untouched.
+        buf[8] = static_cast<uint8_t>(keep);
+        buf[9] = buf[10] = buf[11] = 0;
+        PcapTraceFrame f;
+        size_t used = 0;
+        if (!pcapNextFrame(info, buf, kPcapRecordHdrLen + keep, f, used) || !appendFrame(f, lastTsUs, capacity)) break;
+    }
+    fclose(file);
+    printf("replay: %lu frames from %s\r\n", static_cast<unsigned long>(g_frameCount), kSdTraceFile);
+    return g_frameCount > 0;
+}
+
+bool loadTrace() {
+    if (g_frames) return true;
+    const uint32_t capacity = allocFrames();
+    if (capacity == 0) {
+        printf("replay: not enough heap for a trace buffer\r\n");
+        return false;
+    }
+    g_frameCount = 0;
+    if (!loadFromFlash(capacity)) {
+        g_frameCount = 0;
+        loadFromSd(capacity);
+    }
+    if (g_frameCount == 0) {
+        printf("replay: no trace (flash '%s' partition or %s)\r\n", kPartitionLabel, kSdTraceFile);
+        free(g_frames);
+        g_frames = nullptr;
+        return false;
+    }
+    if (g_frameCount == capacity) printf("replay: trace cut at %lu frames\r\n", static_cast<unsigned long>(capacity));
+    shrinkFrames();
+    return true;
+}
+
+inline void injectAt(uint32_t& idx) {
+    g_target.inject(g_frames[idx].rec);
+    g_injected = g_injected + 1;
+    if (++idx == g_frameCount) idx = 0;
+}
+
+void runTimed() {
+    const uint32_t speed = g_cfg.speedX ? g_cfg.speedX : 1;
+    printf("replay: timed, %lux, %lu frames looped\r\n", static_cast<unsigned long>(speed),
+           static_cast<unsigned long>(g_frameCount));
+    const int64_t startUs = esp_timer_get_time();
+    uint64_t dueUs = 0;   // Virtual time of the next frame, speed applied
+    uint32_t idx = 0;
+    uint32_t reportStartMs = millis();
+    uint32_t reportInjected = g_injected;
+    uint32_t reportLost = g_target.lostRecords();
+    uint32_t worstSlipUs = 0;
+    while (!g_stopRequested) {
+        const uint64_t nowUs = static_cast<uint64_t>(esp_timer_get_time() - startUs);
+        while (dueUs <= nowUs && !g_stopRequested) {
+            injectAt(idx);
+            dueUs += (idx == 0 ? 1000 : g_frames[idx].gapUs) / speed;  // 1 ms pause at the loop point
+        }
+        const uint32_t slip = g_target.takeHopSlipUs();
+        if (slip > worstSlipUs) worstSlipUs = slip;
+        const uint32_t nowMs = millis();
+        if ((nowMs - reportStartMs) >= kReplayReportMs) {
+            const uint32_t lost = g_target.lostRecords();
+            printf("replay: %lu pps, lost %lu, hop slip max %lu us\r\n",
+                   static_cast<unsigned long>(static_cast<uint64_t>(g_injected - reportInjected) * 1000 / (nowMs - reportStartMs)),
+                   static_cast<unsigned long>(lost - reportLost), static_cast<unsigned long>(worstSlipUs));
+            reportStartMs = nowMs;
+            reportInjected = g_injected;
+            reportLost = lost;
+            worstSlipUs = 0;
+        }
+        vTaskDelay(1);
+    }
+}
+
+// One sweep step at `pps`: true when nothing was lost and the hop timer kept time.
+bool runSweepStep(uint32_t pps, uint32_t& idx) {
+    const int64_t startUs = esp_timer_get_time();
+    uint64_t sent = 0;
+    uint32_t lostAtStart = 0;
+    uint32_t worstSlipUs = 0;
+    bool settled = false;
+    for (;;) {
+        if (g_stopRequested) return false;
+        const uint64_t elapsedUs = static_cast<uint64_t>(esp_timer_get_time() - startUs);
+        if (elapsedUs >= static_cast<uint64_t>(kSweepStepMs) * 1000) break;
+        const uint64_t due = elapsedUs * pps / 1000000;
+        while (sent < due) {
+            injectAt(idx);
+            sent++;
+        }
+        if (!settled && elapsedUs >= static_cast<uint64_t>(kSweepSettleMs) * 1000) {
+            settled = true;
+            lostAtStart = g_target.lostRecords();
+            g_target.takeHopSlipUs();
+        } else if (settled) {
+            const uint32_t slip = g_target.takeHopSlipUs();
+            if (slip > worstSlipUs) worstSlipUs = slip;
+        }
+        vTaskDelay(1);
+    }
+    const uint32_t lost = g_target.lostRecords() - lostAtStart;
+    const bool ok = lost == 0 && worstSlipUs <= kSweepSlipLimitUs;
+    printf("replay: %6lu pps %s (lost %lu, hop slip max %lu us)\r\n", static_cast<unsigned long>(pps),
+           ok ? "ok  " : "FAIL", static_cast<unsigned long>(lost), static_cast<unsigned long>(worstSlipUs));
+    return ok;
+}
+
+void runSweep() {
+    printf("replay: sweep from %lu pps, %lu ms per step, ui %s\r\n", static_cast<unsigned long>(kSweepStartPps),
+           static_cast<unsigned long>(kSweepStepMs), g_cfg.uiRunning ? "on" : "off");
+    uint32_t idx = 0;
+    uint32_t best = 0;
+    uint32_t pps = kSweepStartPps;
+    bool retried = false;
+    while (!g_stopRequested && pps <= kSweepMaxPps) {
+        if (runSweepStep(pps, idx)) {
+            best = pps;
+            retried = false;
+            pps += pps / 4;   // +25% per step
+        } else if (!retried && !g_stopRequested) {
+            retried = true;   // One more try: a single slow flash read or log line can fail a step
+        } else {
+            break;
+        }
+    }
+    if (g_stopRequested) {
+        printf("replay: sweep stopped\r\n");
+        return;
+    }
+    g_bestPps = best;
+    printf("replay: max sustained %lu pps%s (ui %s)\r\n", static_cast<unsigned long>(best),
+           pps > kSweepMaxPps ? " (sweep limit)" : "", g_cfg.uiRunning ? "on" : "off");
+}
+
+void replayTask(void* param) {
+    (void)param;
+    g_target.setActive(true);
+    if (g_cfg.mode == ReplayMode::Sweep) {
+        runSweep();
+    } else {
+        runTimed();
+    }
+    g_target.setActive(false);
+    g_task = nullptr;
+    vTaskDelete(nullptr);
+}
+
+} // namespace
+
+bool TraceReplay_Start(const TraceReplayTarget& target, const TraceReplayConfig& cfg) {
+    if (g_task) return false;
+    if (!loadTrace()) return false;
+    g_target = target;
+    g_cfg = cfg;
+    g_stopRequested = false;
+    return xTaskCreatePinnedToCore(
+        replayTask,
+        "bw_replay",
+        3072,
+        nullptr,
+        kReplayTaskPriority,
+        &g_task,
+        0
+    ) == pdPASS;
+}
+
+void TraceReplay_Stop(void) {
+    g_stopRequested = true;
+}
+
+bool TraceReplay_Running(void) {
+    return g_task != nullptr;
+}
+
+void TraceReplay_GetStats(TraceReplayStats* out) {
+    out->traceFrames = g_frameCount;
+    out->injected = g_injected;
+    out->bestPps = g_bestPps;
+    out->running = g_task != nullptr;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+#include "Dwell_Metrics.h"
+
+// Replays a recorded capture into the live aggregation path, so capture throughput
+// can be measured without RF and repeated on every build.
+//
+// The trace is a PCAP (the Pcap_Logger output, header-only is enough) read from the
+// "trace" flash partition, or from /sd/replay.pcap when the partition holds none. It
+// is decoded once into the FrameRecords promiscuousCb would have queued (heap, at
+// most kReplayMaxFrames; longer traces are cut) and then looped:
+//   - Timed: recorded inter-frame gaps divided by speedX (1 = real time).
+//   - Sweep: evenly spaced frames at a rate that steps up until records are lost or
+//     the hop timer slips, then reports the highest rate that held.
+// A high-priority task injects the frames in 1 ms bursts through the target's
+// inject hook, i.e. the same ring, epochs and hop timer as live capture.
+enum class ReplayMode : uint8_t {
+    Timed = 0,
+    Sweep = 1,
+};
+
+struct TraceReplayTarget {
+    void (*inject)(const FrameRecord& rec);  // Queue one frame as promiscuousCb would
+    uint32_t (*lostRecords)(void);           // Monotonic: frames and dwell closes the aggregator lost
+    uint32_t (*takeHopSlipUs)(void);         // Worst dwell length error since the last call
+    void (*setActive)(bool active);          // Live capture off while true
+};
+
+struct TraceReplayConfig {
+    ReplayMode mode;
+    uint16_t speedX;       // Timed mode playback speed (>= 1)
+    bool uiRunning;        // Reported with the result only
+};
+
+struct TraceReplayStats {
+    uint32_t traceFrames;  // Frames loaded (0 = nothing loaded yet)
+    uint32_t injected;     // Total frames injected (monotonic)
+    uint32_t bestPps;      // Last sweep result, 0 = none yet
+    bool running;
+};
+
+// Loads the trace on first use and starts replaying; false when no trace was found or
+// a replay is already running. The hooks must stay valid.
+bool TraceReplay_Start(const TraceReplayTarget& target, const TraceReplayConfig& cfg);
+
+// Ends the replay (at the next 1 ms burst) and restores live capture.
+void TraceReplay_Stop(void);
+
+bool TraceReplay_Running(void);
+void TraceReplay_GetStats(TraceReplayStats* out);
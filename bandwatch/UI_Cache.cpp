@@ -0,0 +1,159 @@
+#include "UI_Cache.h"
+#include <string.h>
+
+#define UI_KNOWN_BG    0x01
+#define UI_KNOWN_TEXT  0x02
+
+static Ui_Stats uiStats;
+static Ui_Stats uiReported;   // Snapshot at the previous report
+
+static uint32_t areaPx(const lv_area_t* a)
+{
+  return (uint32_t)lv_area_get_width(a) * (uint32_t)lv_area_get_height(a);
+}
+
+static void countSkip(Ui_Widget* w, uint32_t* counter)
+{
+  lv_area_t a;
+  lv_obj_get_coords(w->obj, &a);
+  uiStats.savedPx += areaPx(&a);
+  (*counter)++;
+}
+
+static bool rateLimited(Ui_Widget* w)
+{
+  if (w->minIntervalMs == 0) return false;
+  const uint32_t now = lv_tick_get();
+  if ((now - w->lastApplyMs) < w->minIntervalMs) return true;
+  w->lastApplyMs = now;
+  return false;
+}
+
+static void invalidateCb(lv_event_t* e)
+{
+  const lv_area_t* a = (const lv_area_t*)lv_event_get_param(e);
+  uiStats.invalidations++;
+  if (a) uiStats.invalidatedPx += areaPx(a);
+}
+
+#if UI_STATS_REPORT_MS > 0
+static void reportTimerCb(lv_timer_t* t)
+{
+  (void)t;
+  const Ui_Stats& s = uiStats;
+  const Ui_Stats& p = uiReported;
+  // RGB565: two bytes per pixel on the wire.
+  printf("ui: req %lu applied %lu same %lu rate %lu | inval %lu (%lu px) flush %lu (%lu KB) saved ~%lu KB\r\n",
+         (unsigned long)(s.requests - p.requests), (unsigned long)(s.applied - p.applied),
+         (unsigned long)(s.skippedSame - p.skippedSame), (unsigned long)(s.skippedRate - p.skippedRate),
+         (unsigned long)(s.invalidations - p.invalidations), (unsigned long)(s.invalidatedPx - p.invalidatedPx),
+         (unsigned long)(s.flushes - p.flushes), (unsigned long)((s.flushedPx - p.flushedPx) * 2 / 1024),
+         (unsigned long)((s.savedPx - p.savedPx) * 2 / 1024));
+  uiReported = uiStats;
+}
+#endif
+
+void Ui_Init(lv_display_t* disp)
+{
+  memset(&uiStats, 0, sizeof(uiStats));
+  memset(&uiReported, 0, sizeof(uiReported));
+  lv_display_add_event_cb(disp, invalidateCb, LV_EVENT_INVALIDATE_AREA, NULL);
+#if UI_STATS_REPORT_MS > 0
+  lv_timer_create(reportTimerCb, UI_STATS_REPORT_MS, NULL);
+#endif
+}
+
+void Ui_Bind(Ui_Widget* w, lv_obj_t* obj, uint16_t minIntervalMs)
+{
+  memset(w, 0, sizeof(*w));
+  w->obj = obj;
+  w->minIntervalMs = minIntervalMs;
+}
+
+bool Ui_SetText(Ui_Widget* w, const char* text)
+{
+  uiStats.requests++;
+  // The label's own copy is the cache: exact, and no extra RAM per widget.
+  const char* cur = lv_label_get_text(w->obj);
+  if (cur && strcmp(cur, text) == 0) {
+    countSkip(w, &uiStats.skippedSame);
+    return false;
+  }
+  if (rateLimited(w)) {
+    countSkip(w, &uiStats.skippedRate);
+    return false;
+  }
+  lv_label_set_text(w->obj, text);
+  uiStats.applied++;
+  return true;
+}
+
+bool Ui_SetBarValue(Ui_Widget* w, int32_t value)
+{
+  uiStats.requests++;
+  if (lv_bar_get_value(w->obj) == value) {
+    countSkip(w, &uiStats.skippedSame);
+    return false;
+  }
+  if (rateLimited(w)) {
+    countSkip(w, &uiStats.skippedRate);
+    return false;
+  }
+  lv_bar_set_value(w->obj, value, LV_ANIM_OFF);
+  uiStats.applied++;
+  return true;
+}
+
+bool Ui_SetBgColor(Ui_Widget* w, lv_color_t color, lv_style_selector_t selector)
+{
+  uiStats.requests++;
+  const uint32_t c = lv_color_to_u32(color);
+  if ((w->known & UI_KNOWN_BG) && w->bgColor == c) {
+    countSkip(w, &uiStats.skippedSame);
+    return false;
+  }
+  lv_obj_set_style_bg_color(w->obj, color, selector);
+  w->bgColor = c;
+  w->known |= UI_KNOWN_BG;
+  uiStats.applied++;
+  return true;
+}
+
+bool Ui_SetTextColor(Ui_Widget* w, lv_color_t color)
+{
+  uiStats.requests++;
+  const uint32_t c = lv_color_to_u32(color);
+  if ((w->known & UI_KNOWN_TEXT) && w->textColor == c) {
+    countSkip(w, &uiStats.skippedSame);
+    return false;
+  }
+  lv_obj_set_style_text_color(w->obj, color, 0);
+  w->textColor = c;
+  w->known |= UI_KNOWN_TEXT;
+  uiStats.applied++;
+  return true;
+}
+
+bool Ui_SetHidden(Ui_Widget* w, bool hidden)
+{
+  uiStats.requests++;
+  if (lv_obj_has_flag(w->obj, LV_OBJ_FLAG_HIDDEN) == hidden) {
+    countSkip(w, &uiStats.skippedSame);
+    return false;
+  }
+  if (hidden) lv_obj_add_flag(w->obj, LV_OBJ_FLAG_HIDDEN);
+  else lv_obj_clear_flag(w->obj, LV_OBJ_FLAG_HIDDEN);
+  uiStats.applied++;
+  return true;
+}
+
+void Ui_NoteFlush(const lv_area_t* area)
+{
+  uiStats.flushes++;
+  uiStats.flushedPx += areaPx(area);
+}
+
+void Ui_GetStats(Ui_Stats* out)
+{
+  *out = uiStats;
+}
@@ -0,0 +1,187 @@
+#include "UI_Digits.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static inline bool isDigit(char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+// Cell width of c; *glyph is its sprite index, or -1 when it is not in the set.
+static int32_t cellWidth(const Ui_DigitFont* f, char c, int* glyph)
+{
+  for (uint8_t i = 0; i < f->count; i++) {
+    if (f->chars[i] == c) {
+      *glyph = i;
+      return (int32_t)f->glyphs[i].header.w;
+    }
+  }
+  *glyph = -1;
+  return f->digitWidth;
+}
+
+// Offset of the first cell inside a widget `width` pixels wide.
+static int32_t textStart(const Ui_Digits* d, const char* text, uint8_t len, int32_t width)
+{
+  if (d->align == LV_TEXT_ALIGN_LEFT) return 0;
+  int32_t total = 0;
+  int glyph;
+  for (uint8_t i = 0; i < len; i++) total += cellWidth(d->font, text[i], &glyph);
+  return (d->align == LV_TEXT_ALIGN_RIGHT) ? width - total : (width - total) / 2;
+}
+
+static void drawCb(lv_event_t* e)
+{
+  const Ui_Digits* d = (const Ui_Digits*)lv_event_get_user_data(e);
+  lv_layer_t* layer = lv_event_get_layer(e);
+  lv_area_t c;
+  lv_obj_get_coords(d->obj, &c);
+
+  lv_draw_image_dsc_t img;
+  lv_draw_image_dsc_init(&img);
+  int32_t x = c.x1 + textStart(d, d->text, d->len, lv_area_get_width(&c));
+  for (uint8_t i = 0; i < d->len; i++) {
+    int glyph;
+    const int32_t w = cellWidth(d->font, d->text[i], &glyph);
+    if (glyph >= 0) {
+      // Opaque RGB565 onto RGB565 at full opacity: the software renderer copies rows.
+      const lv_area_t a = {x, c.y1, x + w - 1, c.y1 + d->font->height - 1};
+      img.src = &d->font->glyphs[glyph];
+      lv_draw_image(layer, &img, &a);
+    }
+    x += w;
+  }
+}
+
+bool Ui_DigitFontInit(Ui_DigitFont* f, const lv_font_t* font, lv_color_t color, lv_color_t bg,
+                      const char* chars, int32_t letterSpace)
+{
+  memset(f, 0, sizeof(*f));
+  f->bg = bg;
+  f->height = lv_font_get_line_height(font);
+  size_t n = strlen(chars);
+  if (n > UI_DIGIT_FONT_MAX_CHARS) n = UI_DIGIT_FONT_MAX_CHARS;
+  memcpy(f->chars, chars, n);
+
+  int32_t glyphW[UI_DIGIT_FONT_MAX_CHARS];
+  int32_t digitW = lv_font_get_glyph_width(font, '0', 0);
+  for (size_t i = 0; i < n; i++) {
+    glyphW[i] = lv_font_get_glyph_width(font, (uint8_t)chars[i], 0);
+    if (isDigit(chars[i]) && glyphW[i] > digitW) digitW = glyphW[i];
+  }
+  f->digitWidth = digitW + letterSpace;
+  int32_t total = 0;
+  for (size_t i = 0; i < n; i++) total += (isDigit(chars[i]) ? digitW : glyphW[i]) + letterSpace;
+
+  const size_t bytes = (size_t)total * (size_t)f->height * 2;
+  f->pixels = (uint8_t*)malloc(bytes);
+  if (!f->pixels) {
+    printf("ui: no memory for %lu B of digit sprites\r\n", (unsigned long)bytes);
+    return false;
+  }
+
+  // Render through a throwaway canvas so the glyphs get LVGL's own anti-aliasing.
+  lv_obj_t* canvas = lv_canvas_create(lv_layer_top());
+  lv_obj_add_flag(canvas, LV_OBJ_FLAG_HIDDEN);
+  lv_canvas_set_buffer(canvas, f->pixels, total, f->height, LV_COLOR_FORMAT_RGB565);
+  lv_canvas_fill_bg(canvas, bg, LV_OPA_COVER);
+  lv_layer_t layer;
+  lv_canvas_init_layer(canvas, &layer);
+
+  char text[UI_DIGIT_FONT_MAX_CHARS][2];  // Referenced by the draw tasks until finish_layer
+  int32_t x = 0;
+  for (size_t i = 0; i < n; i++) {
+    const int32_t w = (isDigit(chars[i]) ? digitW : glyphW[i]) + letterSpace;
+    text[i][0] = chars[i];
+    text[i][1] = '\0';
+    lv_draw_label_dsc_t label;
+    lv_draw_label_dsc_init(&label);
+    label.font = font;
+    label.color = color;
+    label.text = text[i];
+    const int32_t gx = x + (w - glyphW[i]) / 2;
+    const lv_area_t a = {gx, 0, x + w - 1, f->height - 1};
+    lv_draw_label(&layer, &label, &a);
+
+    lv_image_dsc_t& g = f->glyphs[i];
+    g.header.magic = LV_IMAGE_HEADER_MAGIC;
+    g.header.cf = LV_COLOR_FORMAT_RGB565;
+    g.header.w = (uint32_t)w;
+    g.header.h = (uint32_t)f->height;
+    g.header.stride = (uint32_t)total * 2;
+    g.data = f->pixels + (size_t)x * 2;
+    g.data_size = g.header.stride * (uint32_t)(f->height - 1) + (uint32_t)w * 2;
+    x += w;
+  }
+  lv_canvas_finish_layer(canvas, &layer);
+  lv_obj_delete(canvas);
+  f->count = (uint8_t)n;
+  return true;
+}
+
+lv_obj_t* Ui_DigitsCreate(Ui_Digits* d, lv_obj_t* parent, const Ui_DigitFont* font, int32_t width,
+                          lv_text_align_t align, uint16_t minIntervalMs)
+{
+  memset(d, 0, sizeof(*d));
+  d->font = font;
+  d->align = (uint8_t)align;
+  d->minIntervalMs = minIntervalMs;
+  lv_obj_t* obj = lv_obj_create(parent);
+  lv_obj_remove_style_all(obj);
+  lv_obj_set_size(obj, width, font->height);
+  lv_obj_set_style_bg_color(obj, font->bg, 0);
+  lv_obj_set_style_bg_opa(obj, LV_OPA_COVER, 0);
+  lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_event_cb(obj, drawCb, LV_EVENT_DRAW_MAIN, d);
+  d->obj = obj;
+  return obj;
+}
+
+bool Ui_DigitsSet(Ui_Digits* d, const char* text)
+{
+  char next[UI_DIGITS_MAX_CELLS + 1];
+  size_t n = strlen(text);
+  if (n > UI_DIGITS_MAX_CELLS) n = UI_DIGITS_MAX_CELLS;
+  memcpy(next, text, n);
+  next[n] = '\0';
+  const uint8_t len = (uint8_t)n;
+  if (len == d->len && memcmp(next, d->text, len) == 0) return false;
+  if (d->minIntervalMs) {
+    const uint32_t now = lv_tick_get();
+    if ((now - d->lastApplyMs) < d->minIntervalMs) return false;
+    d->lastApplyMs = now;
+  }
+
+  // Walk both layouts together; a cell is redrawn when its character or position moved.
+  lv_area_t c;
+  lv_obj_get_coords(d->obj, &c);
+  const int32_t width = lv_area_get_width(&c);
+  int32_t oldX = c.x1 + textStart(d, d->text, d->len, width);
+  int32_t newX = c.x1 + textStart(d, next, len, width);
+  const uint8_t cells = (len > d->len) ? len : d->len;
+  for (uint8_t i = 0; i < cells; i++) {
+    int glyph;
+    const char oc = (i < d->len) ? d->text[i] : '\0';
+    const char nc = (i < len) ? next[i] : '\0';
+    const int32_t ow = oc ? cellWidth(d->font, oc, &glyph) : 0;
+    const int32_t nw = nc ? cellWidth(d->font, nc, &glyph) : 0;
+    if (oc != nc || oldX != newX) {
+      lv_area_t a;
+      a.x1 = ow ? oldX : newX;
+      a.x2 = ow ? oldX + ow - 1 : newX + nw - 1;
+      if (ow && nw) {
+        if (newX < a.x1) a.x1 = newX;
+        if (newX + nw - 1 > a.x2) a.x2 = newX + nw - 1;
+      }
+      a.y1 = c.y1;
+      a.y2 = c.y2;
+      lv_obj_invalidate_area(d->obj, &a);
+    }
+    oldX += ow;
+    newX += nw;
+  }
+  memcpy(d->text, next, (size_t)len + 1);
+  d->len = len;
+  return true;
+}
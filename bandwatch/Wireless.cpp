@@ -1,5 +1,6 @@
 #if 0
-// Disabled: not used by the wifi-tamagotchi build (and pulls in BLE deps).
+// Disabled: not used by the bandwatch build (and pulls in BLE deps). BLE scanning for
+// the combined Wi-Fi + BLE build lives in Ble_Slice.cpp.
 
 #include "Wireless.h"
 
@@ -1,12 +1,30 @@
 #include "bandwatch.h"
+#include "Capture_Ring.h"
+#include "HLL_Sketch.h"
+#include "Hop_Scheduler.h"
+#include "Boot_Timing.h"
+#include "Busy_Score.h"
+#include "Dwell_Metrics.h"
+#include "UI_Cache.h"
+#include "UI_Digits.h"
+#include "RGB_LED.h"
+#include "Pcap_Logger.h"
+#include "Metric_History.h"
+#include "Ble_Slice.h"
+#include "Hot_Stats.h"
+#include "Trace_Replay.h"
+#include "Top_Talkers.h"
+#include "Mesh_Link.h"
+#include "Display_ST7789.h"
 
 #include <Arduino.h>
 #include <WiFi.h>
 #include <esp_wifi.h>
 #include <esp_wifi_types.h>
-#include <math.h>
-#include <Adafruit_NeoPixel.h>  // Requires Adafruit NeoPixel library (Library Manager)
-#define HAVE_NEOPIXEL 1
+#if BANDWATCH_BLE && __has_include(<esp_coexist.h>)
+#include <esp_coexist.h>
+#define BANDWATCH_COEX_PREFERENCE 1
+#endif
 
 namespace {
 
@@ -16,14 +34,89 @@ constexpr uint32_t kDwellMs = 260;          // Dwell per channel (instructions:
 constexpr uint32_t kUiIntervalMs = 120;     // UI refresh cadence
 constexpr int kChannelCount = 13;           // 2.4 GHz 1–13
 constexpr int kStrongThresholdDbm = -65;    // "Strong" frame threshold
-constexpr float kBusyEmaAlpha = 0.22f;      // Smoothing within required 0.15–0.30
-constexpr int kUniqueSlots = 24;            // Best-effort unique transmitter slots
+constexpr uint16_t kBusyEmaAlphaQ16 = 14418; // 0.22 in Q16; smoothing within required 0.15–0.30
+constexpr uint8_t kChannelSketchBits = 7;   // Per-channel HLL, two generations
+constexpr uint32_t kTalkerWindowMs = 30000; // Generation length for per-channel/all-channel estimates
 constexpr int kRgbPin = 8;                  // Onboard RGB LED data pin (WS2812)
-constexpr int kRgbCount = 1;                // Single diode
-// NOTE: If the LED shows the wrong colors (e.g. “red” looks green), change this to NEO_GRB.
+// NOTE: If the LED shows the wrong colors (e.g. “red” looks green), change this to LED_ORDER_GRB.
 // Some boards wire the onboard WS2812 as RGB order rather than the common GRB.
-constexpr uint16_t kNeoPixelType = NEO_RGB + NEO_KHZ800;
+constexpr Led_ColorOrder kRgbOrder = LED_ORDER_RGB;
+constexpr uint8_t kRgbMaxBrightness = 60;   // 0–255 cap on every LED level
 constexpr uint32_t kApUpdateMs = 3000;      // AP count refresh cadence
+constexpr bool kLedSelfTest = true;         // Red -> green -> blue flash at boot (non-blocking)
+constexpr uint32_t kLedSelfTestStepMs = 120;
+constexpr size_t kCaptureRingSize = 256;    // Frame records buffered between RX callback and aggregator
+constexpr uint32_t kAggregatePeriodMs = 4;  // Aggregator drain cadence
+constexpr uint32_t kDropReportMs = 5000;    // Min spacing of ring-overflow reports on serial
+
+// PCAP logging to the SD card (see Pcap_Logger.h); disabled on its own when no card is present.
+constexpr bool kPcapLog = true;
+constexpr bool kPcapHeaderOnly = true;      // MAC header only: ~10x less card bandwidth than full frames
+constexpr uint16_t kPcapSnapLen = 256;      // Per-frame byte cap when kPcapHeaderOnly is false
+constexpr uint32_t kPcapFileCapBytes = 64UL * 1024 * 1024;
+constexpr uint16_t kPcapMaxFiles = 32;      // Oldest bwNNNN.pcap deleted beyond this (0 = keep all)
+
+// On-flash history (see Metric_History.h). Dwells are folded into one record per
+// channel per slot: 13 channels at 60 s is ~19k records, ~200 KB, per day.
+constexpr bool kHistoryLog = true;
+constexpr uint32_t kHistorySlotMs = 60000;  // 0 = one record per dwell (~2 MB/day, hours of history)
+
+// Wi-Fi/BLE time-slicing (only with BANDWATCH_BLE, see Ble_Slice.h). After every
+// kWifiDwellsPerBleSlice Wi-Fi dwells the radio is handed to a BLE scan for
+// kBleSliceDwells dwell periods; 4:1 gives BLE 20% of the airtime.
+constexpr bool kBleSlicing = BANDWATCH_BLE;
+constexpr uint8_t kWifiDwellsPerBleSlice = 4;
+constexpr uint8_t kBleSliceDwells = 1;
+constexpr uint32_t kBleMinFreeHeap = 48 * 1024;  // BLE is dropped if its init leaves less than this
+constexpr uint32_t kRadioReportMs = 10000;       // Per-slice airtime/yield report on serial
+
+// Multi-node mode (only with BANDWATCH_MESH, see Mesh_Link.h): boards split the channels
+// between them and meet on kMeshSyncChannel for one dwell in every kMeshSyncEvery.
+constexpr bool kMesh = BANDWATCH_MESH;
+constexpr uint8_t kMeshSyncChannel = 1;
+constexpr uint32_t kMeshAlignToleranceUs = 1000; // Slot clock error that is left alone
+
+// Hop scheduling (see Hop_Scheduler.h). Weighted mode gives busy or rapidly changing
+// channels more visits; quiet channels are still revisited at least every kWeightedRevisitMs.
+constexpr HopMode kDefaultHopMode = HopMode::Weighted;
+constexpr uint16_t kHopBaseWeight = 8;      // Floor weight so quiet channels keep some share
+constexpr uint16_t kHopMaxWeight = 200;     // Weight for channels with no data yet
+constexpr uint16_t kHopStdDevGain = 2;      // Weight per point of busy-score std deviation
+// Forced revisits need (quiet channels × dwell / revisit) of all hops, so these must
+// stay well under the 1-in-(spacing+1) budget: 10 × 260 ms / 8 s ≈ 33% < 50%.
+constexpr uint32_t kWeightedRevisitMs = 8000;
+constexpr uint32_t kFocusRevisitMs = 12000; // Focus mode: top 3 only, others at this rate
+constexpr uint8_t kForcedRevisitSpacing = 1;
+
+// Top talkers (see Top_Talkers.h): counters over full transmitter MACs, halved every
+// kTalkerWindowMs so the list follows the last minute or so of traffic. 32 counters
+// are 0.8 KB. The BOOT button (or 't' on serial) steps to the next screen.
+constexpr uint8_t kTopTalkerCounters = 32;
+constexpr uint8_t kTopTalkerRows = 8;          // Listed on screen
+constexpr int kScreenButtonPin = 9;            // BOOT button, active low
+
+// Waterfall screen: one row per full sweep, newest on top, 13 columns coloured by
+// smoothed busy score. The panel scrolls it in hardware (LCD_ScrollPushRows), so each
+// row costs one 172 x kWaterfallRowPx write plus a start-address update.
+constexpr bool kWaterfall = LCD_CAN_SCROLL;
+constexpr uint32_t kWaterfallRowMs = kChannelCount * kDwellMs;
+constexpr uint16_t kWaterfallRowPx = 2;
+constexpr uint16_t kWaterfallTopPx = 34;      // Static header: title and channel axis
+constexpr uint16_t kWaterfallBottomPx = 20;   // Static footer: time scale
+constexpr uint16_t kWaterfallLines = LCD_HEIGHT - kWaterfallTopPx - kWaterfallBottomPx;
+constexpr uint16_t kWaterfallRows = kWaterfallLines / kWaterfallRowPx;  // 133 rows, ~7.5 min
+constexpr int kWaterfallColPx = LCD_WIDTH / kChannelCount;              // 13 px, last one a gap
+constexpr uint8_t kWaterfallNoData = 0xFF;
+static_assert(kWaterfallLines % kWaterfallRowPx == 0, "rows tile the scroll region");
+
+// Busy score (see ScoreMode in bandwatch.h); 'A' on serial switches between them.
+constexpr ScoreMode kDefaultScoreMode = ScoreMode::Blend;
+
+// Capture profile (see CaptureProfile in bandwatch.h); 'c' on serial cycles through them.
+constexpr CaptureProfile kDefaultCaptureProfile = CaptureProfile::Full;
+
+// Trace replay (see Trace_Replay.h): 'p' plays the trace in real time, 'P' at this speed.
+constexpr uint16_t kReplaySpeedX = 8;
 
 // Simple RGB565 colors
 inline lv_color_t c565(uint16_t v) {
@@ -46,33 +139,29 @@ constexpr uint16_t CYAN_565    = 0x07FF;
 constexpr uint16_t PURPLE_565  = 0x780F; // violet accent
 constexpr uint16_t YELLOW_565  = 0xFFE0;
 
-struct RgbColor { uint8_t r; uint8_t g; uint8_t b; };
-constexpr RgbColor LED_GREEN  = {0, 180, 40};
-constexpr RgbColor LED_YELLOW = {255, 200, 0};
-constexpr RgbColor LED_ORANGE = {255, 120, 0};
-constexpr RgbColor LED_RED    = {255, 24, 0};
+constexpr Led_Color LED_GREEN  = {0, 180, 40};
+constexpr Led_Color LED_YELLOW = {255, 200, 0};
+constexpr Led_Color LED_ORANGE = {255, 120, 0};
+constexpr Led_Color LED_RED    = {255, 24, 0};
+constexpr Led_Color LED_OFF    = {0, 0, 0};
 
-struct Accum {
-    uint32_t frames = 0;
-    uint32_t bytes = 0;
-    uint16_t strong = 0;
-    uint16_t unique = 0;
-    uint16_t macHashes[kUniqueSlots] = {0};
-    uint8_t macFill = 0;
+using ChannelSketch = HllSketch<kChannelSketchBits>;
+using TalkerTable = TopTalkers<kTopTalkerCounters>;
+
+// Transmitters seen on one channel. Estimates merge both generations, so they
+// cover the last one to two kTalkerWindowMs windows without dropping to zero.
+struct ChannelTalkers {
+    ChannelSketch gen[2];
 };
 
-struct ChannelMetrics {
+// Per-channel totals for the history slot in progress.
+struct HistorySlot {
+    uint16_t dwells = 0;
     uint32_t frames = 0;
     uint32_t bytes = 0;
-    uint16_t strong = 0;
-    uint16_t unique = 0;
-};
-
-struct ChannelState {
-    ChannelMetrics metrics;
-    float busyCurrent = 0.0f;  // Last dwell busy score (0–100)
-    float busyEma = 0.0f;      // Smoothed busy score (0–100)
-    bool hasData = false;
+    uint32_t strong = 0;
+    uint16_t uniqueMax = 0;
+    uint32_t scoreSum = 0;
 };
 
 // IEEE 802.11 header (truncated – enough to read transmitter address)
@@ -91,95 +180,562 @@ typedef struct {
     uint8_t payload[0];
 } wifi_ieee80211_packet_t;
 
-volatile Accum g_accum;
-portMUX_TYPE g_accumMux = portMUX_INITIALIZER_UNLOCKED;
+// Posted by the hop timer when a dwell ends; the aggregator finalizes it once all
+// frames captured during that dwell have been drained from the ring.
+struct DwellClose {
+    uint8_t epoch;         // Epoch of the dwell that just ended
+    uint8_t channel;       // Channel it was measured on
+    uint32_t durationUs;   // Measured dwell length
+    uint32_t ctrlFrames;   // Control frames tallied during it
+};
 
-ChannelState channels[kChannelCount];
+SpscRing<FrameRecord, kCaptureRingSize> g_captureRing;
+SpscRing<DwellClose, 4> g_dwellCloses;
+volatile uint8_t g_captureEpoch = 0;  // Bumped on every hop; stale records are discarded
+volatile uint32_t g_ctrlFrames = 0;   // Control frames seen (Wi-Fi task only writes)
+volatile CaptureProfile g_captureProfile = kDefaultCaptureProfile;
+volatile bool g_replayActive = false;  // Trace replay owns the ring; live frames are ignored
+volatile uint32_t g_hopSlipMaxUs = 0;  // Worst |dwell length - kDwellMs| since the replay last asked
+TaskHandle_t g_aggregatorTask = nullptr;
+esp_timer_handle_t g_hopTimer = nullptr;
+
+// Hop timer state (esp_timer task only).
 int currentChannel = 1;
-uint32_t dwellStartedMs = 0;
+int64_t dwellStartedUs = 0;
+uint32_t ctrlAtDwellStart = 0;
+HopScheduler<kChannelCount> hopScheduler;
+uint8_t wifiDwellsSinceBle = 0;
+uint8_t bleDwellsLeft = 0;
+volatile bool g_bleSliceActive = false;  // Radio belongs to BLE; the RX callback ignores frames
+uint32_t hopSlot = 0;          // Number of the dwell slot in progress (the coordinator's, in a mesh)
+int scheduledChannel = 1;      // Last scheduler pick; sync slots do not move it
+bool hopRealigned = false;     // The timer was re-armed one-shot onto the coordinator's clock
+
+// Multi-node state. g_meshMask is this node's share of the channels (0 = all); the
+// mesh task hands slot alignments to the hop timer under g_meshAlignMux.
+volatile uint16_t g_meshMask = 0;
+portMUX_TYPE g_meshAlignMux = portMUX_INITIALIZER_UNLOCKED;
+bool g_meshAlignPending = false;
+uint32_t g_meshAlignSlot = 0;
+int64_t g_meshAlignStartUs = 0;
+SpscRing<MeshDwell, 32> g_remoteDwells;  // Mesh task -> aggregator
+
+// Scheduler inputs, published by the aggregator after every dwell. Plain 16-bit
+// stores, so the hop timer reads them without a lock.
+volatile uint16_t g_hopWeights[kChannelCount];
+volatile uint16_t g_focusMask = 0;
+volatile HopMode g_hopMode = kDefaultHopMode;
+volatile ScoreMode g_scoreMode = kDefaultScoreMode;
+
+// Aggregator-private state: only bw_aggregate touches these, so no lock is needed.
+DwellAccum g_accum;
+uint8_t accumEpoch = 0;
+ChannelTalkers channelTalkers[kChannelCount];
+uint8_t talkerGen = 0;
+uint32_t talkerWindowStartedMs = 0;
+TalkerTable g_topTalkers;
+HistorySlot historySlots[kChannelCount];
+uint32_t historySlotStartedMs = 0;
+uint32_t wifiAirUs = 0;       // Wi-Fi dwell time and frames, for the radio slice report
+uint32_t wifiAirFrames = 0;
+
+// Published results. The aggregator writes and the UI snapshots under g_accumMux;
+// the RX callback and hop timer never touch this lock.
+portMUX_TYPE g_accumMux = portMUX_INITIALIZER_UNLOCKED;
+Stats_Timer g_accumHoldStats;   // Hold time of g_accumMux; only updated while holding it
+Stats_Timer g_promiscStats;     // promiscuousCb; the Wi-Fi task is its only writer
+ChannelState channels[kChannelCount];
+uint16_t allTalkerEstimate = 0;
+TalkerTable::Entry topTalkerView[kTopTalkerRows];
+uint8_t topTalkerViewCount = 0;
 
 lv_obj_t* root = nullptr;
 lv_obj_t* titleLabel = nullptr;
 lv_obj_t* globalBar = nullptr;
-lv_obj_t* globalLabel = nullptr;
 lv_obj_t* methodLabel = nullptr;
+HopMode shownHopMode = kDefaultHopMode;
+ScoreMode shownScoreMode = kDefaultScoreMode;
 lv_obj_t* topRows[3] = {nullptr};
 lv_obj_t* stripBars[3] = {nullptr};
-lv_obj_t* apLabel = nullptr;
 uint16_t lastApSeen = 0;
-uint16_t apMaxWindow = 0;
 uint32_t apWindowStartedMs = 0;
+volatile bool g_uiPaused = false;  // Replay benchmark without UI refreshes
 
-Adafruit_NeoPixel rgb(kRgbCount, kRgbPin, kNeoPixelType);
+// Change-only update handles for the widgets refreshUi() touches every tick.
+Ui_Widget globalBarUi;
+Ui_Widget topRowUi[3];
+Ui_Widget stripBarUi[3];
 
-inline void setLedColor(const RgbColor& c, uint8_t brightness = 60) {
-    if (!HAVE_NEOPIXEL) return;
-    const uint16_t scale = static_cast<uint16_t>(brightness) * 255 / 100;
-    const uint8_t r = static_cast<uint8_t>((static_cast<uint16_t>(c.r) * scale) / 255);
-    const uint8_t g = static_cast<uint8_t>((static_cast<uint16_t>(c.g) * scale) / 255);
-    const uint8_t b = static_cast<uint8_t>((static_cast<uint16_t>(c.b) * scale) / 255);
-    rgb.setPixelColor(0, rgb.Color(r, g, b));
-    rgb.show();
-}
+// The two numbers that change most often are drawn from glyph sprites (UI_Digits.h).
+Ui_DigitFont globalDigitFont;
+Ui_DigitFont apDigitFont;
+Ui_Digits globalDigits;
+Ui_Digits apDigits;
+
+// Top-talkers screen; its rows only refresh while it is shown.
+lv_obj_t* mainScreen = nullptr;
+lv_obj_t* talkersScreen = nullptr;
+lv_obj_t* talkerMacLabels[kTopTalkerRows] = {nullptr};
+lv_obj_t* talkerInfoLabels[kTopTalkerRows] = {nullptr};
+Ui_Widget talkerMacUi[kTopTalkerRows];
+Ui_Widget talkerInfoUi[kTopTalkerRows];
+bool screenButtonDown = false;
+volatile bool g_screenToggleRequested = false;  // Set by 't' on serial, applied in the UI timer
+
+// Waterfall screen. LVGL draws the header and footer; the rows between them are
+// written straight to the panel. History is kept while other screens are shown.
+enum class UiScreen : uint8_t { Main, Talkers, Waterfall };
+UiScreen shownScreen = UiScreen::Main;
+lv_obj_t* waterfallScreen = nullptr;
+uint8_t waterfallHistory[kWaterfallRows][kChannelCount];  // Busy points; newest at waterfallHead
+uint16_t waterfallHead = 0;
+uint16_t waterfallCount = 0;
+uint32_t waterfallRowAtMs = 0;
+uint16_t waterfallHeat[101];                              // Busy points -> panel pixel
+uint16_t waterfallPixels[LCD_WIDTH * kWaterfallRowPx];    // One row; sent blocking, then reused
+
+uint8_t ledSelfTestStep = 0;  // 0 = idle/finished, 1..3 = colour shown, 4 = clear
 
-inline float clamp01(float v) {
-    if (v < 0.0f) return 0.0f;
-    if (v > 1.0f) return 1.0f;
-    return v;
+// Level is percent; the driver only transmits when the resulting colour changes.
+inline void setLedColor(const Led_Color& c, uint8_t brightness = 60) {
+    Led_Steady(c, brightness);
 }
 
-inline uint16_t macHash(const uint8_t* mac) {
-    // Lightweight hash using last two bytes to avoid heavy math in ISR.
-    return (static_cast<uint16_t>(mac[4]) << 8) | mac[5];
+// Hands one frame to the aggregator; shared by the RX callback and trace replay.
+inline void IRAM_ATTR queueFrame(FrameRecord& rec) {
+    rec.epoch = g_captureEpoch;
+    g_captureRing.push(rec);  // Counted as dropped when the aggregator falls behind
 }
 
-void IRAM_ATTR promiscuousCb(void* buf, wifi_promiscuous_pkt_type_t type) {
+inline void IRAM_ATTR handlePromiscuous(void* buf, wifi_promiscuous_pkt_type_t type) {
+    if (kBleSlicing && g_bleSliceActive) return;  // Coex leftovers from a BLE slice are not a dwell
+    if (g_replayActive) return;
     if (type != WIFI_PKT_MGMT && type != WIFI_PKT_DATA && type != WIFI_PKT_CTRL) return;
     const wifi_promiscuous_pkt_t* pkt = reinterpret_cast<const wifi_promiscuous_pkt_t*>(buf);
+    if (type == WIFI_PKT_CTRL) {
+        // Tallied only: ACK/CTS/RTS are shorter than a full MAC header and carry no
+        // transmitter worth counting. Only Full queues the long ones (BA/BAR).
+        g_ctrlFrames = g_ctrlFrames + 1;
+        if (g_captureProfile != CaptureProfile::Full) return;
+    }
     if (pkt->rx_ctrl.sig_len < sizeof(wifi_ieee80211_mac_hdr_t)) return; // malformed
     const wifi_ieee80211_packet_t* ipkt = reinterpret_cast<const wifi_ieee80211_packet_t*>(pkt->payload);
 
-    portENTER_CRITICAL_ISR(&g_accumMux);
-    g_accum.frames += 1;
-    g_accum.bytes += pkt->rx_ctrl.sig_len;
-    if (pkt->rx_ctrl.rssi >= kStrongThresholdDbm) {
-        g_accum.strong += 1;
-    }
-
-    if (ipkt) {
-        const uint8_t* src = ipkt->hdr.addr2;  // Best-effort transmitter
-        const uint16_t h = macHash(src);
-        bool known = false;
-        for (uint8_t i = 0; i < g_accum.macFill; i++) {
-            if (g_accum.macHashes[i] == h) {
-                known = true;
-                break;
-            }
-        }
-        if (!known && g_accum.macFill < kUniqueSlots) {
-            g_accum.macHashes[g_accum.macFill++] = h;
-            g_accum.unique += 1;
-        }
+    // Copy only what the aggregator needs; no locks, no scans on the RX path.
+    FrameRecord rec;
+    rec.len = static_cast<uint16_t>(pkt->rx_ctrl.sig_len);
+    rec.rssi = static_cast<int8_t>(pkt->rx_ctrl.rssi);
+    rec.type = static_cast<uint8_t>(type);
+    memcpy(rec.ta, ipkt->hdr.addr2, sizeof(rec.ta));  // Best-effort transmitter
+    rec.rate = airtimeRateIndex(pkt->rx_ctrl.cur_bb_format, pkt->rx_ctrl.rate, pkt->rx_ctrl.he_siga1);
+    queueFrame(rec);
+    if (kPcapLog) PcapLogger_Capture(pkt);
+}
+
+void IRAM_ATTR promiscuousCb(void* buf, wifi_promiscuous_pkt_type_t type) {
+    const uint32_t start = Stats_Cycles();
+    handlePromiscuous(buf, type);
+    Stats_TimerAdd(&g_promiscStats, start);
+}
+
+inline uint16_t saturate16(uint32_t v) {
+    return static_cast<uint16_t>(v > 0xFFFF ? 0xFFFF : v);
+}
+
+void rotateTalkerWindow(uint32_t nowMs) {
+    if (talkerWindowStartedMs == 0) talkerWindowStartedMs = nowMs;
+    if ((nowMs - talkerWindowStartedMs) < kTalkerWindowMs) return;
+    talkerWindowStartedMs = nowMs;
+    talkerGen ^= 1;
+    for (int i = 0; i < kChannelCount; i++) {
+        channelTalkers[i].gen[talkerGen].clear();
+    }
+    g_topTalkers.decay();
+}
+
+uint32_t estimateTalkers(const ChannelTalkers& t) {
+    ChannelSketch u = t.gen[0];
+    u.merge(t.gen[1]);
+    return u.estimate();
+}
+
+uint32_t estimateAllTalkers() {
+    ChannelSketch u;
+    for (int i = 0; i < kChannelCount; i++) {
+        u.merge(channelTalkers[i].gen[0]);
+        u.merge(channelTalkers[i].gen[1]);
+    }
+    return u.estimate();
+}
+
+// Folds one finished dwell into the current history slot and hands the slot to
+// Metric_History once it is complete (queued only; flash writes happen elsewhere).
+void recordHistory(int idx, const ChannelMetrics& m, uint16_t score, uint32_t nowMs) {
+    HistorySlot& slot = historySlots[idx];
+    slot.dwells++;
+    slot.frames += m.frames;
+    slot.bytes += m.bytes;
+    slot.strong += m.strong;
+    if (m.unique > slot.uniqueMax) slot.uniqueMax = m.unique;
+    slot.scoreSum += score;
+    if ((nowMs - historySlotStartedMs) < kHistorySlotMs) return;
+
+    for (int i = 0; i < kChannelCount; i++) {
+        HistorySlot& s = historySlots[i];
+        if (s.dwells == 0) continue;
+        HistoryRecord r{};
+        r.timeMs = nowMs;
+        r.channel = static_cast<uint8_t>(i + 1);
+        r.dwells = s.dwells;
+        r.frames = s.frames;
+        r.bytes = s.bytes;
+        r.strong = s.strong;
+        r.unique = s.uniqueMax;
+        r.scoreQ8 = static_cast<uint16_t>(s.scoreSum / s.dwells);
+        History_Append(r);
+        s = HistorySlot{};
     }
-    portEXIT_CRITICAL_ISR(&g_accumMux);
+    historySlotStartedMs = nowMs;
 }
 
-void resetAccum() {
+// Publishes a finished dwell on channel idx and updates hop weights and history.
+// local is the close notice for dwells measured here; remote dwells (nullptr) carry
+// no control-frame count and leave the all-channel and top-talker views alone.
+void publishDwell(int idx, const ChannelMetrics& snap, uint16_t talkers, const DwellClose* local) {
+    const uint16_t airtime = computeAirtimeScoreQ8(snap, kDwellMs * 1000);
+    const uint16_t score = (g_scoreMode == ScoreMode::Airtime) ? airtime : computeBusyScoreQ8(snap, kDwellMs * 1000);
+    uint16_t allTalkers = 0;
+    TalkerTable::Entry topTalkers[kTopTalkerRows];
+    uint8_t topTalkerCount = 0;
+    if (local) {
+        allTalkers = saturate16(estimateAllTalkers());
+        g_topTalkers.assignChannel(local->epoch, local->channel);
+        topTalkerCount = g_topTalkers.top(topTalkers, kTopTalkerRows);
+    }
+
     portENTER_CRITICAL(&g_accumMux);
-    g_accum.frames = 0;
-    g_accum.bytes = 0;
-    g_accum.strong = 0;
-    g_accum.unique = 0;
-    g_accum.macFill = 0;
-    for (int i = 0; i < kUniqueSlots; i++) {
-        g_accum.macHashes[i] = 0;
+    const uint32_t heldFrom = Stats_Cycles();
+    ChannelState& ch = channels[idx];
+    ch.applyDwell(snap, score, kBusyEmaAlphaQ16);
+    ch.talkerEstimate = talkers;
+    ch.airtimeQ8 = airtime;
+    const uint32_t weight = kHopBaseWeight + busyScorePoints(ch.busyEma) +
+                            kHopStdDevGain * busyScorePoints(busyStdDevQ8(ch.busyVar));
+    if (local) {
+        ch.ctrlFrames = saturate16(local->ctrlFrames);
+        allTalkerEstimate = allTalkers;
+        memcpy(topTalkerView, topTalkers, sizeof(topTalkers[0]) * topTalkerCount);
+        topTalkerViewCount = topTalkerCount;
     }
+    Stats_TimerAdd(&g_accumHoldStats, heldFrom);
     portEXIT_CRITICAL(&g_accumMux);
+
+    // Only the aggregator writes channels[], so reading it here without the lock is safe.
+    int top[3];
+    sortTop3(channels, kChannelCount, top);
+    uint16_t focus = 0;
+    for (int i = 0; i < 3; i++) {
+        if (top[i] >= 0) focus |= static_cast<uint16_t>(1u << top[i]);
+    }
+    g_hopWeights[idx] = static_cast<uint16_t>(weight > kHopMaxWeight ? kHopMaxWeight : weight);
+    g_focusMask = focus;
+
+    if (kHistoryLog) recordHistory(idx, snap, score, millis());
+}
+
+// Runs on the aggregator once every frame of the closed dwell has been applied.
+void finishDwell(const DwellClose& close) {
+    const ChannelMetrics snap = g_accum.snapshot(close.durationUs);
+
+    const int idx = close.channel - 1;
+    rotateTalkerWindow(millis());
+    static_assert(kDwellSketchBits == kChannelSketchBits, "dwell sketch merges into channel sketch");
+    channelTalkers[idx].gen[talkerGen].merge(g_accum.talkers);
+    const uint16_t talkers = saturate16(estimateTalkers(channelTalkers[idx]));
+    publishDwell(idx, snap, talkers, &close);
+    wifiAirUs += close.durationUs;
+    wifiAirFrames += snap.frames;
+
+    if (kMesh) {
+        MeshDwell d{};
+        d.frames = snap.frames;
+        d.bytes = snap.bytes;
+        d.dwellUs = snap.dwellUs;
+        d.strong = snap.strong;
+        d.unique = snap.unique;
+        d.channel = close.channel;
+        d.talkers = talkers;
+        d.airtimeUs = snap.airtimeUs;
+        MeshLink_PostDwell(d);  // Dropped there unless this node owns the channel
+    }
+}
+
+// A dwell another node measured on one of its channels.
+void finishRemoteDwell(const MeshDwell& d) {
+    if (d.channel < 1 || d.channel > kChannelCount) return;
+    ChannelMetrics m{};
+    m.frames = d.frames;
+    m.bytes = d.bytes;
+    m.strong = d.strong;
+    m.unique = d.unique;
+    m.dwellUs = d.dwellUs;
+    m.airtimeUs = d.airtimeUs;
+    publishDwell(d.channel - 1, m, d.talkers, nullptr);
+}
+
+void closeDwell(const DwellClose& close) {
+    if (close.epoch == accumEpoch) finishDwell(close);
+    g_accum.clear();
+    accumEpoch = static_cast<uint8_t>(close.epoch + 1);
+}
+
+// Airtime split and yield per airtime-second of each radio, since the last report.
+void reportRadioSlices() {
+    static uint32_t lastWifiUs = 0, lastWifiFrames = 0, lastBleUs = 0, lastAdverts = 0;
+    BleSliceStats ble;
+    BleSlice_TakeStats(&ble);
+    const uint32_t wifiUs = wifiAirUs - lastWifiUs;
+    const uint32_t frames = wifiAirFrames - lastWifiFrames;
+    const uint32_t bleUs = ble.scanUs - lastBleUs;
+    const uint32_t adverts = ble.adverts - lastAdverts;
+    lastWifiUs = wifiAirUs;
+    lastWifiFrames = wifiAirFrames;
+    lastBleUs = ble.scanUs;
+    lastAdverts = ble.adverts;
+    if (!ble.ready) return;
+
+    const uint32_t totalMs = (wifiUs + bleUs) / 1000;
+    const uint32_t wifiMs = wifiUs / 1000;
+    const uint32_t bleMs = bleUs / 1000;
+    printf("radio: wifi %lu%% %lu fr/s | ble %lu%% %lu adv/s, ~%u devices\r\n",
+           static_cast<unsigned long>(totalMs ? wifiMs * 100 / totalMs : 0),
+           static_cast<unsigned long>(wifiMs ? static_cast<uint64_t>(frames) * 1000 / wifiMs : 0),
+           static_cast<unsigned long>(totalMs ? bleMs * 100 / totalMs : 0),
+           static_cast<unsigned long>(bleMs ? static_cast<uint64_t>(adverts) * 1000 / bleMs : 0),
+           ble.uniqueDevices);
+}
+
+void aggregatorTask(void* param) {
+    (void)param;
+    uint32_t reportedDrops = 0;
+    uint32_t lastReportMs = 0;
+    uint32_t lastRadioReportMs = millis();
+
+    while (true) {
+        // Woken immediately by the hop timer, otherwise drains on a short period.
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(kAggregatePeriodMs));
+
+        FrameRecord rec;
+        DwellClose close;
+        while (g_captureRing.pop(rec)) {
+            // Records arrive in capture order, so a newer epoch means the hop timer
+            // has already ended the dwell we are accumulating.
+            while (static_cast<int8_t>(rec.epoch - accumEpoch) > 0) {
+                if (g_dwellCloses.pop(close)) {
+                    closeDwell(close);
+                } else {
+                    g_accum.clear();  // Close notice lost; discard the partial dwell
+                    accumEpoch = rec.epoch;
+                }
+            }
+            if (rec.epoch == accumEpoch) {
+                g_accum.add(rec, kStrongThresholdDbm);
+                g_topTalkers.add(rec.ta, rec.len, rec.epoch);
+            }
+        }
+        while (g_dwellCloses.pop(close)) closeDwell(close);
+        if (kMesh) {
+            MeshDwell remote;
+            while (g_remoteDwells.pop(remote)) finishRemoteDwell(remote);
+        }
+
+        const uint32_t drops = g_captureRing.dropped();
+        const uint32_t nowMs = millis();
+        if (drops != reportedDrops && (nowMs - lastReportMs) >= kDropReportMs) {
+            printf("bandwatch: capture ring overflow, %lu records dropped (+%lu)\r\n",
+                   static_cast<unsigned long>(drops), static_cast<unsigned long>(drops - reportedDrops));
+            reportedDrops = drops;
+            lastReportMs = nowMs;
+        }
+        if (kBleSlicing && (nowMs - lastRadioReportMs) >= kRadioReportMs) {
+            reportRadioSlices();
+            lastRadioReportMs = nowMs;
+        }
+    }
 }
 
 void applyChannel(int ch) {
     esp_wifi_set_channel(ch, WIFI_SECOND_CHAN_NONE);
-    dwellStartedMs = millis();
+    // Frames still queued in the ring were captured on the previous channel.
+    g_captureEpoch = static_cast<uint8_t>(g_captureEpoch + 1);
+    dwellStartedUs = esp_timer_get_time();
+    ctrlAtDwellStart = g_ctrlFrames;
+}
+
+// Hardware filter masks for a profile; frames outside them never reach promiscuousCb.
+void applyCaptureProfile(CaptureProfile profile) {
+    wifi_promiscuous_filter_t filt{};
+    wifi_promiscuous_filter_t ctrl{};
+    switch (profile) {
+        case CaptureProfile::Counting:
+            filt.filter_mask = WIFI_PROMIS_FILTER_MASK_MGMT | WIFI_PROMIS_FILTER_MASK_DATA | WIFI_PROMIS_FILTER_MASK_CTRL;
+            ctrl.filter_mask = WIFI_PROMIS_CTRL_FILTER_MASK_RTS | WIFI_PROMIS_CTRL_FILTER_MASK_CTS;
+            break;
+        case CaptureProfile::Discovery:
+            filt.filter_mask = WIFI_PROMIS_FILTER_MASK_MGMT;
+            break;
+        case CaptureProfile::Full:
+        default:
+            filt.filter_mask = WIFI_PROMIS_FILTER_MASK_MGMT | WIFI_PROMIS_FILTER_MASK_DATA | WIFI_PROMIS_FILTER_MASK_CTRL;
+            ctrl.filter_mask = WIFI_PROMIS_CTRL_FILTER_MASK_ALL;
+            break;
+    }
+    g_captureProfile = profile;
+    esp_wifi_set_promiscuous_filter(&filt);
+    if (filt.filter_mask & WIFI_PROMIS_FILTER_MASK_CTRL) esp_wifi_set_promiscuous_ctrl_filter(&ctrl);
+}
+
+const char* captureProfileName(CaptureProfile profile) {
+    switch (profile) {
+        case CaptureProfile::Counting: return "counting";
+        case CaptureProfile::Discovery: return "discovery";
+        default: return "full";
+    }
+}
+
+// Steers the coexistence arbiter towards whichever radio owns the current slice.
+void preferRadio(bool ble) {
+#if BANDWATCH_COEX_PREFERENCE
+    esp_coex_preference_set(ble ? ESP_COEX_PREFER_BT : ESP_COEX_PREFER_WIFI);
+#else
+    (void)ble;
+#endif
+}
+
+// Multi-node: takes the coordinator's slot clock from the latest beacon. Called at a
+// local boundary; when that is off by more than kMeshAlignToleranceUs the timer is
+// re-armed once onto the coordinator's next boundary, folding a short remainder into
+// the following slot rather than making a sliver of a dwell.
+void alignHopSlot(int64_t nowUs) {
+    portENTER_CRITICAL(&g_meshAlignMux);
+    const bool pending = g_meshAlignPending;
+    const uint32_t slot = g_meshAlignSlot;
+    const int64_t startUs = g_meshAlignStartUs;
+    g_meshAlignPending = false;
+    portEXIT_CRITICAL(&g_meshAlignMux);
+    if (!pending || nowUs < startUs) return;
+
+    const int64_t dwellUs = static_cast<int64_t>(kDwellMs) * 1000;
+    const int64_t k = (nowUs - startUs) / dwellUs;       // Coordinator slot now in progress: slot + k
+    int64_t leftUs = startUs + (k + 1) * dwellUs - nowUs; // Until it ends
+    hopSlot = slot + static_cast<uint32_t>(k);
+    if (dwellUs - leftUs <= kMeshAlignToleranceUs) return;  // Just past its start: aligned
+    if (leftUs <= kMeshAlignToleranceUs) {                  // Just before the next one
+        hopSlot++;
+        return;
+    }
+    if (leftUs < dwellUs / 4) {
+        hopSlot++;
+        leftUs += dwellUs;
+    }
+    esp_timer_stop(g_hopTimer);
+    esp_timer_start_once(g_hopTimer, static_cast<uint64_t>(leftUs));
+    hopRealigned = true;
+}
+
+// True when a BLE slice started in this slot would cover a sync slot.
+bool bleSliceHitsSync(uint32_t slot) {
+    for (uint8_t i = 0; i < kBleSliceDwells; i++) {
+        if (meshIsSyncSlot(slot + i)) return true;
+    }
+    return false;
+}
+
+// Runs on the esp_timer task at exact dwell boundaries, independent of LVGL.
+void hopTimerCb(void* arg) {
+    (void)arg;
+    const int64_t nowUs = esp_timer_get_time();
+    if (hopRealigned) {
+        hopRealigned = false;  // Back on a boundary: resume the periodic tick from here
+        esp_timer_start_periodic(g_hopTimer, static_cast<uint64_t>(kDwellMs) * 1000);
+    }
+    hopSlot++;
+    if (kMesh) alignHopSlot(nowUs);
+    const bool syncSlot = kMesh && meshIsSyncSlot(hopSlot);
+
+    if (kBleSlicing && g_bleSliceActive) {
+        if (--bleDwellsLeft > 0) return;
+        // BLE window over: the channel picked when it began gets a fresh dwell.
+        BleSlice_End();
+        preferRadio(false);
+        g_bleSliceActive = false;
+        if (syncSlot) currentChannel = kMeshSyncChannel;
+        applyChannel(currentChannel);
+        if (syncSlot) MeshLink_SyncSlot(hopSlot, nowUs);
+        return;
+    }
+
+    DwellClose close;
+    close.epoch = g_captureEpoch;
+    close.channel = static_cast<uint8_t>(currentChannel);
+    close.durationUs = static_cast<uint32_t>(nowUs - dwellStartedUs);
+    close.ctrlFrames = g_ctrlFrames - ctrlAtDwellStart;
+    const uint32_t dwellUs = kDwellMs * 1000;
+    const uint32_t slipUs = (close.durationUs > dwellUs) ? close.durationUs - dwellUs : dwellUs - close.durationUs;
+    if (slipUs > g_hopSlipMaxUs) g_hopSlipMaxUs = slipUs;
+
+    uint16_t weights[kChannelCount];
+    for (int i = 0; i < kChannelCount; i++) weights[i] = g_hopWeights[i];
+    const HopMode mode = g_hopMode;
+    const uint32_t revisitMs = (mode == HopMode::Focus) ? kFocusRevisitMs : kWeightedRevisitMs;
+    if (syncSlot) {
+        currentChannel = kMeshSyncChannel;
+    } else {
+        scheduledChannel = 1 + hopScheduler.next(mode, scheduledChannel - 1, millis(), weights, g_focusMask,
+                                                 revisitMs, kForcedRevisitSpacing, g_meshMask);
+        currentChannel = scheduledChannel;
+    }
+    if (kBleSlicing && BleSlice_Ready() && ++wifiDwellsSinceBle >= kWifiDwellsPerBleSlice &&
+        !(kMesh && bleSliceHitsSync(hopSlot))) {
+        // Frames still tagged with the closed epoch are discarded by the aggregator.
+        wifiDwellsSinceBle = 0;
+        bleDwellsLeft = kBleSliceDwells;
+        g_bleSliceActive = true;
+        preferRadio(true);
+        BleSlice_Begin();
+    } else {
+        applyChannel(currentChannel);
+        if (syncSlot) MeshLink_SyncSlot(hopSlot, nowUs);
+    }
+
+    g_dwellCloses.push(close);
+    xTaskNotifyGive(g_aggregatorTask);
+}
+
+// Mesh_Link hooks, called on the bw_mesh task.
+void meshSetChannelMask(uint16_t mask) {
+    g_meshMask = mask;  // Read by the hop timer from the next boundary on
+}
+
+void meshAlign(uint32_t slot, int64_t slotStartUs) {
+    portENTER_CRITICAL(&g_meshAlignMux);
+    g_meshAlignPending = true;
+    g_meshAlignSlot = slot;
+    g_meshAlignStartUs = slotStartUs;
+    portEXIT_CRITICAL(&g_meshAlignMux);
+}
+
+void meshRemoteDwell(const MeshDwell& dwell) {
+    g_remoteDwells.push(dwell);  // Counted as dropped when the aggregator falls behind
+}
+
+const char* meshRoleName(MeshRole role) {
+    switch (role) {
+        case MeshRole::Joining: return "joining";
+        case MeshRole::Coordinator: return "coordinator";
+        case MeshRole::Worker: return "worker";
+        default: return "off";
+    }
 }
 
 void ensureWifiMonitor() {
@@ -201,86 +757,93 @@ void ensureWifiMonitor() {
     };
     esp_wifi_set_country(&country);
 
-    wifi_promiscuous_filter_t filt{};
-    filt.filter_mask = WIFI_PROMIS_FILTER_MASK_MGMT | WIFI_PROMIS_FILTER_MASK_DATA | WIFI_PROMIS_FILTER_MASK_CTRL;
-    esp_wifi_set_promiscuous_filter(&filt);
+    // Aggregator must run before frames start landing in the ring.
+    xTaskCreatePinnedToCore(
+        aggregatorTask,
+        "bw_aggregate",
+        3072,
+        nullptr,
+        3,
+        &g_aggregatorTask,
+        0
+    );
+
+    applyCaptureProfile(g_captureProfile);
     esp_wifi_set_promiscuous_rx_cb(promiscuousCb);
     esp_wifi_set_promiscuous(true);
 
+    for (int i = 0; i < kChannelCount; i++) g_hopWeights[i] = kHopMaxWeight;
+    hopScheduler.reset(millis());
     currentChannel = 1;
-    resetAccum();
+    scheduledChannel = 1;
+    accumEpoch = static_cast<uint8_t>(g_captureEpoch + 1);
     applyChannel(currentChannel);
-}
-
-float computeBusyScore(const ChannelMetrics& m) {
-    const float dwellSec = static_cast<float>(kDwellMs) / 1000.0f;
-    const float pps = m.frames / dwellSec;           // packets per second
-    const float bps = m.bytes / dwellSec;            // bytes per second
-    const float strongRatio = (m.frames > 0) ? (static_cast<float>(m.strong) / static_cast<float>(m.frames)) : 0.0f;
 
-    // Log-scaled terms to keep stability across quiet and busy environments.
-    const float ppsScore = clamp01(log1pf(pps) / logf(600.0f));          // ~600 pps -> near 1
-    const float bpsScore = clamp01(log1pf(bps) / logf(50000.0f));        // ~50 KB/s -> near 1
-    const float uniqueScore = clamp01(log1pf(static_cast<float>(m.unique)) / logf(20.0f)); // soft cap ~20 talkers
+    const esp_timer_create_args_t hop_timer_args = {
+        .callback = &hopTimerCb,
+        .name = "bw_hop"
+    };
+    esp_timer_create(&hop_timer_args, &g_hopTimer);
+    esp_timer_start_periodic(g_hopTimer, static_cast<uint64_t>(kDwellMs) * 1000);
+    Boot_Mark("capture started");
 
-    const float raw = 0.40f * ppsScore + 0.30f * bpsScore + 0.20f * strongRatio + 0.10f * uniqueScore;
-    return clamp01(raw) * 100.0f;
+    if (kPcapLog) {
+        PcapLoggerConfig pcap;
+        pcap.headerOnly = kPcapHeaderOnly;
+        pcap.snapLen = kPcapSnapLen;
+        pcap.fileCapBytes = kPcapFileCapBytes;
+        pcap.maxFiles = kPcapMaxFiles;
+        PcapLogger_Start(pcap);  // SD mount happens in the writer task, off the boot path
+    }
+    if (kHistoryLog) History_Start();
+    if (kMesh) {
+        MeshLinkHooks hooks;
+        hooks.setChannelMask = meshSetChannelMask;
+        hooks.align = meshAlign;
+        hooks.remoteDwell = meshRemoteDwell;
+        MeshLinkConfig mesh;
+        mesh.syncChannel = kMeshSyncChannel;
+        mesh.channelCount = kChannelCount;
+        mesh.dwellMs = kDwellMs;
+        MeshLink_Init(hooks, mesh);
+    }
+    // After Wi-Fi is up, so the heap budget check sees what both stacks really leave.
+    if (kBleSlicing) {
+        preferRadio(false);
+        BleSlice_Init(kBleMinFreeHeap);
+    }
 }
 
-void finishDwell() {
-    ChannelMetrics snap{};
+// Consistent copy of the published per-channel state for one UI pass.
+void snapshotChannels(ChannelState out[kChannelCount], uint16_t* outAllTalkers) {
     portENTER_CRITICAL(&g_accumMux);
-    snap.frames = g_accum.frames;
-    snap.bytes = g_accum.bytes;
-    snap.strong = g_accum.strong;
-    snap.unique = g_accum.unique;
+    const uint32_t heldFrom = Stats_Cycles();
+    for (int i = 0; i < kChannelCount; i++) out[i] = channels[i];
+    if (outAllTalkers) *outAllTalkers = allTalkerEstimate;
+    Stats_TimerAdd(&g_accumHoldStats, heldFrom);
     portEXIT_CRITICAL(&g_accumMux);
-
-    ChannelState& ch = channels[currentChannel - 1];
-    ch.metrics = snap;
-    ch.busyCurrent = computeBusyScore(snap);
-    if (!ch.hasData) {
-        ch.busyEma = ch.busyCurrent;
-        ch.hasData = true;
-    } else {
-        ch.busyEma = (1.0f - kBusyEmaAlpha) * ch.busyEma + kBusyEmaAlpha * ch.busyCurrent;
-    }
-}
-
-void hopIfNeeded() {
-    const uint32_t now = millis();
-    if ((now - dwellStartedMs) < kDwellMs) return;
-
-    finishDwell();
-    resetAccum();
-
-    currentChannel += 1;
-    if (currentChannel > kChannelCount) currentChannel = 1;
-    applyChannel(currentChannel);
 }
 
-float globalActivityMax() {
-    float maxVal = 0.0f;
+uint16_t globalActivityMax(const ChannelState chans[kChannelCount]) {
+    uint16_t maxVal = 0;
     for (int i = 0; i < kChannelCount; i++) {
-        if (channels[i].hasData && channels[i].busyEma > maxVal) {
-            maxVal = channels[i].busyEma;
+        if (chans[i].hasData && chans[i].busyEma > maxVal) {
+            maxVal = chans[i].busyEma;
         }
     }
     return maxVal;
 }
 
-void sortTop3(int outIdx[3]) {
-    for (int i = 0; i < 3; i++) outIdx[i] = -1;
-    for (int i = 0; i < kChannelCount; i++) {
-        if (!channels[i].hasData) continue;
-        for (int pos = 0; pos < 3; pos++) {
-            if (outIdx[pos] == -1 || channels[i].busyEma > channels[outIdx[pos]].busyEma) {
-                for (int shift = 2; shift > pos; shift--) outIdx[shift] = outIdx[shift - 1];
-                outIdx[pos] = i;
-                break;
-            }
-        }
+// Header text: global method ("max", "air" when scoring airtime) plus the active hop
+// scheduling mode.
+const char* methodText(HopMode mode, ScoreMode score) {
+    const bool air = (score == ScoreMode::Airtime);
+    switch (mode) {
+        case HopMode::RoundRobin: return air ? "air rr" : "max rr";
+        case HopMode::Weighted: return air ? "air wrr" : "max wrr";
+        case HopMode::Focus: return air ? "air top3" : "max top3";
     }
+    return air ? "air" : "max";
 }
 
 lv_obj_t* make_label(lv_obj_t* parent, const char* txt, lv_color_t color, bool mono=false) {
@@ -310,7 +873,7 @@ void buildUi() {
     titleLabel = make_label(header, "Bandwatch", c565(WHITE_565), true);
     lv_obj_align(titleLabel, LV_ALIGN_LEFT_MID, 4, 0);
 
-    methodLabel = make_label(header, "max", c565(CYAN_565));
+    methodLabel = make_label(header, methodText(shownHopMode, shownScoreMode), c565(CYAN_565));
     lv_obj_align(methodLabel, LV_ALIGN_RIGHT_MID, -2, 0);
 
     // Global activity bar (taller to fill vertical space)
@@ -322,8 +885,10 @@ void buildUi() {
     lv_obj_set_style_pad_all(globalWrap, 10, 0);
     lv_obj_align(globalWrap, LV_ALIGN_TOP_MID, 0, 28);
 
-    globalLabel = make_label(globalWrap, "0", c565(WHITE_565), true);
+    Ui_DigitFontInit(&globalDigitFont, &lv_font_montserrat_14, c565(WHITE_565), c565(PANEL_565), "0123456789", 0);
+    lv_obj_t* globalLabel = Ui_DigitsCreate(&globalDigits, globalWrap, &globalDigitFont, 60, LV_TEXT_ALIGN_CENTER, 0);
     lv_obj_align(globalLabel, LV_ALIGN_TOP_MID, 0, 0);
+    Ui_DigitsSet(&globalDigits, "0");
 
     globalBar = lv_bar_create(globalWrap);
     lv_bar_set_range(globalBar, 0, 100);
@@ -367,98 +932,451 @@ void buildUi() {
     }
 
     // AP count at the bottom
-    apLabel = make_label(root, "APs --", c565(YELLOW_565), true);
-    lv_obj_set_style_text_font(apLabel, &lv_font_montserrat_20, 0);
-    lv_obj_set_width(apLabel, LV_PCT(100));
-    lv_obj_set_style_text_align(apLabel, LV_TEXT_ALIGN_CENTER, 0);
+    Ui_DigitFontInit(&apDigitFont, &lv_font_montserrat_20, c565(YELLOW_565), c565(BG_565), "0123456789APs -", 0);
+    lv_obj_t* apLabel = Ui_DigitsCreate(&apDigits, root, &apDigitFont, LV_PCT(100), LV_TEXT_ALIGN_CENTER, 0);
     lv_obj_align(apLabel, LV_ALIGN_BOTTOM_MID, 0, -14);
+    Ui_DigitsSet(&apDigits, "APs --");
+
+    Ui_Bind(&globalBarUi, globalBar, 0);
+    for (int i = 0; i < 3; i++) {
+        Ui_Bind(&topRowUi[i], topRows[i], 0);
+        Ui_Bind(&stripBarUi[i], stripBars[i], 0);
+    }
+}
+
+// Second screen: heaviest transmitters, MAC on one line and channel/frames/bytes below.
+void buildTalkersUi() {
+    mainScreen = lv_scr_act();
+    talkersScreen = lv_obj_create(nullptr);
+    lv_obj_set_style_bg_color(talkersScreen, c565(BG_565), 0);
+    lv_obj_set_style_pad_all(talkersScreen, 4, 0);
+    lv_obj_set_style_pad_row(talkersScreen, 1, 0);
+    lv_obj_set_flex_flow(talkersScreen, LV_FLEX_FLOW_COLUMN);
+
+    lv_obj_t* title = make_label(talkersScreen, "Top talkers", c565(YELLOW_565), true);
+    lv_obj_set_style_pad_bottom(title, 4, 0);
+    for (int i = 0; i < kTopTalkerRows; i++) {
+        talkerMacLabels[i] = make_label(talkersScreen, "--", c565(WHITE_565), true);
+        talkerInfoLabels[i] = make_label(talkersScreen, "", c565(CYAN_565), true);
+        lv_obj_set_style_pad_bottom(talkerInfoLabels[i], 3, 0);
+        Ui_Bind(&talkerMacUi[i], talkerMacLabels[i], 0);
+        Ui_Bind(&talkerInfoUi[i], talkerInfoLabels[i], 0);
+    }
+}
+
+void refreshTalkers() {
+    TalkerTable::Entry rows[kTopTalkerRows];
+    portENTER_CRITICAL(&g_accumMux);
+    const uint32_t heldFrom = Stats_Cycles();
+    const uint8_t count = topTalkerViewCount;
+    memcpy(rows, topTalkerView, sizeof(rows[0]) * count);
+    Stats_TimerAdd(&g_accumHoldStats, heldFrom);
+    portEXIT_CRITICAL(&g_accumMux);
+
+    char buf[40];
+    for (uint8_t i = 0; i < kTopTalkerRows; i++) {
+        if (i >= count) {
+            Ui_SetText(&talkerMacUi[i], "--");
+            Ui_SetText(&talkerInfoUi[i], "");
+            continue;
+        }
+        const TalkerTable::Entry& e = rows[i];
+        snprintf(buf, sizeof(buf), "%02x:%02x:%02x:%02x:%02x:%02x",
+                 e.mac[0], e.mac[1], e.mac[2], e.mac[3], e.mac[4], e.mac[5]);
+        Ui_SetText(&talkerMacUi[i], buf);
+        if (e.channel) {
+            snprintf(buf, sizeof(buf), "ch%u  %lu fr  %lu KB", e.channel,
+                     static_cast<unsigned long>(e.frames), static_cast<unsigned long>(e.bytes / 1024));
+        } else {
+            snprintf(buf, sizeof(buf), "ch--  %lu fr  %lu KB",
+                     static_cast<unsigned long>(e.frames), static_cast<unsigned long>(e.bytes / 1024));
+        }
+        Ui_SetText(&talkerInfoUi[i], buf);
+    }
+}
+
+// Third screen: a static header and footer around the hardware-scrolled rows.
+void buildWaterfallUi() {
+    // Heat ramp: navy, blue, green, yellow, red at 0/25/50/75/100 points.
+    static const uint8_t kStops[5][3] = {{0, 0, 48}, {0, 80, 220}, {0, 200, 80}, {255, 210, 0}, {255, 24, 0}};
+    for (int pts = 0; pts <= 100; pts++) {
+        const int seg = (pts < 100) ? pts / 25 : 3;
+        const int t = pts - seg * 25;
+        uint8_t rgb[3];
+        for (int c = 0; c < 3; c++) rgb[c] = static_cast<uint8_t>(kStops[seg][c] + (kStops[seg + 1][c] - kStops[seg][c]) * t / 25);
+        waterfallHeat[pts] = lv_color_to_u16(lv_color_make(rgb[0], rgb[1], rgb[2]));
+    }
+
+    waterfallScreen = lv_obj_create(nullptr);
+    lv_obj_set_style_bg_color(waterfallScreen, c565(BG_565), 0);
+    lv_obj_set_style_pad_all(waterfallScreen, 0, 0);
+    lv_obj_clear_flag(waterfallScreen, LV_OBJ_FLAG_SCROLLABLE);
+
+    lv_obj_t* title = make_label(waterfallScreen, "Waterfall", c565(YELLOW_565), true);
+    lv_obj_align(title, LV_ALIGN_TOP_LEFT, 4, 0);
+    static const uint8_t kAxis[] = {1, 6, 11, 13};
+    for (uint8_t ch : kAxis) {
+        char buf[4];
+        snprintf(buf, sizeof(buf), "%u", ch);
+        lv_obj_t* l = make_label(waterfallScreen, buf, c565(CYAN_565), true);
+        lv_obj_update_layout(l);
+        const int32_t x = (ch - 1) * kWaterfallColPx + (kWaterfallColPx - 1) / 2 - lv_obj_get_width(l) / 2;
+        lv_obj_align(l, LV_ALIGN_TOP_LEFT, x < 0 ? 0 : x, kWaterfallTopPx - 16);
+    }
+
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%lu.%lu s/row, newest top",
+             static_cast<unsigned long>(kWaterfallRowMs / 1000), static_cast<unsigned long>(kWaterfallRowMs % 1000 / 100));
+    lv_obj_t* footer = make_label(waterfallScreen, buf, c565(WHITE_565), true);
+    lv_obj_align(footer, LV_ALIGN_BOTTOM_MID, 0, -2);
+}
+
+// One row of pixels: a block per channel with a 1 px gap, black where there is no data.
+void renderWaterfallRow(const uint8_t pts[kChannelCount]) {
+    const uint16_t gap = lv_color_to_u16(c565(BG_565));
+    for (int x = 0; x < LCD_WIDTH; x++) {
+        const int col = x / kWaterfallColPx;
+        uint16_t px = gap;
+        if (col < kChannelCount && (x % kWaterfallColPx) != kWaterfallColPx - 1) {
+            px = (pts[col] == kWaterfallNoData) ? lv_color_to_u16(c565(BLACK_565)) : waterfallHeat[pts[col]];
+        }
+        waterfallPixels[x] = px;
+    }
+    for (uint16_t r = 1; r < kWaterfallRowPx; r++) {
+        memcpy(&waterfallPixels[r * LCD_WIDTH], waterfallPixels, sizeof(waterfallPixels[0]) * LCD_WIDTH);
+    }
+}
+
+// Rewrites the whole region from history (start address at the region top).
+void repaintWaterfall() {
+    uint8_t empty[kChannelCount];
+    memset(empty, kWaterfallNoData, sizeof(empty));
+    for (uint16_t k = 0; k < kWaterfallRows; k++) {
+        const uint8_t* row = (k < waterfallCount) ? waterfallHistory[(waterfallHead + kWaterfallRows - k) % kWaterfallRows]
+                                                  : empty;
+        renderWaterfallRow(row);
+        const uint16_t y = kWaterfallTopPx + k * kWaterfallRowPx;
+        LCD_addWindow(0, y, LCD_WIDTH - 1, y + kWaterfallRowPx - 1, waterfallPixels);
+    }
+}
+
+// Records a row every kWaterfallRowMs from the smoothed scores; scrolls it in when shown.
+void updateWaterfall() {
+    const uint32_t nowMs = millis();
+    if ((nowMs - waterfallRowAtMs) < kWaterfallRowMs) return;
+    waterfallRowAtMs = nowMs;
+
+    ChannelState view[kChannelCount];
+    snapshotChannels(view, nullptr);
+    waterfallHead = (waterfallHead + 1) % kWaterfallRows;
+    uint8_t* row = waterfallHistory[waterfallHead];
+    for (int i = 0; i < kChannelCount; i++) {
+        const unsigned pts = busyScorePoints(view[i].busyEma);
+        row[i] = view[i].hasData ? static_cast<uint8_t>(pts > 100 ? 100 : pts) : kWaterfallNoData;
+    }
+    if (waterfallCount < kWaterfallRows) waterfallCount++;
+    if (shownScreen != UiScreen::Waterfall) return;
+    renderWaterfallRow(row);
+    LCD_ScrollPushRows(waterfallPixels, kWaterfallRowPx);
+}
+
+void showScreen(UiScreen next) {
+    // Undo the scroll first so LVGL's full redraw of the next screen lands unshifted.
+    if (shownScreen == UiScreen::Waterfall) LCD_ScrollReset();
+    shownScreen = next;
+    switch (next) {
+        case UiScreen::Talkers:
+            refreshTalkers();  // Fill the rows before the first frame shows them
+            lv_scr_load(talkersScreen);
+            break;
+        case UiScreen::Waterfall:
+            lv_scr_load(waterfallScreen);
+            // From here the flush leaves the region alone; paint it from history.
+            LCD_ScrollDefine(kWaterfallTopPx, kWaterfallLines);
+            repaintWaterfall();
+            break;
+        default:
+            lv_scr_load(mainScreen);
+            break;
+    }
+}
+
+// BOOT button edge or a serial request moves on to the next screen:
+// main -> top talkers -> waterfall (portrait only) -> main.
+void pollScreenToggle() {
+    const bool down = digitalRead(kScreenButtonPin) == LOW;
+    const bool pressed = down && !screenButtonDown;
+    screenButtonDown = down;
+    if (!pressed && !g_screenToggleRequested) return;
+    g_screenToggleRequested = false;
+    switch (shownScreen) {
+        case UiScreen::Main: showScreen(UiScreen::Talkers); break;
+        case UiScreen::Talkers: showScreen(kWaterfall ? UiScreen::Waterfall : UiScreen::Main); break;
+        default: showScreen(UiScreen::Main); break;
+    }
 }
 
 void refreshUi() {
-    const float global = globalActivityMax();
-    lv_bar_set_value(globalBar, static_cast<int>(global + 0.5f), LV_ANIM_OFF);
+    ChannelState view[kChannelCount];
+    uint16_t allTalkers = 0;
+    snapshotChannels(view, &allTalkers);
+
+    const HopMode mode = g_hopMode;
+    const ScoreMode scoreMode = g_scoreMode;
+    if (mode != shownHopMode || scoreMode != shownScoreMode) {
+        shownHopMode = mode;
+        shownScoreMode = scoreMode;
+        lv_label_set_text(methodLabel, methodText(mode, scoreMode));
+    }
+
+    const uint16_t global = globalActivityMax(view);
+    const unsigned globalPts = busyScorePoints(global);
+    Ui_SetBarValue(&globalBarUi, static_cast<int32_t>(globalPts));
 
     lv_color_t barColor = c565(GREEN_565);
-    if (global > 70.0f) barColor = c565(RED_565);
-    else if (global > 40.0f) barColor = c565(YELLOW_565);
-    lv_obj_set_style_bg_color(globalBar, barColor, LV_PART_INDICATOR);
+    if (global > 70 * kBusyScoreOne) barColor = c565(RED_565);
+    else if (global > 40 * kBusyScoreOne) barColor = c565(YELLOW_565);
+    Ui_SetBgColor(&globalBarUi, barColor, LV_PART_INDICATOR);
 
-    // Drive onboard RGB LED based on global activity
-    if (global > 75.0f) {
+    // Drive onboard RGB LED based on global activity (once the boot self-test is over)
+    if (ledSelfTestStep != 0) {
+        // Self-test owns the LED.
+    } else if (global > 75 * kBusyScoreOne) {
         setLedColor(LED_RED);
-    } else if (global > 50.0f) {
+    } else if (global > 50 * kBusyScoreOne) {
         setLedColor(LED_ORANGE);
-    } else if (global > 25.0f) {
+    } else if (global > 25 * kBusyScoreOne) {
         setLedColor(LED_YELLOW);
     } else {
         setLedColor(LED_GREEN);
     }
 
     char buf[64];
-    snprintf(buf, sizeof(buf), "%.0f", global);
-    lv_label_set_text(globalLabel, buf);
+    snprintf(buf, sizeof(buf), "%u", globalPts);
+    Ui_DigitsSet(&globalDigits, buf);
 
     int top[3];
-    sortTop3(top);
+    sortTop3(view, kChannelCount, top);
     for (int i = 0; i < 3; i++) {
         if (top[i] < 0) {
-            lv_label_set_text(topRows[i], "--");
+            Ui_SetText(&topRowUi[i], "--");
             continue;
         }
-        const ChannelState& ch = channels[top[i]];
-        snprintf(buf, sizeof(buf), "%d %02d %.0f", i + 1, top[i] + 1, ch.busyEma);
-        lv_label_set_text(topRows[i], buf);
-        lv_bar_set_value(stripBars[i], static_cast<int>(ch.busyEma + 0.5f), LV_ANIM_OFF);
+        const ChannelState& ch = view[top[i]];
+        const unsigned pts = busyScorePoints(ch.busyEma);
+        snprintf(buf, sizeof(buf), "%d %02d %u", i + 1, top[i] + 1, pts);
+        Ui_SetText(&topRowUi[i], buf);
+        Ui_SetBarValue(&stripBarUi[i], static_cast<int32_t>(pts));
     }
 
-    Accum live{};
-    portENTER_CRITICAL(&g_accumMux);
-    live.frames = g_accum.frames;
-    live.bytes = g_accum.bytes;
-    live.strong = g_accum.strong;
-    live.unique = g_accum.unique;
-    portEXIT_CRITICAL(&g_accumMux);
-
+    // All-channel transmitter estimate (union of every channel's sketches).
     const uint32_t nowMs = millis();
-    if (apWindowStartedMs == 0) apWindowStartedMs = nowMs;
-    if (live.unique > apMaxWindow) apMaxWindow = live.unique; // hold the peak within the window
-    if ((nowMs - apWindowStartedMs) >= kApUpdateMs) {
-        lastApSeen = apMaxWindow;
+    if (apWindowStartedMs == 0 || (nowMs - apWindowStartedMs) >= kApUpdateMs) {
+        lastApSeen = allTalkers;
         apWindowStartedMs = nowMs;
-        apMaxWindow = 0;
     }
     snprintf(buf, sizeof(buf), "APs %u", static_cast<unsigned int>(lastApSeen));
-    lv_label_set_text(apLabel, buf);
+    Ui_DigitsSet(&apDigits, buf);
 
 }
 
+// Quick self-test: should flash red -> green -> blue (helps confirm channel order).
+// Runs as a short LVGL timer so boot never sleeps on it.
+void ledSelfTestCb(lv_timer_t* t) {
+    static const Led_Color kSteps[] = {{255, 0, 0}, {0, 255, 0}, {0, 0, 255}};
+    if (ledSelfTestStep >= 1 && ledSelfTestStep <= 3) {
+        setLedColor(kSteps[ledSelfTestStep - 1], 100);
+        ledSelfTestStep++;
+        return;
+    }
+    setLedColor(LED_OFF, 0);
+    ledSelfTestStep = 0;
+    lv_timer_delete(t);
+}
+
 void uiTimerCb(lv_timer_t* t) {
     (void)t;
     ensureWifiMonitor();
-    hopIfNeeded();
+    pollScreenToggle();
+    if (g_uiPaused) return;
     refreshUi();
+    if (shownScreen == UiScreen::Talkers) refreshTalkers();
+    if (kWaterfall) updateWaterfall();
+}
+
+// Replay hooks: frames enter the ring exactly where promiscuousCb puts them.
+void replayInject(const FrameRecord& rec) {
+    if (kBleSlicing && g_bleSliceActive) return;  // No Wi-Fi dwell to count it in
+    FrameRecord copy = rec;
+    queueFrame(copy);
+}
+
+uint32_t replayLostRecords() {
+    return g_captureRing.dropped() + g_dwellCloses.dropped();
+}
+
+uint32_t replayTakeHopSlipUs() {
+    const uint32_t slip = g_hopSlipMaxUs;
+    g_hopSlipMaxUs = 0;  // A concurrent update may be lost; the next dwell reports again
+    return slip;
+}
+
+void replaySetActive(bool active) {
+    g_replayActive = active;
+    esp_wifi_set_promiscuous(!active);  // Radio idle: replayed frames are the only load
+    if (!active) g_uiPaused = false;
+}
+
+void startReplay(ReplayMode mode, uint16_t speedX, bool ui) {
+    if (TraceReplay_Running()) {
+        printf("replay: already running ('x' stops it)\r\n");
+        return;
+    }
+    const TraceReplayTarget target = {replayInject, replayLostRecords, replayTakeHopSlipUs, replaySetActive};
+    TraceReplayConfig cfg;
+    cfg.mode = mode;
+    cfg.speedX = speedX;
+    cfg.uiRunning = ui;
+    g_uiPaused = !ui;
+    if (!TraceReplay_Start(target, cfg)) g_uiPaused = false;
+}
+
+// One line of last-dwell airtime estimates, whichever score is active.
+void printAirtime() {
+    ChannelState view[kChannelCount];
+    snapshotChannels(view, nullptr);
+    char line[160];
+    int n = snprintf(line, sizeof(line), "airtime:");
+    for (int i = 0; i < kChannelCount && n < static_cast<int>(sizeof(line)) - 12; i++) {
+        if (!view[i].hasData) {
+            n += snprintf(line + n, sizeof(line) - n, " %d:--", i + 1);
+        } else {
+            n += snprintf(line + n, sizeof(line) - n, " %d:%u%%", i + 1, busyScorePoints(view[i].airtimeQ8));
+        }
+    }
+    printf("%s\r\n", line);
 }
 
 } // namespace
 
 void Bandwatch_Init(void) {
-    if (HAVE_NEOPIXEL) {
-        rgb.begin();
-        rgb.setBrightness(60);
-        rgb.clear();
-        rgb.show();
-        // Quick self-test: should flash red -> green -> blue (helps confirm channel order).
-        setLedColor({255, 0, 0}, 100);
-        delay(120);
-        setLedColor({0, 255, 0}, 100);
-        delay(120);
-        setLedColor({0, 0, 255}, 100);
-        delay(120);
-        rgb.clear();
-        rgb.show();
+    if (Led_Init(kRgbPin, kRgbOrder, kRgbMaxBrightness) && kLedSelfTest) {
+        ledSelfTestStep = 1;
+        lv_timer_t* st = lv_timer_create(ledSelfTestCb, kLedSelfTestStepMs, nullptr);
+        lv_timer_ready(st);
     }
+    pinMode(kScreenButtonPin, INPUT_PULLUP);
     buildUi();
+    buildTalkersUi();
+    if (kWaterfall) buildWaterfallUi();
     lv_timer_create(uiTimerCb, kUiIntervalMs, nullptr);
     ensureWifiMonitor();
     refreshUi();
 }
+
+void Bandwatch_StartCapture(void) {
+    static bool statsRegistered = false;
+    if (!statsRegistered) {
+        statsRegistered = true;
+        Stats_Init("bandwatch");
+        Stats_AddTimer("promisc", &g_promiscStats);
+        Stats_AddTimer("accum_hold", &g_accumHoldStats);
+        Stats_AddCounter("frames", [] { return wifiAirFrames; });
+        Stats_AddCounter("ctrl", [] { return g_ctrlFrames; });
+        Stats_AddCounter("ring_drops", [] { return g_captureRing.dropped(); });
+        Stats_AddCounter("pcap_drops", [] {
+            PcapLoggerStats st;
+            PcapLogger_GetStats(&st);
+            return st.framesDropped;
+        });
+        Stats_AddCounter("history_drops", [] {
+            HistoryStats st;
+            History_GetStats(&st);
+            return st.dropped;
+        });
+        Stats_AddCounter("ui_flush_px", [] {
+            Ui_Stats st;
+            Ui_GetStats(&st);
+            return st.flushedPx;
+        });
+        Stats_AddCounter("ui_saved_px", [] {
+            Ui_Stats st;
+            Ui_GetStats(&st);
+            return st.savedPx;
+        });
+        Stats_AddCounter("replay", [] {
+            TraceReplayStats st;
+            TraceReplay_GetStats(&st);
+            return st.injected;
+        });
+        if (kMesh) {
+            Stats_AddCounter("mesh_dwells", [] {
+                MeshLinkStats st;
+                MeshLink_GetStats(&st);
+                return st.dwells;
+            });
+        }
+    }
+    ensureWifiMonitor();
+}
+
+void Bandwatch_SetHopMode(HopMode mode) {
+    g_hopMode = mode;
+}
+
+void Bandwatch_SetScoreMode(ScoreMode mode) {
+    g_scoreMode = mode;
+}
+
+void Bandwatch_SetCaptureProfile(CaptureProfile profile) {
+    if (g_hopTimer) {
+        applyCaptureProfile(profile);  // Capture is running: switch the driver filters now
+    } else {
+        g_captureProfile = profile;    // Picked up by ensureWifiMonitor
+    }
+}
+
+void Bandwatch_PollSerial(void) {
+    while (Serial.available() > 0) {
+        const int c = Serial.read();
+        if (c == 'h') {
+            History_ExportCsv();
+        } else if (c == 's') {
+            Stats_Dump();
+        } else if (c == 't') {
+            g_screenToggleRequested = true;
+        } else if (c == 'c') {
+            const uint8_t next = (static_cast<uint8_t>(g_captureProfile) + 1) % 3;
+            Bandwatch_SetCaptureProfile(static_cast<CaptureProfile>(next));
+            printf("capture: profile %s\r\n", captureProfileName(g_captureProfile));
+        } else if (c == 'a') {
+            printAirtime();
+        } else if (c == 'A') {
+            const ScoreMode next = (g_scoreMode == ScoreMode::Blend) ? ScoreMode::Airtime : ScoreMode::Blend;
+            Bandwatch_SetScoreMode(next);
+            printf("score: %s\r\n", next == ScoreMode::Airtime ? "airtime" : "blend");
+        } else if (c == 'r' || c == 'R') {
+            startReplay(ReplayMode::Sweep, 1, c == 'r');
+        } else if (c == 'p' || c == 'P') {
+            startReplay(ReplayMode::Timed, c == 'p' ? 1 : kReplaySpeedX, true);
+        } else if (c == 'x') {
+            TraceReplay_Stop();
+        } else if (c == 'm') {
+            MeshLinkStats st;
+            MeshLink_GetStats(&st);
+            printf("mesh: %s, %u node(s), mask 0x%04x, %lu reports, %lu dwells in, %lu dropped in, %lu dropped out, %lu send errors\r\n",
+                   meshRoleName(st.role), st.nodes, st.channelMask, static_cast<unsigned long>(st.reports),
+                   static_cast<unsigned long>(st.dwells), static_cast<unsigned long>(g_remoteDwells.dropped()),
+                   static_cast<unsigned long>(st.dwellsDropped), static_cast<unsigned long>(st.sendErrors));
+        } else if (c == 'H') {
+            HistoryStats st;
+            History_GetStats(&st);
+            printf("history: boot %lu, %u/%u sectors, %lu records, %lu B written, %lu erases, %lu errors, %lu dropped\r\n",
+                   static_cast<unsigned long>(st.bootId), st.sectorsUsed, st.sectors,
+                   static_cast<unsigned long>(st.recordsWritten), static_cast<unsigned long>(st.bytesWritten),
+                   static_cast<unsigned long>(st.erases), static_cast<unsigned long>(st.writeErrors),
+                   static_cast<unsigned long>(st.dropped));
+        }
+    }
+    Stats_Poll();
+}
@@ -5,5 +5,45 @@
 #endif
 
 #include <lvgl.h>
+#include "Hop_Scheduler.h"
 
 void Bandwatch_Init(void);
+
+// Start promiscuous capture and hopping. Safe to call before the display or LVGL
+// are up (and again later; it only starts once).
+void Bandwatch_StartCapture(void);
+
+// Select how the hopper distributes dwell time (default: HopMode::Weighted).
+void Bandwatch_SetHopMode(HopMode mode);
+
+// What the busy score measures. Either way the last dwell's airtime estimate is kept
+// per channel (ChannelState::airtimeQ8).
+enum class ScoreMode : uint8_t {
+    Blend = 0,      // Log-blended packets/s, bytes/s, strong ratio and unique transmitters
+    Airtime = 1,    // Estimated airtime %: every frame timed at its PHY rate (Airtime.h)
+};
+
+// Select the busy score (default: ScoreMode::Blend). Smoothed scores move over to the
+// new one within a few dwells per channel.
+void Bandwatch_SetScoreMode(ScoreMode mode);
+
+// Which frames the Wi-Fi driver passes up. Filtering happens in hardware, so frames a
+// profile leaves out never cost an RX callback. Control frames (ACK/RTS/CTS, the bulk
+// of a busy channel) are only tallied per dwell, never queued or scored, except in Full.
+enum class CaptureProfile : uint8_t {
+    Full = 0,       // Management, data and all control frames (long control frames are scored)
+    Counting = 1,   // Management and data scored; only RTS/CTS tallied, ACK/BA dropped in hardware
+    Discovery = 2,  // Management only: talkers and APs stay accurate, busy score covers beacons/probes
+};
+
+// Select the capture profile (default: CaptureProfile::Full). Takes effect immediately.
+void Bandwatch_SetCaptureProfile(CaptureProfile profile);
+
+// Serial commands: 'h' dumps the flash history as CSV, 'H' prints history stats,
+// 's' prints a hot-path stats JSON line (Hot_Stats.h), 'c' cycles the capture
+// profile, 'a' prints each channel's airtime estimate, 'A' switches the busy score
+// (ScoreMode), 't' steps through the main, top-talkers and waterfall screens (also the
+// BOOT button). Trace replay (Trace_Replay.h): 'r'/'R' sweep for the maximum sustained
+// rate with/without UI refreshes, 'p'/'P' play the trace at 1x/accelerated, 'x' stops.
+// 'm' prints the multi-node status (Mesh_Link.h). Call from loop().
+void Bandwatch_PollSerial(void);
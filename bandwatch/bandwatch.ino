@@ -1,14 +1,28 @@
 #include "Display_ST7789.h"
 #include "LVGL_Driver.h"
+#include "Boot_Timing.h"
+#include "bandwatch.h"
 
 void setup()
 {
-  LCD_Init();
+  Boot_Mark("setup");
+  Serial.begin(115200);  // Serial commands (Bandwatch_PollSerial)
+  // Only asserts panel reset (no waiting), so the reset settle overlaps Wi-Fi bring-up.
+  LCD_InitAsync();
+  // Capture before any UI work; the panel sequence continues from loop().
+  Bandwatch_StartCapture();
   Lvgl_Init();
 }
 
 void loop()
 {
-  Timer_Loop();
-  delay(5);
+  Bandwatch_PollSerial();
+  if (!LCD_InitStep()) {
+    // Panel init is still running; poll it without rendering.
+    delay(1);
+    return;
+  }
+  // Panel ready: LVGL runs in its own task from here on (no-op after the first call).
+  Lvgl_StartTask();
+  delay(20);
 }
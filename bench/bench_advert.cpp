@@ -0,0 +1,197 @@
+// Per-advertisement cost of the BLEwatch scan path on the host: payload parse plus
+// DeviceTracker::onAdvert (table upsert, sweep, active buckets, strongest device), and
+// the UI's chooseDisplayed() on the resulting summary (what noteDeviceSeen and
+// countActiveDevicesAndBest do on the device).
+//
+//   bench_advert [--count N] [--devices N] [--rate N]   synthetic crowd
+//   bench_advert --trace file.txt [--repeat N]          recorded adverts
+//
+// Trace lines are "<ms> <mac> <rssi> <payload hex>", e.g.
+//   1234 C0:12:34:56:78:9A -67 0201060aff4c0010050b1c
+// with '#' comments; a serial log with one advert per line reduces to this with awk.
+#include <string>
+#include <vector>
+#include "bench_util.h"
+#include "Adv_Parser.h"
+#include "Device_Tracker.h"
+
+namespace {
+
+constexpr int kVeryCloseRssiDbm = -40;       // As in blewatch.cpp
+constexpr int kStickyRssiMarginDb = 10;
+constexpr uint32_t kUiEveryAdverts = 16;     // ~One UI read per 16 adverts in a busy room
+
+struct TraceAdvert {
+  uint32_t ms;
+  uint8_t mac[6];
+  int8_t rssi;
+  uint8_t len;
+  uint8_t payload[31];
+};
+
+uint8_t putName(uint8_t* p, const char* name) {
+  const uint8_t n = static_cast<uint8_t>(strlen(name));
+  p[0] = static_cast<uint8_t>(n + 1);
+  p[1] = kAdCompleteName;
+  memcpy(p + 2, name, n);
+  return static_cast<uint8_t>(n + 2);
+}
+
+// A crowd of phones, beacons and wearables. Most use random addresses that rotate,
+// so the table sees a steady stream of new devices as well as repeats.
+void synthesize(std::vector<TraceAdvert>& out, uint32_t count, uint32_t devices, uint32_t rate) {
+  BenchRng rng;
+  std::vector<uint32_t> ids(devices ? devices : 1);
+  for (uint32_t i = 0; i < ids.size(); i++) ids[i] = rng.next();
+  const char* names[] = {"Pixel 9", "Galaxy Buds", "Tile", "MX Keys", "Watch"};
+  out.reserve(count);
+  uint32_t usAcc = 0;
+  uint32_t ms = 1000;
+  for (uint32_t i = 0; i < count; i++) {
+    usAcc += 1000000 / (rate ? rate : 1);
+    ms += usAcc / 1000;
+    usAcc %= 1000;
+    const uint32_t d = rng.below(static_cast<uint32_t>(ids.size()));
+    if (rng.below(2000) == 0) ids[d] = rng.next();  // Address rotation
+    TraceAdvert a{};
+    a.ms = ms;
+    a.mac[0] = static_cast<uint8_t>(0xC0 | (ids[d] & 0x3F));
+    a.mac[1] = static_cast<uint8_t>(ids[d] >> 6);
+    a.mac[2] = static_cast<uint8_t>(ids[d] >> 14);
+    a.mac[3] = static_cast<uint8_t>(ids[d] >> 22);
+    a.mac[4] = static_cast<uint8_t>(d);
+    a.mac[5] = static_cast<uint8_t>(d >> 8);
+    a.rssi = static_cast<int8_t>(-95 + static_cast<int>((ids[d] % 50) + rng.below(12)));
+    uint8_t n = 0;
+    a.payload[n++] = 0x02;
+    a.payload[n++] = kAdFlags;
+    a.payload[n++] = 0x1A;
+    if (d % 3 == 0) {
+      a.payload[n++] = 0x02;
+      a.payload[n++] = kAdTxPower;
+      a.payload[n++] = static_cast<uint8_t>(-8 - static_cast<int>(d % 12));
+    }
+    if (d % 4 == 0) {
+      n = static_cast<uint8_t>(n + putName(a.payload + n, names[d % 5]));
+    } else {
+      const uint8_t mfg[] = {0x09, kAdManufacturer, 0x4C, 0x00, 0x10, 0x05, 0x0B, 0x1C, 0x7A, 0x3E};
+      memcpy(a.payload + n, mfg, sizeof(mfg));
+      n = static_cast<uint8_t>(n + sizeof(mfg));
+    }
+    a.len = n;
+    out.push_back(a);
+  }
+}
+
+int hexNibble(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+bool loadTrace(const char* path, std::vector<TraceAdvert>& out) {
+  std::vector<uint8_t> file;
+  if (!benchLoadFile(path, file)) return false;
+  file.push_back('\0');
+  size_t bad = 0;
+  char* save = nullptr;
+  for (char* line = strtok_r(reinterpret_cast<char*>(file.data()), "\r\n", &save); line;
+       line = strtok_r(nullptr, "\r\n", &save)) {
+    if (line[0] == '#' || line[0] == '\0') continue;
+    TraceAdvert a{};
+    unsigned long ms = 0;
+    unsigned m[6];
+    int rssi = 0;
+    char hex[80] = {0};
+    if (sscanf(line, "%lu %x:%x:%x:%x:%x:%x %d %79s", &ms, &m[0], &m[1], &m[2], &m[3], &m[4], &m[5], &rssi,
+               hex) < 8) {
+      bad++;
+      continue;
+    }
+    a.ms = static_cast<uint32_t>(ms);
+    for (int i = 0; i < 6; i++) a.mac[i] = static_cast<uint8_t>(m[i]);
+    a.rssi = static_cast<int8_t>(rssi);
+    for (size_t i = 0; hex[i] && hex[i + 1] && a.len < sizeof(a.payload); i += 2) {
+      const int hi = hexNibble(hex[i]);
+      const int lo = hexNibble(hex[i + 1]);
+      if (hi < 0 || lo < 0) break;
+      a.payload[a.len++] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    out.push_back(a);
+  }
+  printf("trace: %zu adverts (%zu unparseable lines)\n", out.size(), bad);
+  return true;
+}
+
+struct RunResult {
+  uint64_t advertNs;   // Parse + onAdvert
+  uint64_t uiNs;       // chooseDisplayed
+  uint32_t uiReads;
+  uint32_t dropped;
+  size_t devices;
+};
+
+RunResult run(const std::vector<TraceAdvert>& trace, uint32_t timeOffsetMs) {
+  static DeviceTracker tracker;  // ~11 KB table: keep it off the stack
+  RunResult r{};
+  const uint8_t noMac[6] = {0};
+  uint64_t checksum = 0;
+  for (size_t i = 0; i < trace.size(); i++) {
+    const TraceAdvert& a = trace[i];
+    const uint32_t nowMs = a.ms + timeOffsetMs;
+    const uint64_t t0 = benchNowNs();
+    AdvInfo adv;
+    advParse(a.payload, a.len, adv);
+    if (!tracker.onAdvert(a.mac, a.rssi, adv, nowMs)) r.dropped++;
+    const uint64_t t1 = benchNowNs();
+    r.advertNs += t1 - t0;
+    if (i % kUiEveryAdverts == 0) {
+      const DisplayChoice c = chooseDisplayed(tracker.summary(), noMac, nowMs, kVeryCloseRssiDbm, kStickyRssiMarginDb);
+      r.uiNs += benchNowNs() - t1;
+      r.uiReads++;
+      checksum += static_cast<uint64_t>(c.count) + (c.device ? c.device->mac[5] : 0);
+    }
+  }
+  benchKeep(checksum);
+  r.devices = tracker.table().size();
+  return r;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  std::vector<TraceAdvert> trace;
+  const char* path = benchArg(argc, argv, "--trace", nullptr);
+  if (path) {
+    if (!loadTrace(path, trace)) return 1;
+  } else {
+    const uint32_t count = static_cast<uint32_t>(atoi(benchArg(argc, argv, "--count", "2000000")));
+    const uint32_t devices = static_cast<uint32_t>(atoi(benchArg(argc, argv, "--devices", "300")));
+    const uint32_t rate = static_cast<uint32_t>(atoi(benchArg(argc, argv, "--rate", "1500")));
+    synthesize(trace, count, devices, rate);
+    printf("synthetic: %u adverts, %u devices, %u adverts/s\n", count, devices, rate);
+  }
+  if (trace.empty()) {
+    printf("no adverts\n");
+    return path ? 1 : 0;
+  }
+
+  const int repeat = atoi(benchArg(argc, argv, "--repeat", path ? "20" : "1"));
+  RunResult total{};
+  const uint32_t spanMs = trace.back().ms - trace.front().ms + kDeviceStaleMs + 1000;
+  for (int k = 0; k < (repeat > 0 ? repeat : 1); k++) {
+    const RunResult r = run(trace, k * spanMs);  // Replays move forward in time
+    total.advertNs += r.advertNs;
+    total.uiNs += r.uiNs;
+    total.uiReads += r.uiReads;
+    total.dropped += r.dropped;
+    total.devices = r.devices;
+  }
+  const double adverts = static_cast<double>(trace.size()) * (repeat > 0 ? repeat : 1);
+  printf("per advert: %.1f ns (parse + track)\n", total.advertNs / adverts);
+  printf("per UI read: %.1f ns (chooseDisplayed)\n",
+         total.uiReads ? static_cast<double>(total.uiNs) / total.uiReads : 0.0);
+  printf("table: %zu devices at end, %u adverts not recorded\n", total.devices, total.dropped);
+  return 0;
+}
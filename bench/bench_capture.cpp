@@ -0,0 +1,190 @@
+// Per-frame cost of the Bandwatch aggregation path on the host: FrameRecord through the
+// SPSC capture ring into the dwell accumulator and top-talkers table, and per dwell the
+// snapshot, busy and airtime scores, EMA update, top-3 sort and top-talker listing (what
+// aggregatorTask and finishDwell do on the device).
+//
+//   bench_capture [--count N] [--talkers N] [--pps N]   synthetic trace
+//   bench_capture --pcap file.pcap [--repeat N]         recorded trace (Pcap_Logger output)
+//
+// Recorded traces are split into dwells by their own timestamps, on the channel each
+// frame was captured on (radiotap), so the score inputs match what the device saw.
+#include <vector>
+#include "bench_util.h"
+#include "Busy_Score.h"
+#include "Capture_Ring.h"
+#include "Dwell_Metrics.h"
+#include "Pcap_Trace.h"
+#include "Top_Talkers.h"
+
+namespace {
+
+constexpr uint32_t kDwellUs = 260000;        // kDwellMs in bandwatch.cpp
+constexpr int kChannelCount = 13;
+constexpr int kStrongThresholdDbm = -65;
+constexpr uint16_t kBusyEmaAlphaQ16 = 14418;
+
+struct TraceFrame {
+    uint64_t tsUs;
+    uint8_t channel;     // 1..13
+    FrameRecord rec;
+};
+
+void synthesize(std::vector<TraceFrame>& out, uint32_t count, uint32_t talkers, uint32_t pps) {
+    BenchRng rng;
+    const uint16_t sizes[] = {24, 60, 120, 300, 1500, 1500, 90, 800};
+    out.reserve(count);
+    uint64_t ts = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        TraceFrame f{};
+        ts += 1000000 / (pps ? pps : 1);
+        f.tsUs = ts;
+        f.channel = static_cast<uint8_t>(1 + (ts / kDwellUs) % kChannelCount);
+        f.rec.len = sizes[rng.below(8)];
+        f.rec.rssi = static_cast<int8_t>(-95 + static_cast<int>(rng.below(65)));
+        f.rec.type = static_cast<uint8_t>(rng.below(3));
+        f.rec.rate = static_cast<uint8_t>(rng.below(kAirtimeRateCount));
+        const uint32_t t = rng.below(talkers ? talkers : 1);
+        f.rec.ta[0] = 0x02;
+        f.rec.ta[2] = static_cast<uint8_t>(t >> 16);
+        f.rec.ta[3] = static_cast<uint8_t>(t >> 8);
+        f.rec.ta[4] = static_cast<uint8_t>(t);
+        f.rec.ta[5] = static_cast<uint8_t>(t * 37);
+        out.push_back(f);
+    }
+}
+
+bool loadPcap(const char* path, std::vector<TraceFrame>& out) {
+    std::vector<uint8_t> file;
+    if (!benchLoadFile(path, file)) return false;
+    PcapTraceInfo info;
+    if (!pcapParseGlobal(file.data(), file.size(), info)) {
+        fprintf(stderr, "%s: not a little-endian 802.11 / radiotap pcap\n", path);
+        return false;
+    }
+    const uint64_t start = benchNowNs();
+    size_t off = kPcapGlobalHdrLen;
+    size_t skipped = 0;
+    PcapTraceFrame f;
+    size_t used = 0;
+    while (pcapNextFrame(info, file.data() + off, file.size() - off, f, used)) {
+        off += used;
+        TraceFrame t{};
+        if (!pcapToFrameRecord(f, 0, t.rec)) {
+            skipped++;
+            continue;
+        }
+        t.tsUs = f.tsUs;
+        t.channel = (f.channel >= 1 && f.channel <= kChannelCount) ? f.channel : 1;
+        out.push_back(t);
+    }
+    const uint64_t ns = benchNowNs() - start;
+    printf("pcap: %zu frames (%zu skipped), decode %.1f ns/frame\n", out.size(), skipped,
+           out.empty() ? 0.0 : static_cast<double>(ns) / out.size());
+    if (off != file.size()) printf("pcap: %zu trailing bytes ignored (truncated record)\n", file.size() - off);
+    return true;
+}
+
+struct RunResult {
+    uint64_t frameNs;     // Ring + accumulator + top talkers
+    uint64_t dwellNs;     // Dwell close: snapshot, scores, EMA, top 3, talker listing
+    uint32_t dwells;
+    uint32_t drops;
+};
+
+RunResult run(const std::vector<TraceFrame>& trace) {
+    static SpscRing<FrameRecord, 256> ring;  // kCaptureRingSize
+    static ChannelState channels[kChannelCount];
+    static DwellAccum accum;
+    static TopTalkers<32> talkers;           // kTopTalkerCounters
+    TopTalkers<32>::Entry listed[8];         // kTopTalkerRows
+    RunResult r{};
+    const uint32_t dropsBefore = ring.dropped();
+
+    uint64_t dwellStartUs = trace.empty() ? 0 : trace.front().tsUs;
+    int channel = trace.empty() ? 0 : trace.front().channel - 1;
+    int top[3];
+    uint64_t checksum = 0;
+    size_t i = 0;
+    while (i < trace.size()) {
+        // Frames of one dwell: same channel, within kDwellUs of its first frame.
+        size_t end = i;
+        while (end < trace.size() && trace[end].channel - 1 == channel &&
+               trace[end].tsUs - dwellStartUs < kDwellUs) {
+            end++;
+        }
+
+        const uint64_t t0 = benchNowNs();
+        for (size_t k = i; k < end; k++) {
+            ring.push(trace[k].rec);
+            FrameRecord rec;
+            while (ring.pop(rec)) {
+                accum.add(rec, kStrongThresholdDbm);
+                talkers.add(rec.ta, rec.len, static_cast<uint8_t>(r.dwells));
+            }
+        }
+        const uint64_t t1 = benchNowNs();
+        const ChannelMetrics snap = accum.snapshot(kDwellUs);
+        const uint16_t score = computeBusyScoreQ8(snap, kDwellUs);
+        const uint16_t airtime = computeAirtimeScoreQ8(snap, kDwellUs);
+        channels[channel].applyDwell(snap, score, kBusyEmaAlphaQ16);
+        sortTop3(channels, kChannelCount, top);
+        talkers.assignChannel(static_cast<uint8_t>(r.dwells), static_cast<uint8_t>(channel + 1));
+        const uint8_t shown = talkers.top(listed, 8);
+        accum.clear();
+        const uint64_t t2 = benchNowNs();
+
+        r.frameNs += t1 - t0;
+        r.dwellNs += t2 - t1;
+        r.dwells++;
+        checksum += score + airtime + top[0] + shown;
+        if (end < trace.size()) {
+            channel = trace[end].channel - 1;
+            dwellStartUs = trace[end].tsUs;
+        }
+        i = end;
+    }
+    benchKeep(checksum);
+    r.drops = ring.dropped() - dropsBefore;
+    return r;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<TraceFrame> trace;
+    const char* pcap = benchArg(argc, argv, "--pcap", nullptr);
+    if (pcap) {
+        if (!loadPcap(pcap, trace)) return 1;
+    } else {
+        const uint32_t count = static_cast<uint32_t>(atoi(benchArg(argc, argv, "--count", "2000000")));
+        const uint32_t talkers = static_cast<uint32_t>(atoi(benchArg(argc, argv, "--talkers", "400")));
+        const uint32_t pps = static_cast<uint32_t>(atoi(benchArg(argc, argv, "--pps", "2000")));
+        synthesize(trace, count, talkers, pps);
+        printf("synthetic: %u frames, %u talkers, %u pps\n", count, talkers, pps);
+    }
+    if (trace.empty()) {
+        printf("no frames\n");
+        return pcap ? 1 : 0;
+    }
+
+    const int repeat = atoi(benchArg(argc, argv, "--repeat", pcap ? "20" : "1"));
+    RunResult total{};
+    for (int k = 0; k < (repeat > 0 ? repeat : 1); k++) {
+        const RunResult r = run(trace);
+        total.frameNs += r.frameNs;
+        total.dwellNs += r.dwellNs;
+        total.dwells += r.dwells;
+        total.drops += r.drops;
+    }
+    const double frames = static_cast<double>(trace.size()) * (repeat > 0 ? repeat : 1);
+    const double perFrame = total.frameNs / frames;
+    const double perDwell = total.dwells ? static_cast<double>(total.dwellNs) / total.dwells : 0.0;
+    printf("per frame:  %.1f ns (ring push/pop + accumulate + top talkers)\n", perFrame);
+    printf("per dwell:  %.1f ns (snapshot + scores + EMA + top 3), %u dwells\n", perDwell, total.dwells);
+    printf("all-in:     %.1f ns/frame\n", (total.frameNs + total.dwellNs) / frames);
+    if (total.drops) {
+        printf("ring drops: %u (unexpected on a single thread)\n", total.drops);
+        return 1;
+    }
+    return 0;
+}
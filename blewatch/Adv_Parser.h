@@ -0,0 +1,91 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// In-place parser for BLE advertising / scan response payloads (Core Spec Vol 3,
+// Part C, §11: a run of [length][AD type][data] structures).
+//
+// Nothing is copied or allocated: pointers in AdvInfo point into the caller's payload
+// and are only valid while it is. Malformed structures end the walk; whatever was
+// parsed before them is kept.
+struct AdvInfo {
+  bool hasFlags = false;
+  uint8_t flags = 0;
+  bool hasTxPower = false;
+  int8_t txPowerDbm = 0;
+  const char* name = nullptr;      // Not NUL-terminated
+  uint8_t nameLen = 0;
+  bool nameComplete = false;       // Complete (0x09) vs shortened (0x08) local name
+  bool hasCompanyId = false;
+  uint16_t companyId = 0;          // From manufacturer specific data
+  const uint8_t* mfgData = nullptr;  // After the company ID
+  uint8_t mfgLen = 0;
+  bool hasServiceData16 = false;
+  uint16_t serviceData16Uuid = 0;
+  const uint8_t* serviceData = nullptr;  // After the UUID
+  uint8_t serviceDataLen = 0;
+};
+
+constexpr uint8_t kAdFlags = 0x01;
+constexpr uint8_t kAdShortName = 0x08;
+constexpr uint8_t kAdCompleteName = 0x09;
+constexpr uint8_t kAdTxPower = 0x0A;
+constexpr uint8_t kAdServiceData16 = 0x16;
+constexpr uint8_t kAdManufacturer = 0xFF;
+
+// Returns false if the payload was truncated or malformed (fields before it are set).
+inline bool advParse(const uint8_t* p, size_t len, AdvInfo& out) {
+  if (!p) return len == 0;
+  size_t i = 0;
+  while (i < len) {
+    const uint8_t fieldLen = p[i];
+    if (fieldLen == 0) return true;            // Early terminator / zero padding
+    if (i + 1 + fieldLen > len) return false;  // Structure runs past the payload
+    const uint8_t type = p[i + 1];
+    const uint8_t* data = p + i + 2;
+    const uint8_t dataLen = static_cast<uint8_t>(fieldLen - 1);
+    switch (type) {
+      case kAdFlags:
+        if (dataLen >= 1) {
+          out.hasFlags = true;
+          out.flags = data[0];
+        }
+        break;
+      case kAdShortName:
+      case kAdCompleteName:
+        // A complete name wins over a shortened one, whichever comes first.
+        if (dataLen > 0 && (!out.name || (type == kAdCompleteName && !out.nameComplete))) {
+          out.name = reinterpret_cast<const char*>(data);
+          out.nameLen = dataLen;
+          out.nameComplete = (type == kAdCompleteName);
+        }
+        break;
+      case kAdTxPower:
+        if (dataLen >= 1) {
+          out.hasTxPower = true;
+          out.txPowerDbm = static_cast<int8_t>(data[0]);
+        }
+        break;
+      case kAdServiceData16:
+        if (dataLen >= 2 && !out.hasServiceData16) {
+          out.hasServiceData16 = true;
+          out.serviceData16Uuid = static_cast<uint16_t>(data[0] | (data[1] << 8));
+          out.serviceData = data + 2;
+          out.serviceDataLen = static_cast<uint8_t>(dataLen - 2);
+        }
+        break;
+      case kAdManufacturer:
+        if (dataLen >= 2 && !out.hasCompanyId) {
+          out.hasCompanyId = true;
+          out.companyId = static_cast<uint16_t>(data[0] | (data[1] << 8));
+          out.mfgData = data + 2;
+          out.mfgLen = static_cast<uint8_t>(dataLen - 2);
+        }
+        break;
+      default:
+        break;
+    }
+    i += 1 + fieldLen;
+  }
+  return true;
+}
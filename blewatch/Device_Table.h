@@ -0,0 +1,151 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// Open-addressed (linear probing) table of BLE devices keyed on the full 48-bit address.
+//
+// Slot is the caller's record type; it needs `uint8_t mac[6]`, `uint32_t lastSeenMs`
+// and `bool used`, and a default-constructed Slot must be empty. Every entry lives
+// within kMaxProbe slots of its home bucket, so lookups and inserts cost at most
+// kMaxProbe probes no matter how full the table is:
+//   - a new address reuses the first stale entry on its probe path,
+//   - else takes a free slot while the table is under 3/4 full,
+//   - else evicts the least recently seen entry on its probe path (LRU fallback).
+// sweep() removes stale entries a few at a time (backward-shift deletion, no
+// tombstones). Not thread-safe; in BLEwatch only the BLE host task touches it.
+template <typename Slot, size_t N>
+class DeviceTable {
+  static_assert(N >= 16 && (N & (N - 1)) == 0, "DeviceTable size must be a power of two");
+
+ public:
+  static constexpr size_t kCapacity = N;
+  static constexpr size_t kMaxLoad = N - N / 4;
+  static constexpr size_t kMaxProbe = 16;
+
+  // Entry for mac, created (see above) when absent; a created entry has mac/used set
+  // and lastSeenMs = nowMs, everything else default. Null only when the table has a
+  // single free slot left, which the load limit and sweep() keep out of reach.
+  // If `replaced` is given it receives the entry that was overwritten to make room
+  // (used == false when none was).
+  Slot* upsert(const uint8_t mac[6], uint32_t nowMs, uint32_t staleMs, Slot* replaced = nullptr) {
+    if (replaced) replaced->used = false;
+    const size_t home = homeOf(mac);
+    size_t freeIdx = kNone;
+    size_t staleIdx = kNone;
+    size_t oldestIdx = kNone;
+    for (size_t d = 0; d < kMaxProbe; d++) {
+      const size_t i = (home + d) & (N - 1);
+      Slot& s = slots_[i];
+      if (!s.used) {
+        freeIdx = i;
+        break;  // No holes inside a chain, so the address is not further on
+      }
+      if (memcmp(s.mac, mac, 6) == 0) return &s;
+      const uint32_t age = nowMs - s.lastSeenMs;
+      if (staleIdx == kNone && age > staleMs) staleIdx = i;
+      if (oldestIdx == kNone || age > nowMs - slots_[oldestIdx].lastSeenMs) oldestIdx = i;
+    }
+
+    size_t idx;
+    if (staleIdx != kNone) {
+      idx = staleIdx;
+      staleReused_++;
+    } else if (freeIdx != kNone && size_ < kMaxLoad) {
+      idx = freeIdx;
+      size_++;
+    } else if (oldestIdx != kNone) {
+      idx = oldestIdx;
+      lruEvicted_++;
+    } else if (size_ < N - 1) {
+      idx = freeIdx;  // Home bucket empty but over the load limit: nothing to evict
+      size_++;
+    } else {
+      return nullptr;  // Keep one hole so eraseAt() always terminates
+    }
+    Slot& s = slots_[idx];
+    if (replaced && s.used) *replaced = s;
+    s = Slot{};
+    memcpy(s.mac, mac, 6);
+    s.lastSeenMs = nowMs;
+    s.used = true;
+    return &s;
+  }
+
+  Slot* find(const uint8_t mac[6]) {
+    const size_t home = homeOf(mac);
+    for (size_t d = 0; d < kMaxProbe; d++) {
+      Slot& s = slots_[(home + d) & (N - 1)];
+      if (!s.used) return nullptr;
+      if (memcmp(s.mac, mac, 6) == 0) return &s;
+    }
+    return nullptr;
+  }
+
+  // Frees up to `budget` slots' worth of stale entries, continuing where the last
+  // call stopped, so a full pass is spread over several UI ticks.
+  void sweep(uint32_t nowMs, uint32_t staleMs, size_t budget) {
+    while (budget-- > 0) {
+      const size_t i = cursor_;
+      cursor_ = (cursor_ + 1) & (N - 1);
+      if (slots_[i].used && (nowMs - slots_[i].lastSeenMs) > staleMs) {
+        eraseAt(i);
+        sweptStale_++;
+      }
+    }
+  }
+
+  // Calls fn(const Slot&) for every occupied slot.
+  template <typename F>
+  void forEach(F fn) const {
+    for (size_t i = 0; i < N; i++) {
+      if (slots_[i].used) fn(slots_[i]);
+    }
+  }
+
+  size_t size() const { return size_; }
+  uint32_t staleReused() const { return staleReused_; }
+  uint32_t lruEvicted() const { return lruEvicted_; }
+  uint32_t sweptStale() const { return sweptStale_; }
+
+ private:
+  static constexpr size_t kNone = ~static_cast<size_t>(0);
+
+  static size_t homeOf(const uint8_t mac[6]) {
+    // Random addresses vary in every byte, public ones mostly in the low three:
+    // mix all six (murmur3 finalizer) before masking.
+    uint32_t h = (static_cast<uint32_t>(mac[0]) | (static_cast<uint32_t>(mac[1]) << 8) |
+                  (static_cast<uint32_t>(mac[2]) << 16) | (static_cast<uint32_t>(mac[3]) << 24)) ^
+                 ((static_cast<uint32_t>(mac[4]) | (static_cast<uint32_t>(mac[5]) << 8)) * 0x9E3779B1u);
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h & (N - 1);
+  }
+
+  // Backward-shift deletion: pull later chain members into the hole when that moves
+  // them no further from home, which also keeps every entry within kMaxProbe.
+  void eraseAt(size_t i) {
+    size_t j = i;
+    for (;;) {
+      j = (j + 1) & (N - 1);
+      if (!slots_[j].used) break;
+      const size_t home = homeOf(slots_[j].mac);
+      if (((j - home) & (N - 1)) >= ((j - i) & (N - 1))) {
+        slots_[i] = slots_[j];
+        i = j;
+      }
+    }
+    slots_[i] = Slot{};
+    size_--;
+  }
+
+  Slot slots_[N];
+  size_t size_ = 0;
+  size_t cursor_ = 0;
+  uint32_t staleReused_ = 0;
+  uint32_t lruEvicted_ = 0;
+  uint32_t sweptStale_ = 0;
+};
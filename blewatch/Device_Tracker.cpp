@@ -0,0 +1,128 @@
+#include "Device_Tracker.h"
+
+namespace {
+
+DeviceView makeView(const DeviceSlot& dev) {
+  DeviceView v;
+  memcpy(v.mac, dev.mac, sizeof(v.mac));
+  v.proxRssi = static_cast<int8_t>(proximityRssi(dev));
+  v.rawRssi = dev.lastRssi;
+  v.lastSeenMs = dev.lastSeenMs;
+  memcpy(v.name, dev.name, sizeof(v.name));
+  v.valid = true;
+  return v;
+}
+
+} // namespace
+
+int activeCount(const DeviceSummary& s, uint32_t nowMs) {
+  const uint32_t newest = activeEpoch(nowMs);
+  const uint32_t oldest = (nowMs > kDeviceStaleMs) ? activeEpoch(nowMs - kDeviceStaleMs) : 1;
+  int count = 0;
+  for (size_t i = 0; i < kActiveBuckets; i++) {
+    if (s.buckets[i].epoch >= oldest && s.buckets[i].epoch <= newest) count += s.buckets[i].count;
+  }
+  return count;
+}
+
+void DeviceTracker::uncountDevice(const DeviceSlot& dev) {
+  if (dev.countedEpoch == 0) return;
+  ActiveBucket& b = summary_.buckets[dev.countedEpoch % kActiveBuckets];
+  if (b.epoch == dev.countedEpoch && b.count > 0) b.count--;
+}
+
+void DeviceTracker::countDevice(DeviceSlot& dev, uint32_t nowMs) {
+  const uint32_t epoch = activeEpoch(nowMs);
+  ActiveBucket& b = summary_.buckets[epoch % kActiveBuckets];
+  if (b.epoch != epoch) {
+    b.epoch = epoch;  // Recycled: whatever it held is long past the stale window
+    b.count = 0;
+  }
+  b.count++;
+  dev.countedEpoch = epoch;
+}
+
+// The incremental best can only go up between rescans; this catches the strongest
+// device fading, leaving or being evicted.
+void DeviceTracker::rescan(uint32_t nowMs) {
+  const DeviceSlot* best = nullptr;
+  int bestRssi = -128;
+  devices_.forEach([&](const DeviceSlot& dev) {
+    if ((nowMs - dev.lastSeenMs) > kDeviceStaleMs) return;
+    const int r = proximityRssi(dev);
+    if (r > bestRssi) {
+      bestRssi = r;
+      best = &dev;
+    }
+  });
+  summary_.best = best ? makeView(*best) : DeviceView{};
+  DeviceSlot* sticky = isZeroMac(stickyMac_) ? nullptr : devices_.find(stickyMac_);
+  summary_.sticky = sticky ? makeView(*sticky) : DeviceView{};
+  lastRescanMs_ = nowMs;
+}
+
+void DeviceTracker::updateSummary(const DeviceSlot& dev, uint32_t nowMs) {
+  DeviceSummary& s = summary_;
+  const bool rescanDue = stickyChanged_ || (nowMs - lastRescanMs_) >= kBestRescanMs;
+  stickyChanged_ = false;
+
+  const DeviceView v = makeView(dev);
+  if (!s.best.valid || memcmp(s.best.mac, v.mac, 6) == 0 || v.proxRssi > s.best.proxRssi ||
+      (nowMs - s.best.lastSeenMs) > kDeviceStaleMs) {
+    s.best = v;
+  }
+  if (!isZeroMac(stickyMac_) && memcmp(stickyMac_, v.mac, 6) == 0) s.sticky = v;
+  if (rescanDue) rescan(nowMs);
+}
+
+bool DeviceTracker::onAdvert(const uint8_t mac[6], int rssi, const AdvInfo& adv, uint32_t nowMs) {
+  // Sweep first: it moves entries, and dev below must stay valid until summarised.
+  devices_.sweep(nowMs, kDeviceStaleMs, kDeviceSweepPerAdvert);
+
+  DeviceSlot replaced;
+  DeviceSlot* dev = devices_.upsert(mac, nowMs, kDeviceStaleMs, &replaced);
+  if (!dev) return false;
+  if (replaced.used) uncountDevice(replaced);  // Evicted to make room
+  uncountDevice(*dev);
+
+  dev->lastSeenMs = nowMs;
+  dev->lastRssi = static_cast<int8_t>(rssi);
+  if (adv.hasTxPower) dev->txPowerDbm = adv.txPowerDbm;
+  if (adv.hasCompanyId) dev->companyId = adv.companyId;
+
+  // Scan responses usually carry the name; keep it across plain adverts.
+  if (adv.name) {
+    const size_t n = (adv.nameLen < sizeof(dev->name) - 1) ? adv.nameLen : sizeof(dev->name) - 1;
+    memcpy(dev->name, adv.name, n);
+    dev->name[n] = '\0';
+  }
+
+  countDevice(*dev, nowMs);
+  updateSummary(*dev, nowMs);
+  return true;
+}
+
+void DeviceTracker::setSticky(const uint8_t mac[6]) {
+  memcpy(stickyMac_, mac, sizeof(stickyMac_));
+  stickyChanged_ = true;
+}
+
+DisplayChoice chooseDisplayed(const DeviceSummary& s, const uint8_t stickyMac[6], uint32_t nowMs,
+                              int veryCloseDbm, int marginDb) {
+  DisplayChoice c;
+  c.count = activeCount(s, nowMs);
+  c.device = (s.best.valid && (nowMs - s.best.lastSeenMs) <= kDeviceStaleMs) ? &s.best : nullptr;
+  const bool stickyLive = s.sticky.valid && (nowMs - s.sticky.lastSeenMs) <= kDeviceStaleMs &&
+                          memcmp(s.sticky.mac, stickyMac, 6) == 0;
+
+  // Stickiness logic: if the sticky device is still VERY CLOSE, keep it
+  // unless the new best is significantly stronger.
+  if (stickyLive && s.sticky.proxRssi >= veryCloseDbm) {
+    // Only switch if new best is > marginDb stronger.
+    if (!c.device || (memcmp(c.device->mac, s.sticky.mac, 6) != 0 && (c.device->proxRssi - s.sticky.proxRssi) <= marginDb)) {
+      c.device = &s.sticky;
+    }
+  }
+  if (c.count == 0 && c.device) c.count = 1;  // Bucket edge: never show a device next to a zero count
+  return c;
+}
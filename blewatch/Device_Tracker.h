@@ -0,0 +1,124 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "Device_Table.h"
+#include "Adv_Parser.h"
+
+// Scan-side device bookkeeping and the UI's display choice, free of Arduino, BLE and
+// LVGL so the firmware, the host tests (tests/) and the benchmarks (bench/) share it.
+//
+// DeviceTracker owns the device table and keeps a small DeviceSummary up to date on
+// every advertisement: the strongest device, the device the UI is locked on, and the
+// active count in time buckets so it ages out without a table walk. The firmware
+// publishes the summary through a SeqLock; chooseDisplayed() is what the UI runs on
+// its copy. Not thread-safe; one task feeds the tracker.
+
+// Device table (fixed size, no heap churn in callbacks). Power of two; up to 3/4 of it
+// is used before least-recently-seen devices are evicted. 256 covers busy venues with
+// hundreds of rotating random addresses (~11 KB of RAM).
+constexpr size_t kDeviceTableSize = 256;
+constexpr size_t kDeviceSweepPerAdvert = 2;  // Slots checked for stale entries per advertisement
+constexpr uint32_t kDeviceStaleMs = 3500;
+
+constexpr uint32_t kActiveBucketMs = 250;
+constexpr size_t kActiveBuckets = 16;
+constexpr uint32_t kBestRescanMs = 250;       // Full-table search for the strongest device
+
+// Advertised TX power is used to normalise RSSI to a kRefTxPowerDbm transmitter, so a
+// low-power beacon and a phone at the same distance land in the same proximity band.
+constexpr int8_t kTxPowerUnknown = 127;
+constexpr int kRefTxPowerDbm = 0;
+constexpr int kMaxTxCompensationDb = 20;  // Ignore implausible TX power values beyond this
+
+struct DeviceSlot {
+  uint8_t mac[6] = {0};         // Display order (most significant byte first)
+  uint32_t lastSeenMs = 0;
+  int8_t lastRssi = -127;
+  int8_t txPowerDbm = kTxPowerUnknown;
+  uint16_t companyId = 0xFFFF;  // Bluetooth SIG company identifier, 0xFFFF = none
+  char name[32] = {0};
+  uint32_t countedEpoch = 0;    // Active bucket this device is counted in, 0 = none
+  bool used = false;
+};
+
+// A device as the UI sees it: copied out of the table, so it stays valid on its own.
+struct DeviceView {
+  uint8_t mac[6];
+  int8_t proxRssi;   // TX-power-normalised (proximityRssi)
+  int8_t rawRssi;
+  uint32_t lastSeenMs;
+  char name[32];
+  bool valid;
+};
+
+struct ActiveBucket {
+  uint32_t epoch;    // activeEpoch() of the devices counted here
+  uint16_t count;    // Devices whose latest advertisement fell in this bucket
+};
+
+struct DeviceSummary {
+  DeviceView best;     // Strongest active device
+  DeviceView sticky;   // Device the UI is currently locked on (DeviceTracker::setSticky)
+  ActiveBucket buckets[kActiveBuckets];
+};
+static_assert(kActiveBuckets * kActiveBucketMs >= kDeviceStaleMs + 2 * kActiveBucketMs,
+              "active buckets must cover the stale window");
+
+using DeviceTableT = DeviceTable<DeviceSlot, kDeviceTableSize>;
+
+// RSSI the device would show with a kRefTxPowerDbm transmitter; raw RSSI when unknown.
+inline int proximityRssi(const DeviceSlot& dev) {
+  if (dev.txPowerDbm == kTxPowerUnknown) return dev.lastRssi;
+  int delta = kRefTxPowerDbm - dev.txPowerDbm;
+  if (delta > kMaxTxCompensationDb) delta = kMaxTxCompensationDb;
+  if (delta < -kMaxTxCompensationDb) delta = -kMaxTxCompensationDb;
+  const int rssi = dev.lastRssi + delta;
+  return (rssi > 0) ? 0 : rssi;
+}
+
+inline uint32_t activeEpoch(uint32_t ms) {
+  return ms / kActiveBucketMs + 1;  // 0 is reserved for "not counted"
+}
+
+inline bool isZeroMac(const uint8_t mac[6]) {
+  return (mac[0] | mac[1] | mac[2] | mac[3] | mac[4] | mac[5]) == 0;
+}
+
+// Devices whose latest advertisement is within the stale window.
+int activeCount(const DeviceSummary& s, uint32_t nowMs);
+
+class DeviceTracker {
+ public:
+  // Records one advertisement (adv may point into the stack's buffer; everything
+  // needed is copied). Returns false when the table had no room for a new device.
+  bool onAdvert(const uint8_t mac[6], int rssi, const AdvInfo& adv, uint32_t nowMs);
+
+  // Device the UI is locked on (all zeroes = none). Takes effect on the next advert.
+  void setSticky(const uint8_t mac[6]);
+
+  const DeviceSummary& summary() const { return summary_; }
+  const DeviceTableT& table() const { return devices_; }
+
+ private:
+  void countDevice(DeviceSlot& dev, uint32_t nowMs);
+  void uncountDevice(const DeviceSlot& dev);
+  void rescan(uint32_t nowMs);
+  void updateSummary(const DeviceSlot& dev, uint32_t nowMs);
+
+  DeviceTableT devices_;
+  DeviceSummary summary_{};
+  uint32_t lastRescanMs_ = 0;
+  uint8_t stickyMac_[6] = {0};
+  bool stickyChanged_ = false;
+};
+
+struct DisplayChoice {
+  int count;                  // Active devices (at least 1 when device is set)
+  const DeviceView* device;   // Into the summary passed in; null = nothing in range
+};
+
+// UI side: the device to show. The locked-on device (stickyMac) is kept while it is
+// still at or above veryCloseDbm, unless another is more than marginDb stronger.
+DisplayChoice chooseDisplayed(const DeviceSummary& s, const uint8_t stickyMac[6], uint32_t nowMs,
+                              int veryCloseDbm, int marginDb);
@@ -1,159 +1,285 @@
 #include "Display_ST7789.h"
+#include "Boot_Timing.h"
    
-#define SPI_WRITE(_dat)         SPI.transfer(_dat)
-#define SPI_WRITE_Word(_dat)    SPI.transfer16(_dat)
+#include <driver/spi_master.h>
+#include <driver/gpio.h>
+#include <soc/gpio_reg.h>
+#include <soc/soc.h>
+#include <string.h>
+
+/******************************************************************************
+  SPI transport: IDF spi_master on SPI2_HOST with DMA.
+  Commands and init parameters go out as short polling transactions. Pixel
+  data is queued: LCD_addWindowAsync() returns once the window commands and the
+  DMA transfer are queued, and the done callback runs from the SPI interrupt
+  after the last byte has left, so LVGL can render into its other buffer while
+  this one is on the wire.
+******************************************************************************/
+#define LCD_SPI_HOST          SPI2_HOST
+#define LCD_SPI_QUEUE_LEN     8
+#define LCD_MAX_TRANSFER_SZ   (LCD_WIDTH * LCD_HEIGHT * 2)
+
+// spi_transaction_t::user flags, read by the pre/post callbacks.
+#define LCD_TRANS_DC          0x1   // D/C high (data)
+#define LCD_TRANS_NOTIFY      0x2   // Pixel transfer of an async window
+
+static spi_device_handle_t lcdSpi = NULL;
+static spi_transaction_t lcdWindowTrans[6];   // CASET, params, RASET, params, RAMWR, pixels
+static uint8_t lcdPending = 0;                // Queued transactions not yet reclaimed
+static LCD_FlushDoneCb lcdDoneCb = NULL;
+static void* lcdDoneArg = NULL;
+
+// Direct set/clear register write: DC flips before every transaction, often from the ISR.
+static inline void LCD_SetDC(bool data)
+{
+  REG_WRITE(data ? GPIO_OUT_W1TS_REG : GPIO_OUT_W1TC_REG, 1u << EXAMPLE_PIN_NUM_LCD_DC);
+}
+
+static void lcdSpiPreCb(spi_transaction_t* t)
+{
+  LCD_SetDC(((uintptr_t)t->user & LCD_TRANS_DC) != 0);
+}
+
+static void lcdSpiPostCb(spi_transaction_t* t)
+{
+  if (((uintptr_t)t->user & LCD_TRANS_NOTIFY) && lcdDoneCb) lcdDoneCb(lcdDoneArg);
+}
+
 void SPI_Init()
 {
-  SPI.begin(EXAMPLE_PIN_NUM_SCLK,EXAMPLE_PIN_NUM_MISO,EXAMPLE_PIN_NUM_MOSI); 
+  spi_bus_config_t bus = {};
+  bus.mosi_io_num = EXAMPLE_PIN_NUM_MOSI;
+  bus.miso_io_num = EXAMPLE_PIN_NUM_MISO;
+  bus.sclk_io_num = EXAMPLE_PIN_NUM_SCLK;
+  bus.quadwp_io_num = -1;
+  bus.quadhd_io_num = -1;
+  bus.max_transfer_sz = LCD_MAX_TRANSFER_SZ;
+  // No ESP_INTR_FLAG_IRAM: the done callback calls into LVGL, which lives in flash.
+  spi_bus_initialize(LCD_SPI_HOST, &bus, SPI_DMA_CH_AUTO);
+
+  spi_device_interface_config_t dev = {};
+  dev.mode = 0;
+  dev.clock_speed_hz = SPIFreq;
+  dev.spics_io_num = EXAMPLE_PIN_NUM_LCD_CS;
+  dev.queue_size = LCD_SPI_QUEUE_LEN;
+  dev.pre_cb = lcdSpiPreCb;
+  dev.post_cb = lcdSpiPostCb;
+  spi_bus_add_device(LCD_SPI_HOST, &dev, &lcdSpi);
+}
+
+// Reclaim every queued transaction; blocks until the last one has finished.
+void LCD_WaitIdle(void)
+{
+  spi_transaction_t* done;
+  while (lcdPending > 0) {
+    if (spi_device_get_trans_result(lcdSpi, &done, portMAX_DELAY) != ESP_OK) break;
+    lcdPending--;
+  }
+}
+
+static void LCD_PollTx(const uint8_t* data, size_t len, uintptr_t flags, bool keepCs)
+{
+  spi_transaction_t t;
+  memset(&t, 0, sizeof(t));
+  t.length = len * 8;
+  t.user = (void*)flags;
+  if (keepCs) t.flags |= SPI_TRANS_CS_KEEP_ACTIVE;
+  if (len <= sizeof(t.tx_data)) {
+    t.flags |= SPI_TRANS_USE_TXDATA;
+    memcpy(t.tx_data, data, len);
+  } else {
+    t.tx_buffer = data;
+  }
+  spi_device_polling_transmit(lcdSpi, &t);
+}
+
+static void LCD_Transmit(const uint8_t* data, size_t len, uintptr_t flags)
+{
+  if (len == 0) return;
+  LCD_WaitIdle();   // Keep ordering with any queued window
+  LCD_PollTx(data, len, flags, false);
+}
+
+// CS stays asserted from the first command byte to the last parameter byte
+// (SPI_TRANS_CS_KEEP_ACTIVE needs the bus acquired for the whole list).
+void LCD_WriteCommandList(const LCD_Cmd* cmds, uint8_t count)
+{
+  if (count == 0) return;
+  LCD_WaitIdle();
+  spi_device_acquire_bus(lcdSpi, portMAX_DELAY);
+  for (uint8_t i = 0; i < count; i++) {
+    const LCD_Cmd& c = cmds[i];
+    const bool last = (i + 1 == count);
+    LCD_PollTx(&c.cmd, 1, 0, !(last && c.len == 0));
+    if (c.len) LCD_PollTx(c.data, c.len, LCD_TRANS_DC, !last);
+  }
+  spi_device_release_bus(lcdSpi);
 }
 
 void LCD_WriteCommand(uint8_t Cmd)  
 { 
-  SPI.beginTransaction(SPISettings(SPIFreq, MSBFIRST, SPI_MODE0));
-  digitalWrite(EXAMPLE_PIN_NUM_LCD_CS, LOW);  
-  digitalWrite(EXAMPLE_PIN_NUM_LCD_DC, LOW); 
-  SPI_WRITE(Cmd);
-  digitalWrite(EXAMPLE_PIN_NUM_LCD_CS, HIGH);  
-  SPI.endTransaction();
+  LCD_Transmit(&Cmd, 1, 0);
 }
 void LCD_WriteData(uint8_t Data) 
 { 
-  SPI.beginTransaction(SPISettings(SPIFreq, MSBFIRST, SPI_MODE0));
-  digitalWrite(EXAMPLE_PIN_NUM_LCD_CS, LOW);  
-  digitalWrite(EXAMPLE_PIN_NUM_LCD_DC, HIGH);  
-  SPI_WRITE(Data);  
-  digitalWrite(EXAMPLE_PIN_NUM_LCD_CS, HIGH);  
-  SPI.endTransaction();
+  LCD_Transmit(&Data, 1, LCD_TRANS_DC);
 }    
 void LCD_WriteData_Word(uint16_t Data)
 {
-  SPI.beginTransaction(SPISettings(SPIFreq, MSBFIRST, SPI_MODE0));
-  digitalWrite(EXAMPLE_PIN_NUM_LCD_CS, LOW);  
-  digitalWrite(EXAMPLE_PIN_NUM_LCD_DC, HIGH); 
-  SPI_WRITE_Word(Data);
-  digitalWrite(EXAMPLE_PIN_NUM_LCD_CS, HIGH);  
-  SPI.endTransaction();
+  const uint8_t bytes[2] = {(uint8_t)(Data >> 8), (uint8_t)Data};
+  LCD_Transmit(bytes, 2, LCD_TRANS_DC);
 }   
 void LCD_WriteData_nbyte(uint8_t* SetData,uint8_t* ReadData,uint32_t Size) 
 { 
-  SPI.beginTransaction(SPISettings(SPIFreq, MSBFIRST, SPI_MODE0));
-  digitalWrite(EXAMPLE_PIN_NUM_LCD_CS, LOW);  
-  digitalWrite(EXAMPLE_PIN_NUM_LCD_DC, HIGH);  
-  // On ESP32 Arduino, SPIClass supports writeBytes() which avoids needing a read buffer.
-  // This is important because LVGL flushes can be large (full screen), and allocating
-  // a matching read buffer on the stack can crash.
-  SPI.writeBytes(SetData, Size);
-  digitalWrite(EXAMPLE_PIN_NUM_LCD_CS, HIGH);  
-  SPI.endTransaction();
+  (void)ReadData;
+  LCD_Transmit(SetData, Size, LCD_TRANS_DC);
 } 
 
-void LCD_Reset(void)
+/******************************************************************************
+  Panel init sequence.
+  Each entry is one command, its parameter bytes and the settle time to wait
+  before the next entry. Runs of entries without a settle time go out as one
+  command list. LCD_InitStep() walks this table without blocking, so
+  capture/scan tasks and the rest of setup() are not held up by panel delays.
+******************************************************************************/
+#if LCD_ORIENTATION == HORIZONTAL
+#define LCD_MADCTL 0x00
+#else
+#define LCD_MADCTL 0x70
+#endif
+
+static const LCD_Cmd kInitSequence[] = {
+  {0x11, 0,  {0}, 120},                                   // Sleep out
+  {0x36, 1,  {LCD_MADCTL}, 0},                            // MADCTL
+  {0x3A, 1,  {0x05}, 0},                                  // RGB565
+  {0xB0, 2,  {0x00, 0xE8}, 0},
+  {0xB2, 5,  {0x0C, 0x0C, 0x00, 0x33, 0x33}, 0},
+  {0xB7, 1,  {0x35}, 0},
+  {0xBB, 1,  {0x35}, 0},
+  {0xC0, 1,  {0x2C}, 0},
+  {0xC2, 1,  {0x01}, 0},
+  {0xC3, 1,  {0x13}, 0},
+  {0xC4, 1,  {0x20}, 0},
+  {0xC6, 1,  {0x0F}, 0},
+  {0xD0, 2,  {0xA4, 0xA1}, 0},
+  {0xD6, 1,  {0xA1}, 0},
+  {0xE0, 14, {0xF0, 0x00, 0x04, 0x04, 0x04, 0x05, 0x29, 0x33, 0x3E, 0x38, 0x12, 0x12, 0x28, 0x30}, 0},
+  {0xE1, 14, {0xF0, 0x07, 0x0A, 0x0D, 0x0B, 0x07, 0x28, 0x33, 0x3E, 0x36, 0x14, 0x14, 0x29, 0x32}, 0},
+  {0x21, 0,  {0}, 0},                                     // Inversion on
+  {0x11, 0,  {0}, 5},                                     // Already awake: 5 ms before next command
+  {0x29, 0,  {0}, 0},                                     // Display on
+};
+static const uint8_t kInitSequenceLen = sizeof(kInitSequence) / sizeof(kInitSequence[0]);
+
+// Reset timing: RST low >= 10 us, then 120 ms before Sleep Out (worst case per datasheet).
+#define LCD_RESET_LOW_MS       10
+#define LCD_RESET_SETTLE_MS    120
+
+enum LCD_InitState : uint8_t {
+  LCD_INIT_IDLE,
+  LCD_INIT_RESET_LOW,
+  LCD_INIT_RESET_SETTLE,
+  LCD_INIT_SEQUENCE,
+  LCD_INIT_DONE,
+};
+
+static LCD_InitState lcdInitState = LCD_INIT_IDLE;
+static uint8_t lcdInitIndex = 0;
+static uint32_t lcdWaitStartMs = 0;
+static uint32_t lcdWaitMs = 0;
+
+static void LCD_StartWait(uint32_t ms)
 {
-  digitalWrite(EXAMPLE_PIN_NUM_LCD_CS, LOW);       
-  delay(50);
-  digitalWrite(EXAMPLE_PIN_NUM_LCD_RST, LOW); 
-  delay(50);
-  digitalWrite(EXAMPLE_PIN_NUM_LCD_RST, HIGH); 
-  delay(50);
+  lcdWaitStartMs = millis();
+  lcdWaitMs = ms;
 }
-void LCD_Init(void)
+
+static bool LCD_WaitElapsed(void)
 {
-  pinMode(EXAMPLE_PIN_NUM_LCD_CS, OUTPUT);
-  pinMode(EXAMPLE_PIN_NUM_LCD_DC, OUTPUT);
+  return (millis() - lcdWaitStartMs) >= lcdWaitMs;
+}
+
+void LCD_InitAsync(void)
+{
+  if (lcdInitState != LCD_INIT_IDLE) return;
+  pinMode(EXAMPLE_PIN_NUM_LCD_DC, OUTPUT);   // CS is driven by the SPI peripheral
   pinMode(EXAMPLE_PIN_NUM_LCD_RST, OUTPUT); 
   Backlight_Init();
   SPI_Init();
 
-  LCD_Reset();
-  //************* Start Initial Sequence **********// 
-  LCD_WriteCommand(0x11);
-  delay(120);
-  LCD_WriteCommand(0x36);
-  if (HORIZONTAL)
-      LCD_WriteData(0x00);
-  else
-      LCD_WriteData(0x70);
-
-  LCD_WriteCommand(0x3A);
-  LCD_WriteData(0x05);
-
-  LCD_WriteCommand(0xB0);
-  LCD_WriteData(0x00);
-  LCD_WriteData(0xE8);
-  
-  LCD_WriteCommand(0xB2);
-  LCD_WriteData(0x0C);
-  LCD_WriteData(0x0C);
-  LCD_WriteData(0x00);
-  LCD_WriteData(0x33);
-  LCD_WriteData(0x33);
-
-  LCD_WriteCommand(0xB7);
-  LCD_WriteData(0x35);
-
-  LCD_WriteCommand(0xBB);
-  LCD_WriteData(0x35);
-
-  LCD_WriteCommand(0xC0);
-  LCD_WriteData(0x2C);
-
-  LCD_WriteCommand(0xC2);
-  LCD_WriteData(0x01);
-
-  LCD_WriteCommand(0xC3);
-  LCD_WriteData(0x13);
-
-  LCD_WriteCommand(0xC4);
-  LCD_WriteData(0x20);
-
-  LCD_WriteCommand(0xC6);
-  LCD_WriteData(0x0F);
-
-  LCD_WriteCommand(0xD0);
-  LCD_WriteData(0xA4);
-  LCD_WriteData(0xA1);
-
-  LCD_WriteCommand(0xD6);
-  LCD_WriteData(0xA1);
-
-  LCD_WriteCommand(0xE0);
-  LCD_WriteData(0xF0);
-  LCD_WriteData(0x00);
-  LCD_WriteData(0x04);
-  LCD_WriteData(0x04);
-  LCD_WriteData(0x04);
-  LCD_WriteData(0x05);
-  LCD_WriteData(0x29);
-  LCD_WriteData(0x33);
-  LCD_WriteData(0x3E);
-  LCD_WriteData(0x38);
-  LCD_WriteData(0x12);
-  LCD_WriteData(0x12);
-  LCD_WriteData(0x28);
-  LCD_WriteData(0x30);
-
-  LCD_WriteCommand(0xE1);
-  LCD_WriteData(0xF0);
-  LCD_WriteData(0x07);
-  LCD_WriteData(0x0A);
-  LCD_WriteData(0x0D);
-  LCD_WriteData(0x0B);
-  LCD_WriteData(0x07);
-  LCD_WriteData(0x28);
-  LCD_WriteData(0x33);
-  LCD_WriteData(0x3E);
-  LCD_WriteData(0x36);
-  LCD_WriteData(0x14);
-  LCD_WriteData(0x14);
-  LCD_WriteData(0x29);
-  LCD_WriteData(0x32);
-
-  LCD_WriteCommand(0x21);
-
-  LCD_WriteCommand(0x11);
-  delay(120);
-  LCD_WriteCommand(0x29); 
+  digitalWrite(EXAMPLE_PIN_NUM_LCD_RST, LOW);
+  LCD_StartWait(LCD_RESET_LOW_MS);
+  lcdInitState = LCD_INIT_RESET_LOW;
+}
+
+bool LCD_InitStep(void)
+{
+  switch (lcdInitState) {
+    case LCD_INIT_IDLE:
+      LCD_InitAsync();
+      return false;
+    case LCD_INIT_RESET_LOW:
+      if (!LCD_WaitElapsed()) return false;
+      digitalWrite(EXAMPLE_PIN_NUM_LCD_RST, HIGH);
+      LCD_StartWait(LCD_RESET_SETTLE_MS);
+      lcdInitState = LCD_INIT_RESET_SETTLE;
+      return false;
+    case LCD_INIT_RESET_SETTLE:
+      if (!LCD_WaitElapsed()) return false;
+      lcdInitIndex = 0;
+      LCD_StartWait(0);
+      lcdInitState = LCD_INIT_SEQUENCE;
+      // fall through
+    case LCD_INIT_SEQUENCE:
+      // Send every entry whose predecessor's settle time has elapsed.
+      while (LCD_WaitElapsed()) {
+        if (lcdInitIndex >= kInitSequenceLen) {
+          lcdInitState = LCD_INIT_DONE;
+          Boot_Mark("panel ready");
+          return true;
+        }
+        // Batch up to and including the next entry that needs a settle time.
+        uint8_t end = lcdInitIndex;
+        while (end + 1 < kInitSequenceLen && kInitSequence[end].delayMs == 0) end++;
+        LCD_WriteCommandList(&kInitSequence[lcdInitIndex], end - lcdInitIndex + 1);
+        LCD_StartWait(kInitSequence[end].delayMs);
+        lcdInitIndex = end + 1;
+      }
+      return false;
+    case LCD_INIT_DONE:
+      return true;
+  }
+  return false;
+}
+
+bool LCD_IsReady(void)
+{
+  return lcdInitState == LCD_INIT_DONE;
+}
+
+// Blocking variant: runs the same sequence to completion.
+void LCD_Init(void)
+{
+  LCD_InitAsync();
+  while (!LCD_InitStep()) {
+    delay(1);
+  }
+}
+// CASET / RASET parameters for a window (panel offsets applied, big-endian).
+static void LCD_WindowParams(uint16_t Xstart, uint16_t Ystart, uint16_t Xend, uint16_t Yend,
+                             uint8_t col[4], uint8_t row[4])
+{
+#if LCD_ORIENTATION == HORIZONTAL
+  const uint16_t c0 = Xstart + Offset_X, c1 = Xend + Offset_X;
+  const uint16_t r0 = Ystart + Offset_Y, r1 = Yend + Offset_Y;
+#else
+  const uint16_t c0 = Ystart + Offset_Y, c1 = Yend + Offset_Y;
+  const uint16_t r0 = Xstart + Offset_X, r1 = Xend + Offset_X;
+#endif
+  col[0] = c0 >> 8; col[1] = c0 & 0xFF; col[2] = c1 >> 8; col[3] = c1 & 0xFF;
+  row[0] = r0 >> 8; row[1] = r0 & 0xFF; row[2] = r1 >> 8; row[3] = r1 & 0xFF;
 }
+
 /******************************************************************************
 function: Set the cursor position
 parameter :
@@ -164,39 +290,60 @@ parameter :
 ******************************************************************************/
 void LCD_SetCursor(uint16_t Xstart, uint16_t Ystart, uint16_t Xend, uint16_t  Yend)
 { 
-  if (HORIZONTAL) {
-    // set the X coordinates
-    LCD_WriteCommand(0x2A);
-    LCD_WriteData(Xstart >> 8);
-    LCD_WriteData(Xstart + Offset_X);
-    LCD_WriteData(Xend >> 8);
-    LCD_WriteData(Xend + Offset_X);
-    
-    // set the Y coordinates
-    LCD_WriteCommand(0x2B);
-    LCD_WriteData(Ystart >> 8);
-    LCD_WriteData(Ystart + Offset_Y);
-    LCD_WriteData(Yend >> 8);
-    LCD_WriteData(Yend + Offset_Y);
-  }
-  else {
-    // set the X coordinates
-    LCD_WriteCommand(0x2A);
-    LCD_WriteData(Ystart >> 8);
-    LCD_WriteData(Ystart + Offset_Y);
-    LCD_WriteData(Yend >> 8);
-    LCD_WriteData(Yend + Offset_Y);
-    // set the Y coordinates
-    LCD_WriteCommand(0x2B);
-    LCD_WriteData(Xstart >> 8);
-    LCD_WriteData(Xstart + Offset_X);
-    LCD_WriteData(Xend >> 8);
-    LCD_WriteData(Xend + Offset_X);
+  LCD_Cmd cmds[3] = {{0x2A, 4, {0}, 0}, {0x2B, 4, {0}, 0}, {0x2C, 0, {0}, 0}};
+  LCD_WindowParams(Xstart, Ystart, Xend, Yend, cmds[0].data, cmds[1].data);
+  LCD_WriteCommandList(cmds, 3);
+}
+
+static void LCD_FillTrans(spi_transaction_t* t, const uint8_t* small, size_t len, uintptr_t flags)
+{
+  memset(t, 0, sizeof(*t));
+  t->length = len * 8;
+  t->user = (void*)flags;
+  t->flags = SPI_TRANS_USE_TXDATA;
+  memcpy(t->tx_data, small, len);
+}
+
+/******************************************************************************
+function: Queue an area refresh and return immediately
+parameter :
+    Xstart..Yend: Area (inclusive)
+    color :   Pixel data; must stay untouched until cb runs
+    cb    :   Called from the SPI interrupt once the pixels are on the wire
+******************************************************************************/
+void LCD_addWindowAsync(uint16_t Xstart, uint16_t Ystart, uint16_t Xend, uint16_t Yend,
+                        const uint16_t* color, LCD_FlushDoneCb cb, void* arg)
+{
+  LCD_WaitIdle();   // Reclaim the previous window; LVGL only flushes after its cb fired
+  uint8_t col[4], row[4];
+  const uint8_t caset = 0x2A, raset = 0x2B, ramwr = 0x2C;
+  LCD_WindowParams(Xstart, Ystart, Xend, Yend, col, row);
+  LCD_FillTrans(&lcdWindowTrans[0], &caset, 1, 0);
+  LCD_FillTrans(&lcdWindowTrans[1], col, 4, LCD_TRANS_DC);
+  LCD_FillTrans(&lcdWindowTrans[2], &raset, 1, 0);
+  LCD_FillTrans(&lcdWindowTrans[3], row, 4, LCD_TRANS_DC);
+  LCD_FillTrans(&lcdWindowTrans[4], &ramwr, 1, 0);
+
+  const uint32_t numBytes = (uint32_t)(Xend - Xstart + 1) * (Yend - Ystart + 1) * sizeof(uint16_t);
+  spi_transaction_t* px = &lcdWindowTrans[5];
+  memset(px, 0, sizeof(*px));
+  px->length = numBytes * 8;
+  px->tx_buffer = color;
+  px->user = (void*)(uintptr_t)(LCD_TRANS_DC | LCD_TRANS_NOTIFY);
+
+  lcdDoneCb = cb;
+  lcdDoneArg = arg;
+  for (uint8_t i = 0; i < 6; i++) {
+    if (spi_device_queue_trans(lcdSpi, &lcdWindowTrans[i], portMAX_DELAY) != ESP_OK) {
+      if (cb) cb(arg);   // Never leave LVGL waiting on a flush that will not complete
+      return;
+    }
+    lcdPending++;
   }
-  LCD_WriteCommand(0x2C);
 }
+
 /******************************************************************************
-function: Refresh the image in an area
+function: Refresh the image in an area (blocking)
 parameter :
     Xstart:   Start uint16_t x coordinate
     Ystart:   Start uint16_t y coordinate
@@ -206,21 +353,84 @@ parameter :
 ******************************************************************************/
 void LCD_addWindow(uint16_t Xstart, uint16_t Ystart, uint16_t Xend, uint16_t Yend,uint16_t* color)
 {          
-  // uint16_t i,j;
-  // LCD_SetCursor(Xstart, Ystart, Xend,Yend);
-  // uint16_t Show_Width = Xend - Xstart + 1;
-  // uint16_t Show_Height = Yend - Ystart + 1;
-  // for(i = 0; i < Show_Height; i++){               
-  //   for(j = 0; j < Show_Width; j++){
-  //     LCD_WriteData_Word(color[(i*(Show_Width))+j]);                           
-  //   }
-  // }           
-  uint16_t Show_Width = Xend - Xstart + 1;
-  uint16_t Show_Height = Yend - Ystart + 1;
-  uint32_t numBytes = Show_Width * Show_Height * sizeof(uint16_t);
-  LCD_SetCursor(Xstart, Ystart, Xend, Yend);
-  LCD_WriteData_nbyte((uint8_t*)color, nullptr, numBytes);        
+  LCD_addWindowAsync(Xstart, Ystart, Xend, Yend, color, NULL, NULL);
+  LCD_WaitIdle();
+}
+/******************************************************************************
+  Vertical scrolling.
+  The panel shows frame-memory row (top + (y - top + offset) % lines) at screen
+  row y inside the region. New rows go in just above the current start, which
+  then moves up onto them, so they appear at the top and everything else slides
+  down one row per row pushed; the oldest rows drop off the bottom.
+******************************************************************************/
+static uint16_t lcdScrollTop = 0;
+static uint16_t lcdScrollLines = 0;   // 0 = no region
+static uint16_t lcdScrollOffset = 0;  // Region row shown at its top
+
+static void LCD_ScrollStart(void)
+{
+  const uint16_t vsp = lcdScrollTop + lcdScrollOffset;
+  const LCD_Cmd cmd = {0x37, 2, {(uint8_t)(vsp >> 8), (uint8_t)vsp}, 0};   // VSCSAD
+  LCD_WriteCommandList(&cmd, 1);
+}
+
+bool LCD_ScrollDefine(uint16_t top, uint16_t lines)
+{
+#if LCD_CAN_SCROLL
+  if (lines == 0 || top + lines > LCD_SCROLL_LINES) return false;
+  const uint16_t bottom = LCD_SCROLL_LINES - top - lines;
+  const LCD_Cmd cmd = {0x33, 6, {(uint8_t)(top >> 8), (uint8_t)top, (uint8_t)(lines >> 8), (uint8_t)lines,
+                                 (uint8_t)(bottom >> 8), (uint8_t)bottom}, 0};   // VSCRDEF
+  LCD_WriteCommandList(&cmd, 1);
+  lcdScrollTop = top;
+  lcdScrollLines = lines;
+  lcdScrollOffset = 0;
+  LCD_ScrollStart();
+  return true;
+#else
+  (void)top;
+  (void)lines;
+  return false;   // MV swaps the axes: the panel would scroll sideways
+#endif
 }
+
+void LCD_ScrollReset(void)
+{
+  if (lcdScrollLines == 0) return;
+  const LCD_Cmd cmds[2] = {
+    {0x33, 6, {0x00, 0x00, (uint8_t)(LCD_SCROLL_LINES >> 8), (uint8_t)LCD_SCROLL_LINES, 0x00, 0x00}, 0},
+    {0x37, 2, {0x00, 0x00}, 0},
+  };
+  LCD_WriteCommandList(cmds, 2);
+  lcdScrollTop = 0;
+  lcdScrollLines = 0;
+  lcdScrollOffset = 0;
+}
+
+bool LCD_ScrollRegion(uint16_t* top, uint16_t* lines)
+{
+  if (lcdScrollLines == 0) return false;
+  *top = lcdScrollTop;
+  *lines = lcdScrollLines;
+  return true;
+}
+
+void LCD_ScrollPushRows(const uint16_t* color, uint16_t rows)
+{
+  if (lcdScrollLines == 0 || rows == 0) return;
+  if (rows > lcdScrollLines) rows = lcdScrollLines;
+  lcdScrollOffset = (lcdScrollOffset + lcdScrollLines - rows) % lcdScrollLines;
+  // The new rows start at the new offset and may wrap past the end of the region.
+  const uint16_t first = (rows < lcdScrollLines - lcdScrollOffset) ? rows : lcdScrollLines - lcdScrollOffset;
+  const uint16_t y = lcdScrollTop + lcdScrollOffset;
+  LCD_addWindow(0, y, LCD_WIDTH - 1, y + first - 1, (uint16_t*)color);
+  if (first < rows) {
+    LCD_addWindow(0, lcdScrollTop, LCD_WIDTH - 1, lcdScrollTop + rows - first - 1,
+                  (uint16_t*)color + (size_t)first * LCD_WIDTH);
+  }
+  LCD_ScrollStart();
+}
+
 // backlight
 void Backlight_Init(void)
 {
@@ -0,0 +1,68 @@
+#pragma once
+#include <Arduino.h>
+#include <esp_cpu.h>
+
+// Hot-path statistics registry: named cycle timers and counters plus heap and per-task
+// figures, dumped as one compact JSON line on serial (Stats_Dump), e.g.
+//   {"stats":"bandwatch","t":61234,"win":10012,"mhz":160,"heap":[81234,70112],
+//    "timers":{"promisc":[41236,1840,9210]},"counters":{"frames":[412345,4119]},
+//    "tasks":{"wifi":[12,1480],"IDLE":[71,812]}}
+// timers:   [calls in window, mean ns, max ns]   (max resets every dump)
+// counters: [total, per second over the window]
+// tasks:    [CPU % over the window (0 without FreeRTOS run-time stats), min free stack B]
+// heap:     [free, minimum free since boot]
+// The window is the time since the previous dump.
+//
+// Recording is a cycle-counter read and three adds, so timers can stay in IRAM
+// callbacks in production builds. A timer must have a single writer at a time (one
+// task, or only under the lock it measures). HOT_STATS 0 compiles the recording out.
+
+#ifndef HOT_STATS
+#define HOT_STATS 1
+#endif
+
+// Periodic dump on serial in ms (0 = only on demand).
+#ifndef HOT_STATS_REPORT_MS
+#define HOT_STATS_REPORT_MS 0
+#endif
+
+typedef struct {
+  uint32_t count;
+  uint32_t cycles;      // Wraps; only window deltas are reported
+  uint32_t maxCycles;
+} Stats_Timer;
+
+typedef uint32_t (*Stats_CounterFn)(void);
+
+static inline uint32_t Stats_Cycles(void)
+{
+#if HOT_STATS
+  return esp_cpu_get_cycle_count();
+#else
+  return 0;
+#endif
+}
+
+// Adds the time since startCycles (from Stats_Cycles) to t.
+static inline void Stats_TimerAdd(Stats_Timer* t, uint32_t startCycles)
+{
+#if HOT_STATS
+  const uint32_t c = esp_cpu_get_cycle_count() - startCycles;
+  t->count++;
+  t->cycles += c;
+  if (c > t->maxCycles) t->maxCycles = c;
+#else
+  (void)t;
+  (void)startCycles;
+#endif
+}
+
+// Names must stay valid (string literals). Registration is meant for init time.
+void Stats_Init(const char* app);
+void Stats_AddTimer(const char* name, Stats_Timer* t);
+void Stats_AddCounter(const char* name, Stats_CounterFn read);
+
+// Prints one JSON line. Call from a single task (serial command handler).
+void Stats_Dump(void);
+// Calls Stats_Dump every HOT_STATS_REPORT_MS; cheap to call often.
+void Stats_Poll(void);
@@ -7,12 +7,112 @@
 #include "LVGL_Driver.h"
 
 #include "blewatch.h"
+#include "Boot_Timing.h"
+#include "UI_Cache.h"
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#if LVGL_PERF_HUD
+#include <string.h>
+#endif
 
-static lv_color_t buf1[ LVGL_BUF_LEN ];
-static lv_color_t buf2[ LVGL_BUF_LEN ];
+// Two render buffers: LVGL draws into one while the other is on the SPI DMA.
+// Internal SRAM is DMA-capable on the C6; 4-byte alignment keeps DMA descriptors happy.
+static lv_color_t buf1[ LVGL_BUF_LEN ] __attribute__((aligned(4)));
+static lv_color_t buf2[ LVGL_BUF_LEN ] __attribute__((aligned(4)));
 // static lv_color_t* buf1 = (lv_color_t*) heap_caps_malloc(LVGL_BUF_LEN, MALLOC_CAP_SPIRAM);
 // static lv_color_t* buf2 = (lv_color_t*) heap_caps_malloc(LVGL_BUF_LEN, MALLOC_CAP_SPIRAM);
 
+#if LVGL_PERF_HUD
+struct PerfWindow {
+  uint32_t renderUs;
+  uint32_t flushes;
+  uint32_t flushBytes;
+  uint32_t spiUs;          // Added from the SPI interrupt
+  uint32_t handlerUs;
+  uint32_t handlerMaxUs;
+};
+
+static PerfWindow perf;
+static portMUX_TYPE perfMux = portMUX_INITIALIZER_UNLOCKED;
+static int64_t perfWindowStartUs = 0;
+static int64_t perfRenderStartUs = 0;
+static int64_t perfFlushQueuedUs = 0;
+static lv_obj_t * perfLabel = NULL;
+
+static void Perf_RenderEvent(lv_event_t * e)
+{
+  const int64_t now = esp_timer_get_time();
+  if (lv_event_get_code(e) == LV_EVENT_RENDER_START) {
+    perfRenderStartUs = now;
+  } else if (perfRenderStartUs != 0) {
+    perf.renderUs += (uint32_t)(now - perfRenderStartUs);
+    perfRenderStartUs = 0;
+  }
+}
+
+static void Perf_Init(lv_display_t * disp)
+{
+  lv_display_add_event_cb(disp, Perf_RenderEvent, LV_EVENT_RENDER_START, NULL);
+  lv_display_add_event_cb(disp, Perf_RenderEvent, LV_EVENT_RENDER_READY, NULL);
+  perfLabel = lv_label_create(lv_layer_top());
+  lv_label_set_text(perfLabel, "");
+  lv_obj_set_style_text_color(perfLabel, lv_color_hex(0xFFFF00), 0);
+  lv_obj_set_style_bg_color(perfLabel, lv_color_hex(0x000000), 0);
+  lv_obj_set_style_bg_opa(perfLabel, LV_OPA_70, 0);
+  lv_obj_align(perfLabel, LV_ALIGN_BOTTOM_LEFT, 0, 0);
+  printf("perf: buf %u px x2, render mode %d, spi %lu Hz\r\n",
+         (unsigned)LVGL_BUF_LEN, (int)LVGL_RENDER_MODE, (unsigned long)SPIFreq);
+  perfWindowStartUs = esp_timer_get_time();
+}
+
+static inline void Perf_FlushQueued(const lv_area_t * area)
+{
+  perfFlushQueuedUs = esp_timer_get_time();
+  perf.flushes++;
+  perf.flushBytes += (uint32_t)lv_area_get_width(area) * lv_area_get_height(area) * 2;
+}
+
+static inline void Perf_FlushDone(void)
+{
+  const uint32_t us = (uint32_t)(esp_timer_get_time() - perfFlushQueuedUs);
+  portENTER_CRITICAL_ISR(&perfMux);
+  perf.spiUs += us;
+  portEXIT_CRITICAL_ISR(&perfMux);
+}
+
+static void Perf_Handler(uint32_t handlerUs)
+{
+  perf.handlerUs += handlerUs;
+  if (handlerUs > perf.handlerMaxUs) perf.handlerMaxUs = handlerUs;
+
+  const int64_t now = esp_timer_get_time();
+  const uint32_t windowUs = (uint32_t)(now - perfWindowStartUs);
+  if (windowUs < 1000000) return;
+  portENTER_CRITICAL(&perfMux);
+  const PerfWindow w = perf;
+  memset(&perf, 0, sizeof(perf));
+  portEXIT_CRITICAL(&perfMux);
+  perfWindowStartUs = now;
+
+  // Idle slack: share of the window Timer_Loop spent outside lv_timer_handler.
+  const uint32_t idlePct = (w.handlerUs >= windowUs) ? 0 : 100 - (uint32_t)((uint64_t)w.handlerUs * 100 / windowUs);
+  printf("perf: render %lu us | flush %lu (%lu B) spi %lu us | handler %lu us (max %lu) | idle %lu%%\r\n",
+         (unsigned long)w.renderUs, (unsigned long)w.flushes, (unsigned long)w.flushBytes,
+         (unsigned long)w.spiUs, (unsigned long)w.handlerUs, (unsigned long)w.handlerMaxUs,
+         (unsigned long)idlePct);
+  char buf[64];
+  snprintf(buf, sizeof(buf), "r%lu f%lu %luK\ns%lu h%lu i%lu%%",
+           (unsigned long)(w.renderUs / 1000), (unsigned long)w.flushes, (unsigned long)(w.flushBytes / 1024),
+           (unsigned long)(w.spiUs / 1000), (unsigned long)(w.handlerUs / 1000), (unsigned long)idlePct);
+  lv_label_set_text(perfLabel, buf);   // Its own redraw shows up in the next window
+}
+#else
+static inline void Perf_Init(lv_display_t * disp) { (void)disp; }
+static inline void Perf_FlushQueued(const lv_area_t * area) { (void)area; }
+static inline void Perf_FlushDone(void) {}
+#endif
+
 /* Serial debugging */
 void Lvgl_print(const char * buf)
 {
@@ -20,15 +120,52 @@ void Lvgl_print(const char * buf)
     // Serial.flush();
 }
 
+/* Runs from the SPI interrupt once the flushed buffer is free again. */
+static void Lvgl_Flush_Done(void *arg)
+{
+  Perf_FlushDone();
+  lv_display_flush_ready( (lv_display_t *)arg );
+}
+
 /*  Display flushing 
     Displays LVGL content on the LCD
-    This function implements associating LVGL data to the LCD screen
+    This function implements associating LVGL data to the LCD screen.
+    The transfer is queued on the SPI DMA and completes asynchronously.
 */
 void Lvgl_Display_LCD( lv_display_t *disp, const lv_area_t *area, uint8_t *px_map )
 {
-  lv_color_t * color_p = (lv_color_t *)px_map;
-  LCD_addWindow(area->x1, area->y1, area->x2, area->y2, (uint16_t *)color_p);
-  lv_display_flush_ready( disp );
+  Perf_FlushQueued(area);
+  uint16_t top, lines;
+  if (LCD_ScrollRegion(&top, &lines) && area->y2 >= top && area->y1 < top + lines) {
+    // A hardware-scrolled region belongs to whoever pushes rows into it: send only
+    // the parts of the area in the fixed bands above and below it.
+    const int32_t end = top + lines;
+    const bool above = area->y1 < top;
+    const bool below = area->y2 >= end;
+    // Only what is actually sent counts as flushed.
+    if (above) {
+      const lv_area_t sent = {area->x1, area->y1, area->x2, top - 1};
+      LCD_addWindowAsync(sent.x1, sent.y1, sent.x2, sent.y2, (const uint16_t *)px_map,
+                         below ? NULL : Lvgl_Flush_Done, disp);
+      Ui_NoteFlush(&sent);
+    }
+    if (below) {
+      const lv_area_t sent = {area->x1, end, area->x2, area->y2};
+      const uint16_t *px = (const uint16_t *)px_map + (size_t)(end - area->y1) * lv_area_get_width(area);
+      LCD_addWindowAsync(sent.x1, sent.y1, sent.x2, sent.y2, px, Lvgl_Flush_Done, disp);
+      Ui_NoteFlush(&sent);
+    }
+    if (!above && !below) Lvgl_Flush_Done(disp);
+  } else {
+    LCD_addWindowAsync(area->x1, area->y1, area->x2, area->y2, (const uint16_t *)px_map, Lvgl_Flush_Done, disp);
+    Ui_NoteFlush(area);
+  }
+  static bool firstFrame = true;
+  if (firstFrame && lv_display_flush_is_last(disp)) {
+    firstFrame = false;
+    Boot_Mark("first frame");
+    Boot_Report();
+  }
 }
 /*Read the touchpad*/
 void Lvgl_Touchpad_Read( lv_indev_t * indev, lv_indev_data_t * data )
@@ -37,36 +174,78 @@ void Lvgl_Touchpad_Read( lv_indev_t * indev, lv_indev_data_t * data )
   (void)data;
   // No touch input
 }
-void example_increase_lvgl_tick(void *arg)
+/* LVGL reads the time when it needs it; no periodic tick interrupt. */
+static uint32_t Lvgl_TickMs(void)
 {
-    /* Tell LVGL how many milliseconds has elapsed */
-    lv_tick_inc(EXAMPLE_LVGL_TICK_PERIOD_MS);
+  return (uint32_t)(esp_timer_get_time() / 1000);
 }
+
+static TaskHandle_t lvglTask = NULL;
+static Lvgl_ServiceFn lvglService = NULL;
 void Lvgl_Init(void)
 {
   lv_init();
+  lv_tick_set_cb(Lvgl_TickMs);
 
   lv_display_t * disp = lv_display_create(LVGL_WIDTH, LVGL_HEIGHT);
   lv_display_set_flush_cb(disp, Lvgl_Display_LCD);
-  lv_display_set_buffers(disp, buf1, buf2, sizeof(buf1), LV_DISPLAY_RENDER_MODE_PARTIAL);
+  lv_display_set_buffers(disp, buf1, buf2, sizeof(buf1), LVGL_RENDER_MODE);
+  Ui_Init(disp);
+  Perf_Init(disp);
 
   lv_indev_t * indev = lv_indev_create();
   lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
   lv_indev_set_read_cb(indev, Lvgl_Touchpad_Read);
 
   Blewatch_Init();
+  Boot_Mark("lvgl ready");
 
-  const esp_timer_create_args_t lvgl_tick_timer_args = {
-    .callback = &example_increase_lvgl_tick,
-    .name = "lvgl_tick"
-  };
-  esp_timer_handle_t lvgl_tick_timer = NULL;
-  esp_timer_create(&lvgl_tick_timer_args, &lvgl_tick_timer);
-  esp_timer_start_periodic(lvgl_tick_timer, EXAMPLE_LVGL_TICK_PERIOD_MS * 1000);
+}
+uint32_t Timer_Loop(void)
+{
+#if LVGL_PERF_HUD
+  const int64_t start = esp_timer_get_time();
+  const uint32_t nextMs = lv_timer_handler(); /* let the GUI do its work */
+  Perf_Handler((uint32_t)(esp_timer_get_time() - start));
+#else
+  const uint32_t nextMs = lv_timer_handler(); /* let the GUI do its work */
+#endif
+  return nextMs;
+}
 
+/* Sleeps exactly until the next LVGL timer is due, or until Lvgl_Wake(). */
+static void Lvgl_Task(void *arg)
+{
+  (void)arg;
+  while (true) {
+    uint32_t sleepMs = lvglService ? lvglService() : LV_NO_TIMER_READY;
+    const uint32_t nextMs = Timer_Loop();
+    if (nextMs < sleepMs) sleepMs = nextMs;
+    if (sleepMs > LVGL_MAX_SLEEP_MS) sleepMs = LVGL_MAX_SLEEP_MS;
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(sleepMs));
+  }
+}
+
+void Lvgl_SetService(Lvgl_ServiceFn fn)
+{
+  lvglService = fn;
 }
-void Timer_Loop(void)
+
+void Lvgl_StartTask(void)
+{
+  if (lvglTask) return;
+  xTaskCreatePinnedToCore(
+    Lvgl_Task,
+    "lvgl",
+    8192,
+    NULL,
+    1,
+    &lvglTask,
+    0
+  );
+}
+
+void Lvgl_Wake(void)
 {
-  lv_timer_handler(); /* let the GUI do its work */
-  // delay( 5 );
+  if (lvglTask) xTaskNotifyGive(lvglTask);
 }
\ No newline at end of file
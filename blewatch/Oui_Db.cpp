@@ -0,0 +1,154 @@
+#include "Oui_Db.h"
+#include "Oui_Image.h"
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <esp_partition.h>
+#include <esp_rom_crc.h>
+
+namespace {
+
+constexpr const char* kPartitionLabel = "oui";
+constexpr uint8_t kPartitionSubtype = 0x41;   // Custom data subtype (partitions.csv)
+// Flagged vendors, used until (or unless) a valid image is mapped. Sorted by OUI.
+constexpr OuiRecord kBuiltinRecords[] = {
+  {{0x00, 0x02, 0x5B}, kOuiFlagLegacy, 2},                          // CSR
+  {{0x00, 0x02, 0x72}, kOuiFlagLegacy, 9},                          // CC&C Technologies
+  {{0x00, 0x03, 0x7A}, kOuiFlagSweynTooth | kOuiFlagBrakTooth, 6},  // Texas Instruments
+  {{0x00, 0x04, 0x9F}, kOuiFlagSweynTooth, 11},                     // NXP
+  {{0x00, 0x04, 0xA3}, kOuiFlagSweynTooth, 5},                      // Microchip
+  {{0x00, 0x0B, 0x57}, kOuiFlagBrakTooth, 7},                       // Silicon Labs
+  {{0x00, 0x10, 0x18}, kOuiFlagBlueBorne | kOuiFlagLegacy, 1},      // Broadcom
+  {{0x00, 0x10, 0xC6}, kOuiFlagSweynTooth, 8},                      // Cypress
+  {{0x00, 0x15, 0x83}, kOuiFlagLegacy, 10},                         // RF Micro Devices
+  {{0x00, 0x17, 0xE9}, kOuiFlagSweynTooth | kOuiFlagBrakTooth, 6},
+  {{0x00, 0x19, 0x86}, kOuiFlagBlueBorne | kOuiFlagLegacy, 1},
+  {{0x00, 0x1A, 0x7D}, kOuiFlagLegacy, 12},                         // Cyber-Blue
+  {{0x00, 0x1B, 0xDC}, kOuiFlagLegacy, 2},
+  {{0x00, 0x1F, 0xC6}, kOuiFlagSweynTooth, 11},
+  {{0x00, 0x25, 0xBC}, kOuiFlagLegacy, 2},
+  {{0x00, 0x25, 0xDB}, kOuiFlagBlueBorne, 0},                       // Qualcomm
+  {{0x00, 0x26, 0xE8}, kOuiFlagBlueBorne, 0},
+  {{0x00, 0x60, 0x37}, kOuiFlagSweynTooth, 11},
+  {{0x00, 0x80, 0x25}, kOuiFlagSweynTooth, 4},                      // Dialog Semiconductor
+  {{0x00, 0x80, 0xE1}, kOuiFlagSweynTooth, 13},                     // STMicroelectronics
+  {{0x00, 0xA0, 0x50}, kOuiFlagSweynTooth, 8},
+  {{0x02, 0x80, 0xE1}, kOuiFlagSweynTooth, 13},
+  {{0x11, 0x22, 0x33}, kOuiFlagSweynTooth, 14},                     // Telink dev boards
+  {{0x34, 0xB1, 0xF7}, kOuiFlagBlueBorne | kOuiFlagLegacy, 1},
+  {{0x38, 0x1F, 0x8D}, kOuiFlagSweynTooth, 14},
+  {{0x78, 0xD7, 0x5F}, kOuiFlagBlueBorne, 3},                       // Samsung
+  {{0x80, 0xE1, 0x26}, kOuiFlagSweynTooth, 13},
+  {{0x80, 0xEA, 0xCA}, kOuiFlagSweynTooth, 4},
+  {{0x84, 0x2E, 0x14}, kOuiFlagBrakTooth, 7},
+  {{0x8C, 0xF5, 0xA3}, kOuiFlagBlueBorne, 3},
+  {{0x9C, 0x8C, 0xD8}, kOuiFlagBlueBorne, 0},
+  {{0xA4, 0xC1, 0x38}, kOuiFlagSweynTooth, 14},
+  {{0xAC, 0x37, 0x43}, kOuiFlagBlueBorne, 3},
+  {{0xD0, 0x5F, 0xB8}, kOuiFlagSweynTooth | kOuiFlagBrakTooth, 6},
+  {{0xD8, 0x80, 0x39}, kOuiFlagSweynTooth, 5},
+};
+// Indexed by OuiRecord::nameOffset in the built-in table.
+constexpr const char* kBuiltinNames[] = {
+  "Qualcomm", "Broadcom", "CSR", "Samsung", "Dialog Semi", "Microchip", "Texas Instr.",
+  "Silicon Labs", "Cypress", "CC&C Tech", "RF Micro Devices", "NXP", "Cyber-Blue",
+  "STMicro", "Telink",
+};
+constexpr size_t kBuiltinCount = sizeof(kBuiltinRecords) / sizeof(kBuiltinRecords[0]);
+
+// Published once by OuiDb_Init() after validation; null = built-in table.
+struct OuiImage {
+  const OuiRecord* records;
+  const char* names;
+  uint32_t count;
+  uint32_t namesSize;
+};
+OuiImage g_image{};
+std::atomic<const OuiImage*> g_active{nullptr};
+esp_partition_mmap_handle_t g_mapHandle;
+
+bool imageValid(const uint8_t* map, uint32_t size) {
+  const OuiImageHeader* h = reinterpret_cast<const OuiImageHeader*>(map);
+  const OuiImageStatus status = ouiCheckHeader(map, size);
+  if (status == kOuiImageEmpty) {
+    printf("oui: partition empty, using %u built-in entries\r\n", static_cast<unsigned>(kBuiltinCount));
+    return false;
+  }
+  if (status != kOuiImageOk) {
+    printf("oui: bad image header (version %u), using built-in table\r\n", static_cast<unsigned>(h->version));
+    return false;
+  }
+  const uint64_t namesEnd = static_cast<uint64_t>(h->namesOffset) + h->namesSize;
+  const uint32_t crc = esp_rom_crc32_le(0, map + h->recordsOffset, static_cast<uint32_t>(namesEnd - h->recordsOffset));
+  if (crc != h->crc32) {
+    printf("oui: image CRC mismatch, using built-in table\r\n");
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+bool OuiDb_Init() {
+  if (g_active.load(std::memory_order_acquire)) return true;
+  const esp_partition_t* part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+      static_cast<esp_partition_subtype_t>(kPartitionSubtype), kPartitionLabel);
+  if (!part) {
+    printf("oui: no '%s' partition, using built-in table\r\n", kPartitionLabel);
+    return false;
+  }
+  const void* map = nullptr;
+  if (esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &map, &g_mapHandle) != ESP_OK) {
+    printf("oui: mmap failed, using built-in table\r\n");
+    return false;
+  }
+  const uint8_t* base = static_cast<const uint8_t*>(map);
+  const uint32_t startMs = millis();
+  if (!imageValid(base, part->size)) {
+    esp_partition_munmap(g_mapHandle);
+    return false;
+  }
+  const OuiImageHeader* h = reinterpret_cast<const OuiImageHeader*>(base);
+  g_image.records = reinterpret_cast<const OuiRecord*>(base + h->recordsOffset);
+  g_image.names = reinterpret_cast<const char*>(base + h->namesOffset);
+  g_image.count = h->count;
+  g_image.namesSize = h->namesSize;
+  g_active.store(&g_image, std::memory_order_release);
+  printf("oui: %lu prefixes, %lu B names mapped from flash (checked in %lu ms)\r\n",
+         static_cast<unsigned long>(h->count), static_cast<unsigned long>(h->namesSize),
+         static_cast<unsigned long>(millis() - startMs));
+  return true;
+}
+
+bool OuiDb_Lookup(const uint8_t mac[6], OuiInfo* out) {
+  const uint32_t key = ouiKey(mac);
+  const OuiImage* img = g_active.load(std::memory_order_acquire);
+  if (img) {
+    const int32_t i = ouiFindRecord(img->records, img->count, key);
+    if (i < 0) return false;
+    const OuiRecord& r = img->records[i];
+    if (out) {
+      // The pool ends in NUL (checked at init), so any in-range offset is a valid string.
+      out->vendor = (r.nameOffset < img->namesSize) ? img->names + r.nameOffset : "?";
+      out->flags = r.flags;
+    }
+    return true;
+  }
+  const int32_t i = ouiFindRecord(kBuiltinRecords, kBuiltinCount, key);
+  if (i < 0) return false;
+  if (out) {
+    out->vendor = kBuiltinNames[kBuiltinRecords[i].nameOffset];
+    out->flags = kBuiltinRecords[i].flags;
+  }
+  return true;
+}
+
+size_t OuiDb_Count() {
+  const OuiImage* img = g_active.load(std::memory_order_acquire);
+  return img ? img->count : kBuiltinCount;
+}
+
+bool OuiDb_FromFlash() {
+  return g_active.load(std::memory_order_acquire) != nullptr;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// IEEE OUI (MA-L) vendor database in the "oui" flash partition (see partitions.csv).
+//
+// The partition holds a packed image built by tools/pack_oui.py from the IEEE
+// registry: a 32-byte header, 8-byte records sorted by OUI, then a pool of
+// deduplicated NUL-terminated vendor names. The image is memory-mapped and
+// binary-searched in place (~16 probes for the full registry), so it costs no heap
+// beyond the mapping, and it can be rewritten with parttool.py without reflashing
+// the app. When the partition is missing, empty or fails its CRC, lookups fall back
+// to a small built-in table of the flagged vendors.
+
+// Vulnerability classes, one bit each (tools/vulnerable_ouis.csv).
+constexpr uint8_t kOuiFlagBlueBorne = 0x01;   // BlueBorne / BlueFrag
+constexpr uint8_t kOuiFlagSweynTooth = 0x02;
+constexpr uint8_t kOuiFlagBrakTooth = 0x04;
+constexpr uint8_t kOuiFlagLegacy = 0x08;      // Old stacks that never get patched (CSR, dongles)
+
+struct OuiInfo {
+  const char* vendor;   // Never null when found; points into flash or the built-in table
+  uint8_t flags;        // kOuiFlag* bits, 0 = not flagged
+};
+
+// Maps and validates the partition. Reads the whole image once for the CRC, so call
+// it off the boot path; lookups before (or without) it use the built-in table.
+// Returns false when the fallback table stays in use.
+bool OuiDb_Init();
+
+// Looks up the first three bytes of mac (display order). Thread-safe.
+bool OuiDb_Lookup(const uint8_t mac[6], OuiInfo* out);
+
+// Entries in the active table and whether it is the flash image.
+size_t OuiDb_Count();
+bool OuiDb_FromFlash();
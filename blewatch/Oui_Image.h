@@ -0,0 +1,71 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Packed OUI image layout (see Oui_Db.h), shared by the firmware lookup and the host
+// tests. Little-endian; must match tools/pack_oui.py.
+
+constexpr uint32_t kOuiImageMagic = 0x3149554F;  // "OUI1"
+constexpr uint16_t kOuiImageVersion = 1;
+
+struct OuiImageHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t recordSize;
+  uint32_t count;
+  uint32_t recordsOffset;
+  uint32_t namesOffset;
+  uint32_t namesSize;
+  uint32_t crc32;      // zlib CRC-32 of records followed by names
+  uint32_t reserved;
+};
+static_assert(sizeof(OuiImageHeader) == 32, "OuiImageHeader layout");
+
+struct OuiRecord {
+  uint8_t oui[3];      // Big-endian prefix, records sorted ascending
+  uint8_t flags;
+  uint32_t nameOffset; // Into the name pool
+};
+static_assert(sizeof(OuiRecord) == 8, "OuiRecord layout");
+
+enum OuiImageStatus : uint8_t {
+  kOuiImageOk = 0,
+  kOuiImageEmpty,      // No magic: erased or never written
+  kOuiImageBadHeader,  // Wrong version/record size or out-of-range sections
+};
+
+inline uint32_t ouiKey(const uint8_t oui[3]) {
+  return (static_cast<uint32_t>(oui[0]) << 16) | (static_cast<uint32_t>(oui[1]) << 8) | oui[2];
+}
+
+// Lower-bound binary search; index of the match or -1.
+inline int32_t ouiFindRecord(const OuiRecord* records, uint32_t count, uint32_t key) {
+  uint32_t lo = 0;
+  uint32_t hi = count;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    if (ouiKey(records[mid].oui) < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return (lo < count && ouiKey(records[lo].oui) == key) ? static_cast<int32_t>(lo) : -1;
+}
+
+// Structural checks on an image of `size` bytes at map: every record and name offset
+// the lookup can reach is inside it, and the name pool ends in NUL. The CRC is left
+// to the caller (the ROM CRC on the device).
+inline OuiImageStatus ouiCheckHeader(const uint8_t* map, uint32_t size) {
+  const OuiImageHeader* h = reinterpret_cast<const OuiImageHeader*>(map);
+  if (size < sizeof(OuiImageHeader) || h->magic != kOuiImageMagic) return kOuiImageEmpty;
+  const uint64_t recordsEnd = static_cast<uint64_t>(h->recordsOffset) + static_cast<uint64_t>(h->count) * sizeof(OuiRecord);
+  const uint64_t namesEnd = static_cast<uint64_t>(h->namesOffset) + h->namesSize;
+  if (h->version != kOuiImageVersion || h->recordSize != sizeof(OuiRecord) || h->count == 0 ||
+      h->recordsOffset < sizeof(OuiImageHeader) || (h->recordsOffset & 3) != 0 ||
+      h->namesOffset != recordsEnd || namesEnd > size || h->namesSize == 0 ||
+      map[namesEnd - 1] != '\0') {
+    return kOuiImageBadHeader;
+  }
+  return kOuiImageOk;
+}
@@ -0,0 +1,237 @@
+#include "RGB_LED.h"
+#include <string.h>
+#include <esp_timer.h>
+
+// WS2812 bit timing at a 10 MHz RMT clock (100 ns ticks).
+#define LED_RMT_HZ      10000000
+#define LED_T0H         4
+#define LED_T0L         8
+#define LED_T1H         8
+#define LED_T1L         4
+
+// round(127.5 * (1 + sin(2*pi*k/64)))
+static const uint8_t ledSine64[64] = {
+  128, 140, 152, 165, 176, 188, 198, 208, 218, 226, 234, 240, 245, 250, 253, 254,
+  255, 254, 253, 250, 245, 240, 234, 226, 218, 208, 198, 188, 176, 165, 152, 140,
+  128, 115, 103, 90, 79, 67, 57, 47, 37, 29, 21, 15, 10, 5, 2, 1,
+  0, 1, 2, 5, 10, 15, 21, 29, 37, 47, 57, 67, 79, 90, 103, 115,
+};
+
+static int ledPin = -1;
+static Led_ColorOrder ledOrder = LED_ORDER_RGB;
+static uint8_t ledMaxBrightness = 255;
+static esp_timer_handle_t ledTimer = NULL;
+static portMUX_TYPE ledMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Shared between Led_Set() and the timer, under ledMux.
+static Led_Effect ledFx;
+static bool ledFxRestart = true;
+static bool ledTimerOn = false;      // Periodic timer armed; stopped once the LED has settled
+
+// Timer-only state.
+static Led_Effect ledRunning;
+static uint16_t ledPhase = 0;        // Pulse phase, 1/65536 cycle
+static uint32_t ledElapsedMs = 0;    // Blink time since start
+static uint32_t ledLastSent = 0xFFFFFFFF;
+static uint32_t ledFramesSent = 0;
+static rmt_data_t ledSymbols[24];    // Must stay valid while the async transfer runs
+
+static bool sameColor(Led_Color a, Led_Color b)
+{
+  return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+static bool sameEffect(const Led_Effect* a, const Led_Effect* b)
+{
+  return a->kind == b->kind && sameColor(a->color, b->color) && a->level == b->level &&
+         a->trough == b->trough && a->periodMs == b->periodMs && a->onMs == b->onMs &&
+         a->offMs == b->offMs && a->count == b->count && sameColor(a->thenColor, b->thenColor) &&
+         a->thenLevel == b->thenLevel;
+}
+
+static uint32_t scaleColor(Led_Color c, uint16_t level256)
+{
+  // level256: 0..256 after percent and max-brightness scaling.
+  const uint32_t r = ((uint32_t)c.r * level256) >> 8;
+  const uint32_t g = ((uint32_t)c.g * level256) >> 8;
+  const uint32_t b = ((uint32_t)c.b * level256) >> 8;
+  return (r << 16) | (g << 8) | b;
+}
+
+static uint16_t percentTo256(uint8_t percent)
+{
+  if (percent > 100) percent = 100;
+  return (uint16_t)(((uint32_t)percent * 256 / 100) * (ledMaxBrightness + 1) >> 8);
+}
+
+// *settled: the colour stays put from here on (steady, or a blink that has finished).
+static uint32_t renderFrame(bool* settled)
+{
+  const Led_Effect& fx = ledRunning;
+  *settled = false;
+  switch (fx.kind) {
+    case LED_FX_PULSE: {
+      const uint32_t step = fx.periodMs ? (65536u * LED_FX_TICK_MS / fx.periodMs) : 0;
+      ledPhase = (uint16_t)(ledPhase + step);
+      const uint8_t s = ledSine64[ledPhase >> 10];
+      const uint8_t lvl = (uint8_t)(fx.trough + (((int)fx.level - fx.trough) * s) / 255);
+      return scaleColor(fx.color, percentTo256(lvl));
+    }
+    case LED_FX_BLINK: {
+      const uint32_t cycle = (uint32_t)fx.onMs + fx.offMs;
+      const uint32_t t = ledElapsedMs;
+      ledElapsedMs += LED_FX_TICK_MS;
+      if (cycle == 0 || t >= cycle * fx.count) {
+        *settled = true;
+        return scaleColor(fx.thenColor, percentTo256(fx.thenLevel));
+      }
+      return ((t % cycle) < fx.onMs) ? scaleColor(fx.color, percentTo256(fx.level)) : 0;
+    }
+    case LED_FX_STEADY:
+    default:
+      *settled = true;
+      return scaleColor(fx.color, percentTo256(fx.level));
+  }
+}
+
+static void transmit(uint32_t rgb)
+{
+  const uint8_t r = (uint8_t)(rgb >> 16), g = (uint8_t)(rgb >> 8), b = (uint8_t)rgb;
+  const uint8_t bytes[3] = {
+    (ledOrder == LED_ORDER_GRB) ? g : r,
+    (ledOrder == LED_ORDER_GRB) ? r : g,
+    b,
+  };
+  for (int i = 0; i < 24; i++) {
+    const bool one = (bytes[i >> 3] >> (7 - (i & 7))) & 1;
+    ledSymbols[i].level0 = 1;
+    ledSymbols[i].duration0 = one ? LED_T1H : LED_T0H;
+    ledSymbols[i].level1 = 0;
+    ledSymbols[i].duration1 = one ? LED_T1L : LED_T0L;
+  }
+  if (rmtWriteAsync(ledPin, ledSymbols, 24)) {
+    ledLastSent = rgb;
+    ledFramesSent++;
+  }
+}
+
+static void ledTimerCb(void* arg)
+{
+  (void)arg;
+  portENTER_CRITICAL(&ledMux);
+  if (ledFxRestart) {
+    ledRunning = ledFx;
+    ledFxRestart = false;
+    ledPhase = 0;
+    ledElapsedMs = 0;
+  } else if (ledFx.kind == LED_FX_PULSE) {
+    ledRunning = ledFx;   // Retune in place; phase carries on
+  }
+  portEXIT_CRITICAL(&ledMux);
+
+  bool settled;
+  const uint32_t rgb = renderFrame(&settled);
+  // Previous frame still shifting out: keep ledLastSent, retry next tick.
+  if (rgb != ledLastSent && rmtTransmitCompleted(ledPin)) transmit(rgb);
+  if (!settled || rgb != ledLastSent) return;
+
+  // Nothing left to animate: sleep until Led_Set() brings a new effect. Checked and
+  // stopped under ledMux so a Led_Set() racing with this either lands first (and keeps
+  // the timer) or sees it stopped and starts it again.
+  portENTER_CRITICAL(&ledMux);
+  if (!ledFxRestart) {
+    esp_timer_stop(ledTimer);
+    ledTimerOn = false;
+  }
+  portEXIT_CRITICAL(&ledMux);
+}
+
+// Arms the effect timer if it is idle; call with ledMux held.
+static void wakeTimer(void)
+{
+  if (ledTimerOn) return;
+  esp_timer_start_periodic(ledTimer, LED_FX_TICK_MS * 1000);
+  ledTimerOn = true;
+}
+
+bool Led_Init(int pin, Led_ColorOrder order, uint8_t maxBrightness)
+{
+  if (ledTimer) return true;
+  ledPin = pin;
+  ledOrder = order;
+  ledMaxBrightness = maxBrightness;
+  if (!rmtInit(pin, RMT_TX_MODE, RMT_MEM_NUM_BLOCKS_1, LED_RMT_HZ)) {
+    printf("led: RMT init failed on GPIO %d\r\n", pin);
+    return false;
+  }
+  memset(&ledFx, 0, sizeof(ledFx));   // Steady off
+  ledFxRestart = true;
+
+  const esp_timer_create_args_t args = {
+    .callback = &ledTimerCb,
+    .name = "led_fx"
+  };
+  esp_timer_create(&args, &ledTimer);
+  portENTER_CRITICAL(&ledMux);
+  wakeTimer();  // Sends the initial "off"
+  portEXIT_CRITICAL(&ledMux);
+  return true;
+}
+
+void Led_Set(const Led_Effect* fx)
+{
+  portENTER_CRITICAL(&ledMux);
+  if (fx->kind == LED_FX_PULSE && ledFx.kind == LED_FX_PULSE && sameColor(fx->color, ledFx.color)) {
+    // Retune only; the timer picks the new shape up without resetting the phase.
+    ledFx.level = fx->level;
+    ledFx.trough = fx->trough;
+    ledFx.periodMs = fx->periodMs;
+  } else if (!sameEffect(fx, &ledFx)) {
+    ledFx = *fx;
+    ledFxRestart = true;
+    if (ledTimer) wakeTimer();
+  }
+  portEXIT_CRITICAL(&ledMux);
+}
+
+void Led_Steady(Led_Color color, uint8_t level)
+{
+  Led_Effect fx;
+  memset(&fx, 0, sizeof(fx));
+  fx.kind = LED_FX_STEADY;
+  fx.color = color;
+  fx.level = level;
+  Led_Set(&fx);
+}
+
+void Led_Pulse(Led_Color color, uint8_t trough, uint8_t peak, uint16_t periodMs)
+{
+  Led_Effect fx;
+  memset(&fx, 0, sizeof(fx));
+  fx.kind = LED_FX_PULSE;
+  fx.color = color;
+  fx.level = peak;
+  fx.trough = trough;
+  fx.periodMs = periodMs;
+  Led_Set(&fx);
+}
+
+void Led_BlinkThen(Led_Color color, uint8_t count, uint16_t onMs, uint16_t offMs, Led_Color thenColor, uint8_t thenLevel)
+{
+  Led_Effect fx;
+  memset(&fx, 0, sizeof(fx));
+  fx.kind = LED_FX_BLINK;
+  fx.color = color;
+  fx.level = 100;
+  fx.onMs = onMs;
+  fx.offMs = offMs;
+  fx.count = count;
+  fx.thenColor = thenColor;
+  fx.thenLevel = thenLevel;
+  Led_Set(&fx);
+}
+
+uint32_t Led_FramesSent(void)
+{
+  return ledFramesSent;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <Arduino.h>
+
+// Onboard WS2812 driven by the RMT peripheral.
+//
+// Callers describe what the LED should do (steady, pulse, blink N times then steady)
+// and Led_Set() only records it. A 20 ms esp_timer renders the effect and starts an
+// asynchronous RMT transfer only when the resulting colour differs from the last one
+// sent, so nothing masks interrupts for the WS2812 frame. The timer runs only while a
+// pulse or blink animates: once the colour has settled it stops, so a steady LED costs
+// one 30 µs transfer and no wakeups. Submitting the same effect every UI tick is free; a pulse
+// with new speed/brightness is retuned in place without restarting its phase.
+
+typedef struct { uint8_t r; uint8_t g; uint8_t b; } Led_Color;
+
+typedef enum {
+  LED_ORDER_RGB = 0,
+  LED_ORDER_GRB = 1,
+} Led_ColorOrder;
+
+typedef enum {
+  LED_FX_STEADY = 0,   // color at level
+  LED_FX_PULSE,        // sine between trough and level, periodMs per cycle
+  LED_FX_BLINK,        // count x (onMs at level, offMs dark), then thenColor at thenLevel
+} Led_EffectKind;
+
+typedef struct {
+  Led_EffectKind kind;
+  Led_Color color;
+  uint8_t level;        // Percent (peak for pulse)
+  uint8_t trough;       // Pulse: minimum percent
+  uint16_t periodMs;    // Pulse: cycle length
+  uint16_t onMs;        // Blink
+  uint16_t offMs;
+  uint8_t count;
+  Led_Color thenColor;  // Blink: steady colour once done
+  uint8_t thenLevel;
+} Led_Effect;
+
+#define LED_FX_TICK_MS 20
+
+// maxBrightness scales every level (0–255), like NeoPixel's setBrightness().
+bool Led_Init(int pin, Led_ColorOrder order, uint8_t maxBrightness);
+void Led_Set(const Led_Effect* fx);
+void Led_Steady(Led_Color color, uint8_t level);
+void Led_Pulse(Led_Color color, uint8_t trough, uint8_t peak, uint16_t periodMs);
+void Led_BlinkThen(Led_Color color, uint8_t count, uint16_t onMs, uint16_t offMs, Led_Color thenColor, uint8_t thenLevel);
+
+uint32_t Led_FramesSent(void);   // RMT transfers started since boot
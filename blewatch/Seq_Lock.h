@@ -0,0 +1,45 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+
+// Single-writer sequence lock around a small trivially-copyable value.
+//
+// The writer never waits: it bumps the sequence to odd, copies the value in and bumps
+// it back to even. Readers copy the value out and retry if the sequence was odd or
+// changed meanwhile, so they always get a consistent copy and never hold off the
+// writer (no critical section, interrupts stay enabled). Meant for a writer that
+// publishes at most a few thousand times a second and readers that poll.
+template <typename T>
+class SeqLock {
+ public:
+  void write(const T& value) {
+    const uint32_t s = seq_.load(std::memory_order_relaxed);
+    seq_.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(static_cast<void*>(&value_), &value, sizeof(T));
+    std::atomic_thread_fence(std::memory_order_release);
+    seq_.store(s + 2, std::memory_order_relaxed);
+  }
+
+  // Returns the number of retries (0 when uncontended).
+  uint32_t read(T& out) const {
+    uint32_t retries = 0;
+    for (;;) {
+      const uint32_t before = seq_.load(std::memory_order_acquire);
+      if (!(before & 1)) {
+        memcpy(&out, static_cast<const void*>(&value_), sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) == before) return retries;
+      }
+      retries++;
+    }
+  }
+
+  // Changes on every write; lets readers skip work when nothing was published.
+  uint32_t sequence() const { return seq_.load(std::memory_order_acquire); }
+
+ private:
+  T value_{};
+  std::atomic<uint32_t> seq_{0};
+};
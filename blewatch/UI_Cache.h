@@ -0,0 +1,54 @@
+#pragma once
+
+#include <lvgl.h>
+
+// Change-only widget updates.
+//
+// lv_label_set_text / lv_bar_set_value / lv_obj_set_style_* invalidate the widget even
+// when the value is unchanged, and every invalidated area is re-rendered and pushed over
+// SPI. The Ui_* setters compare against the last rendered value and only call LVGL on
+// a real change. Text and bar values can also be rate-limited per widget; callers are
+// expected to re-submit every tick, so the latest value lands on the next allowed tick.
+//
+// Ui_Init() also hooks the display so invalidated and flushed pixels are counted
+// (Ui_GetStats(); the sketches add them to the 's' stats line). With
+// UI_STATS_REPORT_MS > 0 a summary is also printed on serial at that cadence.
+
+#ifndef UI_STATS_REPORT_MS
+#define UI_STATS_REPORT_MS 0
+#endif
+
+typedef struct {
+  lv_obj_t* obj;
+  uint32_t lastApplyMs;     // Last text/value change (rate limit reference)
+  uint32_t bgColor;         // Cached lv_color_to_u32() values, valid per 'known'
+  uint32_t textColor;
+  uint16_t minIntervalMs;   // 0 = every change is applied immediately
+  uint8_t known;
+} Ui_Widget;
+
+typedef struct {
+  uint32_t requests;        // Setter calls
+  uint32_t applied;         // Calls forwarded to LVGL
+  uint32_t skippedSame;     // Unchanged value
+  uint32_t skippedRate;     // Changed, but inside minIntervalMs
+  uint32_t savedPx;         // Widget area of every skipped call (pixels not re-rendered)
+  uint32_t invalidations;   // LV_EVENT_INVALIDATE_AREA count
+  uint32_t invalidatedPx;
+  uint32_t flushes;
+  uint32_t flushedPx;
+} Ui_Stats;
+
+void Ui_Init(lv_display_t* disp);
+void Ui_Bind(Ui_Widget* w, lv_obj_t* obj, uint16_t minIntervalMs);
+
+bool Ui_SetText(Ui_Widget* w, const char* text);
+bool Ui_SetBarValue(Ui_Widget* w, int32_t value);
+// One selector per widget: the cache holds a single bg color.
+bool Ui_SetBgColor(Ui_Widget* w, lv_color_t color, lv_style_selector_t selector);
+bool Ui_SetTextColor(Ui_Widget* w, lv_color_t color);
+bool Ui_SetHidden(Ui_Widget* w, bool hidden);
+
+// Called from the flush callback for each flushed area.
+void Ui_NoteFlush(const lv_area_t* area);
+void Ui_GetStats(Ui_Stats* out);
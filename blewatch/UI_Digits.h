@@ -0,0 +1,51 @@
+#pragma once
+
+#include <lvgl.h>
+
+// Numeric labels drawn from pre-rendered glyph sprites.
+//
+// An lv_label re-shapes and re-rasterizes its whole text from the font on every change.
+// Ui_DigitFontInit() renders each character of a small set once, anti-aliased by LVGL
+// onto the widget's background colour, into one RGB565 strip. A Ui_Digits widget then
+// draws each character as an opaque sprite copy, without glyph lookup or alpha
+// blending, and on a change invalidates only the cells whose character moved or
+// changed. Digits share the width of the widest one, so "98" -> "99" redraws one cell.
+//
+// The sprites are opaque: the widget's background must stay the colour they were
+// rendered on. Characters missing from the set are left blank (one digit wide).
+
+#define UI_DIGIT_FONT_MAX_CHARS 24
+#define UI_DIGITS_MAX_CELLS 16
+
+typedef struct {
+  lv_image_dsc_t glyphs[UI_DIGIT_FONT_MAX_CHARS];  // Views into pixels
+  char chars[UI_DIGIT_FONT_MAX_CHARS + 1];
+  uint8_t* pixels;          // Every glyph side by side, RGB565
+  lv_color_t bg;
+  int32_t height;
+  int32_t digitWidth;       // Cell width of 0-9 (and of missing characters)
+  uint8_t count;
+} Ui_DigitFont;
+
+typedef struct {
+  lv_obj_t* obj;
+  const Ui_DigitFont* font;
+  uint32_t lastApplyMs;     // Rate limit reference, as in Ui_Widget
+  uint16_t minIntervalMs;   // 0 = every change is applied immediately
+  uint8_t align;            // lv_text_align_t: LEFT, CENTER or RIGHT within the widget
+  uint8_t len;
+  char text[UI_DIGITS_MAX_CELLS + 1];
+} Ui_Digits;
+
+// Renders chars in `font`/`color` on `bg`; letterSpace is extra pixels per cell. Call
+// from the LVGL task once the display exists. False when the strip cannot be allocated.
+bool Ui_DigitFontInit(Ui_DigitFont* f, const lv_font_t* font, lv_color_t color, lv_color_t bg,
+                      const char* chars, int32_t letterSpace);
+
+// Creates the widget under parent: `width` wide, one font line tall, background bg.
+lv_obj_t* Ui_DigitsCreate(Ui_Digits* d, lv_obj_t* parent, const Ui_DigitFont* font, int32_t width,
+                          lv_text_align_t align, uint16_t minIntervalMs);
+
+// Same contract as Ui_SetText(): true when the text changed and cells were invalidated.
+// Text beyond UI_DIGITS_MAX_CELLS characters is cut off.
+bool Ui_DigitsSet(Ui_Digits* d, const char* text);
@@ -1,9 +1,17 @@
 #include "blewatch.h"
+#include "Boot_Timing.h"
+#include "UI_Cache.h"
+#include "UI_Digits.h"
+#include "RGB_LED.h"
+#include "Device_Tracker.h"
+#include "Seq_Lock.h"
+#include "Oui_Db.h"
+#include "LVGL_Driver.h"
+#include "Hot_Stats.h"
 #include <Arduino.h>
-#include <math.h>
 #include <lvgl.h>
-#include <Adafruit_NeoPixel.h>
-#include <string>
+#include <esp_timer.h>
+#include <atomic>
 
 #if __has_include(<NimBLEDevice.h>)
   #include <NimBLEDevice.h>
@@ -16,20 +24,23 @@
 
 namespace {
 
-constexpr uint32_t kUiIntervalMs = 40;
-constexpr uint32_t kDeviceStaleMs = 3500;
+// The scan side wakes the UI when the displayed device, its proximity band or the
+// active count changes; the fallback timer only picks up values that drift without
+// an event (RSSI label, bar position, ageing, the vulnerability dwell).
+constexpr uint32_t kUiFallbackMs = 200;
+constexpr uint32_t kUiEventMinMs = 20;      // At most one event-driven update per this
+constexpr uint16_t kRssiLabelMinMs = 200;   // RSSI jitters every advert; cap label redraws
 
-// Scan tuning: smaller scan cycles + higher duty-cycle => faster state updates.
-// Note: this will increase power consumption.
-constexpr uint32_t kBleScanDurationS = 1;
-constexpr uint16_t kBleScanInterval = 16;
+// Scan tuning: one continuous scan (never restarted) with window == interval, i.e.
+// the receiver listens 100% of the time. Note: this will increase power consumption.
+constexpr uint16_t kBleScanInterval = 16;    // 0.625 ms units
 constexpr uint16_t kBleScanWindow = 16;
-constexpr uint32_t kBleScanLoopDelayMs = 5;
+constexpr uint32_t kBleStatsReportMs = 10000;  // Scan counters on serial (0 = off)
+constexpr uint32_t kBleRestartRetryMs = 100;   // Retry cadence if the stack refuses to start
 
 // LED (WS2812) config (matches Bandwatch defaults)
 constexpr int kRgbPin = 8;
-constexpr int kRgbCount = 1;
-constexpr uint16_t kNeoPixelType = NEO_RGB + NEO_KHZ800;
+constexpr Led_ColorOrder kRgbOrder = LED_ORDER_RGB;
 
 // Proximity heuristics (RSSI is not distance; these are tunable)
 constexpr int kFarRssiDbm = -80;        // below this -> treat as far/none
@@ -44,136 +55,82 @@ constexpr uint8_t kNearMinBrightness = 35;   // percent
 constexpr uint8_t kNearMaxBrightness = 100;  // percent
 constexpr uint8_t kNearAvgBrightness = 50;   // percent target for "ish close"
 
-constexpr float kPi = 3.14159265358979323846f;
-
-// Device table (fixed size, no heap churn in callbacks)
-constexpr int kMaxDevices = 64;
-
-struct DeviceSlot {
-  uint8_t mac[6] = {0};
-  uint32_t lastSeenMs = 0;
-  int8_t lastRssi = -127;
-  char name[32] = {0};
-  bool used = false;
+struct StickyRequest {
+  uint8_t mac[6];
 };
 
-portMUX_TYPE g_mux = portMUX_INITIALIZER_UNLOCKED;
-DeviceSlot g_devices[kMaxDevices];
+// What the UI shows, reduced to the values that warrant an immediate redraw.
+struct UiEventKey {
+  uint8_t bestMac[6];
+  uint8_t stickyMac[6];
+  int8_t bestBand;     // proximityBand(), -1 = no device
+  int8_t stickyBand;
+  uint16_t count;
+  bool bestNamed;
+};
 
-// Stats updated from scan callback
-volatile int g_bestRssi = -127;
-volatile uint32_t g_lastAnySeenMs = 0;
+// Device table, active count and strongest device (Device_Tracker.h). Only the BLE host
+// task (advert callback) touches the tracker; the UI reads the published summary, so
+// neither side ever takes a lock.
+DeviceTracker g_tracker;
+uint32_t g_stickySeqSeen = 0;
+SeqLock<DeviceSummary> g_summary;        // Scan side -> UI
+SeqLock<StickyRequest> g_stickyRequest;  // UI -> scan side
+UiEventKey g_lastUiKey{};                // Scan side only
+
+// UI wake-up: set by the scan side, consumed by Blewatch_ServiceEvents().
+std::atomic<bool> g_uiEventPending{false};
+lv_timer_t* g_uiTimer = nullptr;
+uint32_t g_lastUiEventMs = 0;
+volatile uint32_t g_uiEventUpdates = 0;
+volatile uint32_t g_uiFallbackUpdates = 0;
+
+// Scan counters (written by the BLE host task / bleTask, read anywhere).
+volatile uint32_t g_advReceived = 0;
+volatile uint32_t g_advDropped = 0;     // Advertisements that could not be recorded
+volatile uint32_t g_scanStarts = 0;
+volatile uint32_t g_scanOnMs = 0;       // Time a scan was running
+volatile uint32_t g_scanWallMs = 0;     // Time since the first start
+Stats_Timer g_advStats;                 // noteDeviceSeen; the BLE host task is its only writer
 
 // UI
 lv_obj_t* g_root = nullptr;
 lv_obj_t* g_title = nullptr;
-lv_obj_t* g_countLabel = nullptr;
-lv_obj_t* g_rssiLabel = nullptr;
 lv_obj_t* g_stateLabel = nullptr;
 lv_obj_t* g_nameLabel = nullptr;
 lv_obj_t* g_bar = nullptr;
 
-Adafruit_NeoPixel g_rgb(kRgbCount, kRgbPin, kNeoPixelType);
-
-struct RgbColor { uint8_t r; uint8_t g; uint8_t b; };
-constexpr RgbColor LED_OFF  = {0, 0, 0};
-constexpr RgbColor LED_GREEN = {0, 180, 40};
-constexpr RgbColor LED_ORANGE = {255, 90, 0};
-constexpr RgbColor LED_CYAN = {0, 180, 180};
-constexpr RgbColor LED_BLUE  = {0, 60, 255};
-constexpr RgbColor LED_RED   = {255, 0, 0};
-
-// OUI prefixes (first 3 bytes) of vendors historically affected by BLE vulnerabilities
-// (BlueBorne, KNOB, SweynTooth, BrakTooth, etc.). Focused on vendors whose devices
-// typically do NOT receive firmware patches (legacy chips, IoT, dongles).
-struct OuiEntry { uint8_t oui[3]; };
-constexpr OuiEntry kVulnerableOuis[] = {
-  // Qualcomm / Qualcomm Atheros (BlueBorne, BlueFrag)
-  {{0x00, 0x25, 0xDB}},
-  {{0x9C, 0x8C, 0xD8}},
-  {{0x00, 0x26, 0xE8}},
-  
-  // Texas Instruments (SweynTooth, BrakTooth)
-  {{0x00, 0x03, 0x7A}},
-  {{0xD0, 0x5F, 0xB8}},
-  {{0x00, 0x17, 0xE9}},
-  
-  // Broadcom (BlueBorne, various stack bugs)
-  {{0x34, 0xB1, 0xF7}},
-  {{0x00, 0x10, 0x18}},
-  {{0x00, 0x19, 0x86}},
-  
-  // Samsung older devices (uses affected Broadcom/Qualcomm chips)
-  {{0xAC, 0x37, 0x43}},
-  {{0x8C, 0xF5, 0xA3}},
-  {{0x78, 0xD7, 0x5F}},
-  
-  // CSR (now Qualcomm) - very old chips, never patched
-  {{0x00, 0x02, 0x5B}},
-  {{0x00, 0x25, 0xBC}},
-  {{0x00, 0x1B, 0xDC}},
-  
-  // Dialog Semiconductor (SweynTooth) - IoT/wearables, rarely patched
-  {{0x80, 0xEA, 0xCA}},
-  {{0x00, 0x80, 0x25}},
-  
-  // Microchip (SweynTooth) - embedded devices, rarely updated
-  {{0x00, 0x04, 0xA3}},
-  {{0xD8, 0x80, 0x39}},
-  
-  // Silicon Labs (BrakTooth) - legacy industrial IoT
-  {{0x00, 0x0B, 0x57}},
-  {{0x84, 0x2E, 0x14}},
-  
-  // Cypress older chips (SweynTooth) - before Infineon acquisition
-  {{0x00, 0xA0, 0x50}},
-  {{0x00, 0x10, 0xC6}},
-  
-  // Generic BT dongles (often use vulnerable CSR/Broadcom chips)
-  {{0x00, 0x1A, 0x7D}},  // Cyber-Blue
-  {{0x00, 0x02, 0x72}},  // CC&C Technologies
-  {{0x00, 0x15, 0x83}},  // RF Micro Devices
-  
-  // Telink Semiconductor (SweynTooth CVE-2019-16336, CVE-2019-19194) - cheap BLE SoCs
-  {{0xA4, 0xC1, 0x38}},
-  {{0x38, 0x1F, 0x8D}},
-  {{0x11, 0x22, 0x33}},  // Common Telink dev boards
-  
-  // STMicroelectronics BlueNRG (SweynTooth CVE-2019-17519) - industrial/medical
-  {{0x00, 0x80, 0xE1}},
-  {{0x80, 0xE1, 0x26}},
-  {{0x02, 0x80, 0xE1}},
-  
-  // NXP (SweynTooth CVE-2019-17517, CVE-2019-17518) - embedded devices
-  {{0x00, 0x04, 0x9F}},
-  {{0x00, 0x1F, 0xC6}},
-  {{0x00, 0x60, 0x37}},
-};
-constexpr size_t kVulnerableOuiCount = sizeof(kVulnerableOuis) / sizeof(kVulnerableOuis[0]);
-
-inline bool isOuiPotentiallyVulnerable(const uint8_t mac[6]) {
-  for (size_t i = 0; i < kVulnerableOuiCount; i++) {
-    if (mac[0] == kVulnerableOuis[i].oui[0] &&
-        mac[1] == kVulnerableOuis[i].oui[1] &&
-        mac[2] == kVulnerableOuis[i].oui[2]) {
-      return true;
-    }
-  }
-  return false;
-}
+// Change-only update handles for the widgets touched every tick.
+Ui_Widget g_stateUi;
+Ui_Widget g_nameUi;
+Ui_Widget g_barUi;
+
+// Device count and RSSI change with nearly every advert: drawn from glyph sprites.
+Ui_DigitFont g_countFont;
+Ui_DigitFont g_rssiFont;
+Ui_Digits g_countDigits;
+Ui_Digits g_rssiDigits;
+
+constexpr Led_Color LED_OFF  = {0, 0, 0};
+constexpr Led_Color LED_GREEN = {0, 180, 40};
+constexpr Led_Color LED_ORANGE = {255, 90, 0};
+constexpr Led_Color LED_CYAN = {0, 180, 180};
+constexpr Led_Color LED_BLUE  = {0, 60, 255};
+constexpr Led_Color LED_RED   = {255, 0, 0};
 
 // Track VERY CLOSE dwell time for vulnerability check
-uint8_t g_veryCloseMac[6] = {0};
+uint8_t g_veryCloseMac[6] = {0};   // UI-owned; mirrored to the scan side by setStickyDevice()
+constexpr uint8_t kNoMac[6] = {0};
 uint32_t g_veryCloseStartMs = 0;
 constexpr uint32_t kVulnCheckDwellMs = 3000;  // 3 seconds
 
 // Stickiness: only switch displayed device if new one is significantly stronger.
 constexpr int kStickyRssiMarginDb = 10;
 
-// Safe-blink animation: blink green twice when device is confirmed safe.
-bool g_safeBlinkTriggered = false;   // Has the blink been triggered for current device?
-uint32_t g_safeBlinkStartMs = 0;     // When the blink animation started.
-constexpr uint32_t kBlinkDurationMs = 600;  // Total duration of 2-blink animation.
+// Safe-blink animation: blink green twice when device is confirmed safe, then steady blue.
+constexpr uint8_t kSafeBlinkCount = 2;
+constexpr uint16_t kSafeBlinkOnMs = 100;
+constexpr uint16_t kSafeBlinkOffMs = 100;
 
 inline float clamp01(float v) {
   if (v < 0.0f) return 0.0f;
@@ -181,195 +138,156 @@ inline float clamp01(float v) {
   return v;
 }
 
-inline void setLedColor(const RgbColor& c, uint8_t brightnessPercent) {
-  const uint16_t scale = static_cast<uint16_t>(brightnessPercent) * 255 / 100;
-  const uint8_t r = static_cast<uint8_t>((static_cast<uint16_t>(c.r) * scale) / 255);
-  const uint8_t g = static_cast<uint8_t>((static_cast<uint16_t>(c.g) * scale) / 255);
-  const uint8_t b = static_cast<uint8_t>((static_cast<uint16_t>(c.b) * scale) / 255);
-  g_rgb.setPixelColor(0, g_rgb.Color(r, g, b));
-  g_rgb.show();
-}
-
-inline uint16_t macHash16(const uint8_t* mac) {
-  return (static_cast<uint16_t>(mac[4]) << 8) | mac[5];
-}
-
 inline void formatMac(const uint8_t mac[6], char* out, size_t outLen) {
   if (!out || outLen == 0) return;
   snprintf(out, outLen, "%02X:%02X:%02X:%02X:%02X:%02X",
            mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
 }
 
-void noteDeviceSeen(const uint8_t mac[6], int rssi, const char* name);
+// 0 FAR, 1 TOO FAR, 2 NEAR, 3 CLOSE, 4 VERY CLOSE (see updateLedAndUi).
+inline int8_t proximityBand(int rssi) {
+  if (rssi < kFarRssiDbm) return 0;
+  if (rssi < kNearStartRssiDbm) return 1;
+  if (rssi < kCloseStartRssiDbm) return 2;
+  if (rssi < kVeryCloseRssiDbm) return 3;
+  return 4;
+}
 
-void noteDeviceSeen(const uint8_t mac[6], int rssi) {
-  noteDeviceSeen(mac, rssi, nullptr);
+// Wakes the LVGL task when something it shows changed discretely. Called after the
+// summary is published, so the woken UI always reads the new one.
+void notifyUiOnChange(const DeviceSummary& s, uint32_t nowMs) {
+  UiEventKey key;
+  memset(&key, 0, sizeof(key));  // Compared with memcmp, padding included
+  if (s.best.valid) {
+    memcpy(key.bestMac, s.best.mac, 6);
+    key.bestBand = proximityBand(s.best.proxRssi);
+    key.bestNamed = s.best.name[0] != '\0';
+  } else {
+    key.bestBand = -1;
+  }
+  if (s.sticky.valid) {
+    memcpy(key.stickyMac, s.sticky.mac, 6);
+    key.stickyBand = proximityBand(s.sticky.proxRssi);
+  } else {
+    key.stickyBand = -1;
+  }
+  key.count = static_cast<uint16_t>(activeCount(s, nowMs));
+  if (memcmp(&key, &g_lastUiKey, sizeof(key)) == 0) return;
+  g_lastUiKey = key;
+  g_uiEventPending.store(true, std::memory_order_release);
+  Lvgl_Wake();
 }
 
-void noteDeviceSeen(const uint8_t mac[6], int rssi, const char* name) {
+void applyAdvert(const uint8_t mac[6], int rssi, const AdvInfo& adv) {
   const uint32_t nowMs = millis();
-  const uint16_t h = macHash16(mac);
-
-  portENTER_CRITICAL(&g_mux);
 
-  // Best RSSI tracking
-  g_lastAnySeenMs = nowMs;
-  if (rssi > g_bestRssi) g_bestRssi = rssi;
-
-  // Find existing
-  int freeIdx = -1;
-  int matchIdx = -1;
-  for (int i = 0; i < kMaxDevices; i++) {
-    if (!g_devices[i].used) {
-      if (freeIdx < 0) freeIdx = i;
-      continue;
-    }
-    // Quick hash filter first, then memcmp
-    if (macHash16(g_devices[i].mac) == h && memcmp(g_devices[i].mac, mac, 6) == 0) {
-      matchIdx = i;
-      break;
-    }
+  // Pick up a new sticky device from the UI.
+  const uint32_t stickySeq = g_stickyRequest.sequence();
+  if (stickySeq != g_stickySeqSeen) {
+    StickyRequest req;
+    g_stickyRequest.read(req);
+    g_stickySeqSeen = stickySeq;
+    g_tracker.setSticky(req.mac);
   }
 
-  const int idx = (matchIdx >= 0) ? matchIdx : freeIdx;
-  if (idx >= 0) {
-    memcpy(g_devices[idx].mac, mac, 6);
-    g_devices[idx].lastSeenMs = nowMs;
-    g_devices[idx].lastRssi = static_cast<int8_t>(rssi);
-    g_devices[idx].used = true;
-
-    if (name && name[0] != '\0') {
-      strncpy(g_devices[idx].name, name, sizeof(g_devices[idx].name) - 1);
-      g_devices[idx].name[sizeof(g_devices[idx].name) - 1] = '\0';
-    }
+  g_advReceived = g_advReceived + 1;
+  if (!g_tracker.onAdvert(mac, rssi, adv, nowMs)) {
+    g_advDropped = g_advDropped + 1;
+    return;
   }
-
-  portEXIT_CRITICAL(&g_mux);
+  g_summary.write(g_tracker.summary());
+  notifyUiOnChange(g_tracker.summary(), nowMs);
 }
 
-int countActiveDevicesAndBest(int* outBestRssi, char* outBestName, size_t outBestNameLen, uint8_t outBestMac[6]) {
-  const uint32_t nowMs = millis();
-  int count = 0;
-  int best = -127;
-  int bestIdx = -1;
-
-  // Check if currently tracked VERY CLOSE device is still valid.
-  int stickyIdx = -1;
-  int stickyRssi = -127;
-
-  portENTER_CRITICAL(&g_mux);
-  for (int i = 0; i < kMaxDevices; i++) {
-    if (!g_devices[i].used) continue;
-    if ((nowMs - g_devices[i].lastSeenMs) <= kDeviceStaleMs) {
-      count++;
-      const int devRssi = g_devices[i].lastRssi;
-
-      // Track absolute best.
-      if (devRssi > best) {
-        best = devRssi;
-        bestIdx = i;
-      }
+// Called from the BLE host task for every advertisement; adv points into the
+// stack's payload buffer, so everything needed is copied into the slot here.
+void noteDeviceSeen(const uint8_t mac[6], int rssi, const AdvInfo& adv) {
+  const uint32_t start = Stats_Cycles();
+  applyAdvert(mac, rssi, adv);
+  Stats_TimerAdd(&g_advStats, start);
+}
 
-      // Check if this is our sticky (currently tracked) device.
-      if (memcmp(g_devices[i].mac, g_veryCloseMac, 6) == 0) {
-        stickyIdx = i;
-        stickyRssi = devRssi;
-      }
-    }
-  }
+// UI side: lock on to (or release, with all zeroes) the VERY CLOSE device.
+void setStickyDevice(const uint8_t mac[6]) {
+  if (memcmp(g_veryCloseMac, mac, 6) == 0) return;
+  memcpy(g_veryCloseMac, mac, 6);
+  StickyRequest req;
+  memcpy(req.mac, mac, sizeof(req.mac));
+  g_stickyRequest.write(req);
+}
 
-  // Stickiness logic: if the sticky device is still VERY CLOSE, keep it
-  // unless the new best is significantly stronger.
-  if (stickyIdx >= 0 && stickyRssi >= kVeryCloseRssiDbm) {
-    // Only switch if new best is > kStickyRssiMarginDb stronger.
-    if (bestIdx != stickyIdx && (best - stickyRssi) <= kStickyRssiMarginDb) {
-      bestIdx = stickyIdx;
-      best = stickyRssi;
-    }
-  }
+// Reads the published summary: O(1), and the scan side is never held off.
+// outBestRssi is the proximity (TX-power-normalised) RSSI used for the state bands;
+// outBestRawRssi is what was actually measured.
+int countActiveDevicesAndBest(int* outBestRssi, int* outBestRawRssi, char* outBestName, size_t outBestNameLen,
+                              uint8_t outBestMac[6]) {
+  DeviceSummary s;
+  g_summary.read(s);
+  const DisplayChoice c = chooseDisplayed(s, g_veryCloseMac, millis(), kVeryCloseRssiDbm, kStickyRssiMarginDb);
+  const DeviceView* best = c.device;
 
   if (outBestName && outBestNameLen > 0) {
     outBestName[0] = '\0';
-    if (bestIdx >= 0) {
-      strncpy(outBestName, g_devices[bestIdx].name, outBestNameLen - 1);
+    if (best) {
+      strncpy(outBestName, best->name, outBestNameLen - 1);
       outBestName[outBestNameLen - 1] = '\0';
     }
   }
 
   if (outBestMac) {
     memset(outBestMac, 0, 6);
-    if (bestIdx >= 0) {
-      memcpy(outBestMac, g_devices[bestIdx].mac, 6);
-    }
+    if (best) memcpy(outBestMac, best->mac, 6);
   }
-  portEXIT_CRITICAL(&g_mux);
 
-  if (outBestRssi) *outBestRssi = best;
-  return count;
+  if (outBestRssi) *outBestRssi = best ? best->proxRssi : -127;
+  if (outBestRawRssi) *outBestRawRssi = best ? best->rawRssi : -127;
+  return c.count;
 }
 
 #if BLEWATCH_USE_NIMBLE
 
 class AdvCallbacks : public NimBLEAdvertisedDeviceCallbacks {
   void onResult(NimBLEAdvertisedDevice* dev) override {
-    if (!dev) return;
-    const int rssi = dev->getRSSI();
+    if (!dev) {
+      g_advDropped = g_advDropped + 1;
+      return;
+    }
+    // NimBLE keeps addresses little-endian (LSB first); the table, OUI check and the
+    // MAC label all use display order.
     const NimBLEAddress addr = dev->getAddress();
+    const uint8_t* native = addr.getNative();
     uint8_t mac[6];
-    memcpy(mac, addr.getNative(), 6);
+    for (int i = 0; i < 6; i++) mac[i] = native[5 - i];
 
-    // Only pull name when "very close" to keep callback lightweight.
-    if (rssi >= kVeryCloseRssiDbm) {
-      const std::string name = dev->getName();
-      noteDeviceSeen(mac, rssi, name.empty() ? nullptr : name.c_str());
-    } else {
-      noteDeviceSeen(mac, rssi);
-    }
+    AdvInfo adv;
+    advParse(dev->getPayload(), dev->getPayloadLength(), adv);
+    noteDeviceSeen(mac, dev->getRSSI(), adv);
   }
 };
 
 AdvCallbacks g_advCb;
 
-void bleTask(void* param) {
-  (void)param;
+using BleScanner = NimBLEScan;
+using BleScanResults = NimBLEScanResults;
 
+BleScanner* initScanner() {
   NimBLEDevice::init("");
-
   NimBLEScan* scan = NimBLEDevice::getScan();
   scan->setAdvertisedDeviceCallbacks(&g_advCb, true /* want duplicates */);
-  scan->setActiveScan(true);
-  scan->setInterval(kBleScanInterval);
-  scan->setWindow(kBleScanWindow);
-
-  while (true) {
-    // Run short scans repeatedly (keeps memory stable on Arduino builds)
-    scan->start(kBleScanDurationS /* seconds */, false /* is_continue */);
-    scan->clearResults();
-    vTaskDelay(pdMS_TO_TICKS(kBleScanLoopDelayMs));
-  }
+  return scan;
 }
 
 #else
 
 class AdvCallbacks : public BLEAdvertisedDeviceCallbacks {
+  // The by-value parameter is the library's signature; nothing below allocates.
   void onResult(BLEAdvertisedDevice dev) override {
-    // Keep callbacks lightweight.
-    const int rssi = dev.getRSSI();
-    const String s = dev.getAddress().toString();
-    uint8_t mac[6] = {0};
-    // Parse "aa:bb:cc:dd:ee:ff"
-    unsigned int b[6];
-    if (sscanf(s.c_str(), "%02x:%02x:%02x:%02x:%02x:%02x", &b[0], &b[1], &b[2], &b[3], &b[4], &b[5]) == 6) {
-      for (int i = 0; i < 6; i++) mac[i] = static_cast<uint8_t>(b[i]);
-
-      // Only pull name when "very close" to keep callback lightweight.
-      if (rssi >= kVeryCloseRssiDbm) {
-        const String name = dev.getName();
-        noteDeviceSeen(mac, rssi, (name.length() == 0) ? nullptr : name.c_str());
-      } else {
-        noteDeviceSeen(mac, rssi);
-      }
-    }
+    uint8_t mac[6];
+    memcpy(mac, *dev.getAddress().getNative(), sizeof(mac));  // Bluedroid: display order
+
+    AdvInfo adv;
+    advParse(dev.getPayload(), dev.getPayloadLength(), adv);
+    noteDeviceSeen(mac, dev.getRSSI(), adv);
   }
 };
 
@@ -388,26 +306,114 @@ void setBleCallbacksWithDuplicates(T* scan, BLEAdvertisedDeviceCallbacks* cb, ..
   scan->setAdvertisedDeviceCallbacks(cb);
 }
 
-void bleTask(void* param) {
-  (void)param;
+using BleScanner = BLEScan;
+using BleScanResults = BLEScanResults;
 
+BleScanner* initScanner() {
   BLEDevice::init("");
   BLEScan* scan = BLEDevice::getScan();
   setBleCallbacksWithDuplicates(scan, &g_advCb, 0);
-  scan->setActiveScan(true);
+  return scan;
+}
+
+#endif
+
+TaskHandle_t g_bleTask = nullptr;
+volatile bool g_scanRunning = false;
+
+// Only called if the stack ends the scan on its own (duration 0 never times out).
+void onScanEnded(BleScanResults results) {
+  (void)results;
+  g_scanRunning = false;
+  if (g_bleTask) xTaskNotifyGive(g_bleTask);
+}
+
+// Callbacks only: no per-device result list growing inside the library. NimBLE needs
+// to be told; Bluedroid stores nothing when duplicates are handed to a callback.
+template <typename T>
+auto disableResultStorage(T* scan, int) -> decltype(scan->setMaxResults(0), void()) {
+  scan->setMaxResults(0);
+}
+
+template <typename T>
+void disableResultStorage(T* scan, ...) {
+  (void)scan;
+}
+
+void reportScanStats() {
+  static uint32_t lastAdv = 0, lastDropped = 0, lastOnMs = 0, lastWallMs = 0;
+  static uint32_t lastUiEvents = 0, lastUiFallbacks = 0;
+  const uint32_t uiEvents = g_uiEventUpdates - lastUiEvents;
+  const uint32_t uiFallbacks = g_uiFallbackUpdates - lastUiFallbacks;
+  lastUiEvents += uiEvents;
+  lastUiFallbacks += uiFallbacks;
+  const uint32_t adv = g_advReceived - lastAdv;
+  const uint32_t dropped = g_advDropped - lastDropped;
+  const uint32_t onMs = g_scanOnMs - lastOnMs;
+  const uint32_t wallMs = g_scanWallMs - lastWallMs;
+  lastAdv = g_advReceived;
+  lastDropped = g_advDropped;
+  lastOnMs = g_scanOnMs;
+  lastWallMs = g_scanWallMs;
+  if (wallMs == 0) return;
+  // Duty = share of time a scan was running x share of each interval spent listening.
+  const uint32_t onPermille = static_cast<uint32_t>(static_cast<uint64_t>(onMs) * 1000 / wallMs);
+  const uint32_t dutyPermille = onPermille * kBleScanWindow / kBleScanInterval;
+  printf("ble: %lu adv/s, %lu dropped | scan on %lu.%lu%% x window %u%% = duty %lu.%lu%% | starts %lu"
+         " | ui %lu event / %lu fallback updates\r\n",
+         static_cast<unsigned long>(static_cast<uint64_t>(adv) * 1000 / wallMs), static_cast<unsigned long>(dropped),
+         static_cast<unsigned long>(onPermille / 10), static_cast<unsigned long>(onPermille % 10),
+         static_cast<unsigned>(kBleScanWindow * 100 / kBleScanInterval),
+         static_cast<unsigned long>(dutyPermille / 10), static_cast<unsigned long>(dutyPermille % 10),
+         static_cast<unsigned long>(g_scanStarts), static_cast<unsigned long>(uiEvents),
+         static_cast<unsigned long>(uiFallbacks));
+}
+
+void bleTask(void* param) {
+  (void)param;
+  g_bleTask = xTaskGetCurrentTaskHandle();
 
-  // Prefer a high duty-cycle scan when supported.
+  BleScanner* scan = initScanner();
+  disableResultStorage(scan, 0);
+  scan->setActiveScan(true);
   scan->setInterval(kBleScanInterval);
   scan->setWindow(kBleScanWindow);
 
+  int64_t lastUs = 0;
+  uint32_t lastReportMs = millis();
+  bool ouiChecked = false;
   while (true) {
-    scan->start(kBleScanDurationS /* seconds */, false /* is_continue */);
-    scan->clearResults();
-    vTaskDelay(pdMS_TO_TICKS(kBleScanLoopDelayMs));
+    if (!g_scanRunning) {
+      // Duration 0: scan until stopped. Results arrive on the callback only.
+      g_scanRunning = scan->start(0, onScanEnded, false);
+      if (g_scanRunning) {
+        if (g_scanStarts == 0) Boot_Mark("ble scan started");
+        g_scanStarts = g_scanStarts + 1;
+      }
+    }
+    // The OUI image CRC reads the whole partition; do it once the scan is already running.
+    if (!ouiChecked) {
+      ouiChecked = true;
+      OuiDb_Init();
+    }
+    const bool runningBefore = g_scanRunning;
+    const int64_t beforeUs = lastUs ? lastUs : esp_timer_get_time();
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(runningBefore ? 1000 : kBleRestartRetryMs));
+
+    // Woken at once by onScanEnded, so attributing the whole wait is accurate.
+    lastUs = esp_timer_get_time();
+    const uint32_t elapsedMs = static_cast<uint32_t>((lastUs - beforeUs) / 1000);
+    if (g_scanStarts > 0) g_scanWallMs = g_scanWallMs + elapsedMs;
+    if (runningBefore) g_scanOnMs = g_scanOnMs + elapsedMs;
+
+    const uint32_t nowMs = millis();
+    if (kBleStatsReportMs > 0 && (nowMs - lastReportMs) >= kBleStatsReportMs) {
+      reportScanStats();
+      lastReportMs = nowMs;
+    }
   }
 }
 
-#endif
 
 lv_obj_t* makeLabel(lv_obj_t* parent, const char* txt, lv_color_t color, const lv_font_t* font = nullptr) {
   lv_obj_t* lbl = lv_label_create(parent);
@@ -446,11 +452,11 @@ void buildUi() {
 
   makeLabel(panel, "Nearby devices", lv_color_hex(0xFFD000), &lv_font_montserrat_14);
 
-  g_countLabel = makeLabel(panel, "0", lv_color_hex(0xFFFFFF), &lv_font_montserrat_20);
-  lv_obj_align(g_countLabel, LV_ALIGN_CENTER, 0, 10);
-  lv_obj_set_style_text_font(g_countLabel, &lv_font_montserrat_20, 0);
-  lv_obj_set_style_text_letter_space(g_countLabel, 2, 0);
-  lv_obj_set_style_text_align(g_countLabel, LV_TEXT_ALIGN_CENTER, 0);
+  Ui_DigitFontInit(&g_countFont, &lv_font_montserrat_20, lv_color_hex(0xFFFFFF), lv_color_hex(0x0A2238),
+                   "0123456789", 2);
+  lv_obj_t* countLabel = Ui_DigitsCreate(&g_countDigits, panel, &g_countFont, 120, LV_TEXT_ALIGN_CENTER, 0);
+  lv_obj_align(countLabel, LV_ALIGN_CENTER, 0, 10);
+  Ui_DigitsSet(&g_countDigits, "0");
 
   g_bar = lv_bar_create(panel);
   lv_bar_set_range(g_bar, 0, 100);
@@ -461,8 +467,12 @@ void buildUi() {
   lv_obj_set_style_radius(g_bar, 5, 0);
 
   // RSSI + state
-  g_rssiLabel = makeLabel(g_root, "RSSI -- dBm", lv_color_hex(0x8BE9FD), &lv_font_montserrat_14);
-  lv_obj_align(g_rssiLabel, LV_ALIGN_TOP_MID, 0, 196);
+  Ui_DigitFontInit(&g_rssiFont, &lv_font_montserrat_14, lv_color_hex(0x8BE9FD), lv_color_hex(0x061322),
+                   "0123456789RSIdBm -", 0);
+  lv_obj_t* rssiLabel = Ui_DigitsCreate(&g_rssiDigits, g_root, &g_rssiFont, LV_PCT(100), LV_TEXT_ALIGN_CENTER,
+                                        kRssiLabelMinMs);
+  lv_obj_align(rssiLabel, LV_ALIGN_TOP_MID, 0, 196);
+  Ui_DigitsSet(&g_rssiDigits, "RSSI -- dBm");
 
   g_stateLabel = makeLabel(g_root, "FAR", lv_color_hex(0xFFFFFF), &lv_font_montserrat_20);
   lv_obj_align(g_stateLabel, LV_ALIGN_TOP_MID, 0, 230);
@@ -472,6 +482,10 @@ void buildUi() {
   lv_obj_align(g_nameLabel, LV_ALIGN_TOP_MID, 0, 258);
   lv_obj_set_style_text_align(g_nameLabel, LV_TEXT_ALIGN_CENTER, 0);
   lv_obj_add_flag(g_nameLabel, LV_OBJ_FLAG_HIDDEN);
+
+  Ui_Bind(&g_stateUi, g_stateLabel, 0);
+  Ui_Bind(&g_nameUi, g_nameLabel, 0);
+  Ui_Bind(&g_barUi, g_bar, 0);
 }
 
 float rssiToNearT(int bestRssi) {
@@ -490,119 +504,108 @@ float rssiToCloseT(int bestRssi) {
 
 void updateLedAndUi() {
   int bestRssi = -127;
+  int bestRawRssi = -127;
   char bestName[32] = {0};
   uint8_t bestMac[6] = {0};
-  const int count = countActiveDevicesAndBest(&bestRssi, bestName, sizeof(bestName), bestMac);
+  const int count = countActiveDevicesAndBest(&bestRssi, &bestRawRssi, bestName, sizeof(bestName), bestMac);
 
   // UI text
   char buf[64];
   snprintf(buf, sizeof(buf), "%d", count);
-  lv_label_set_text(g_countLabel, buf);
+  Ui_DigitsSet(&g_countDigits, buf);
 
-  if (bestRssi <= -120 || count == 0) {
-    lv_label_set_text(g_rssiLabel, "RSSI -- dBm");
+  if (bestRawRssi <= -120 || count == 0) {
+    Ui_DigitsSet(&g_rssiDigits, "RSSI -- dBm");
   } else {
-    snprintf(buf, sizeof(buf), "RSSI %d dBm", bestRssi);
-    lv_label_set_text(g_rssiLabel, buf);
+    snprintf(buf, sizeof(buf), "RSSI %d dBm", bestRawRssi);
+    Ui_DigitsSet(&g_rssiDigits, buf);
   }
 
   // Proximity state + bar + LED
   const uint32_t nowMs = millis();
 
   if (count == 0 || bestRssi < kFarRssiDbm) {
-    lv_label_set_text(g_stateLabel, "FAR");
-    lv_obj_add_flag(g_nameLabel, LV_OBJ_FLAG_HIDDEN);
-    lv_bar_set_value(g_bar, 0, LV_ANIM_OFF);
-    setLedColor(LED_OFF, 0);
+    Ui_SetText(&g_stateUi, "FAR");
+    Ui_SetHidden(&g_nameUi, true);
+    Ui_SetBarValue(&g_barUi, 0);
+    Led_Steady(LED_OFF, 0);
     // Reset VERY CLOSE tracking.
-    memset(g_veryCloseMac, 0, 6);
+    setStickyDevice(kNoMac);
     g_veryCloseStartMs = 0;
-    g_safeBlinkTriggered = false;
     return;
   }
 
   // Extra step: RSSI in [-80..-67) is "too far" (weak but present).
   if (bestRssi < kNearStartRssiDbm) {
-    lv_label_set_text(g_stateLabel, "TOO FAR");
-    lv_obj_add_flag(g_nameLabel, LV_OBJ_FLAG_HIDDEN);
-    lv_bar_set_value(g_bar, 0, LV_ANIM_OFF);
-    setLedColor(LED_ORANGE, 100);
+    Ui_SetText(&g_stateUi, "TOO FAR");
+    Ui_SetHidden(&g_nameUi, true);
+    Ui_SetBarValue(&g_barUi, 0);
+    Led_Steady(LED_ORANGE, 100);
     // Reset VERY CLOSE tracking.
-    memset(g_veryCloseMac, 0, 6);
+    setStickyDevice(kNoMac);
     g_veryCloseStartMs = 0;
-    g_safeBlinkTriggered = false;
     return;
   }
 
   if (bestRssi >= kVeryCloseRssiDbm) {
-    lv_label_set_text(g_stateLabel, "VERY CLOSE");
+    Ui_SetText(&g_stateUi, "VERY CLOSE");
 
     // Track how long this device has been VERY CLOSE.
     bool sameDevice = (memcmp(g_veryCloseMac, bestMac, 6) == 0);
     if (!sameDevice) {
-      memcpy(g_veryCloseMac, bestMac, 6);
+      setStickyDevice(bestMac);
       g_veryCloseStartMs = nowMs;
-      g_safeBlinkTriggered = false;  // Reset blink for new device.
     }
     const uint32_t dwellMs = nowMs - g_veryCloseStartMs;
 
     // After 3 seconds, check OUI for potential vulnerability.
+    OuiInfo vendor{};
+    const bool knownVendor = OuiDb_Lookup(bestMac, &vendor);
     bool showVulnWarning = false;
     if (dwellMs >= kVulnCheckDwellMs) {
-      showVulnWarning = isOuiPotentiallyVulnerable(bestMac);
+      showVulnWarning = knownVendor && vendor.flags != 0;
     }
 
-    // Build display string (name or MAC).
-    char displayBuf[48];
+    // Build display string (name, else vendor over MAC, else MAC).
+    char displayBuf[64];
     if (bestName[0] != '\0') {
       strncpy(displayBuf, bestName, sizeof(displayBuf) - 1);
       displayBuf[sizeof(displayBuf) - 1] = '\0';
+    } else if (knownVendor) {
+      char macBuf[18];
+      formatMac(bestMac, macBuf, sizeof(macBuf));
+      snprintf(displayBuf, sizeof(displayBuf), "%s\n%s", vendor.vendor, macBuf);
     } else {
       formatMac(bestMac, displayBuf, sizeof(displayBuf));
     }
 
-    lv_obj_clear_flag(g_nameLabel, LV_OBJ_FLAG_HIDDEN);
-    lv_label_set_text(g_nameLabel, displayBuf);
+    Ui_SetHidden(&g_nameUi, false);
+    Ui_SetText(&g_nameUi, displayBuf);
 
     // Color the label: red if potentially vulnerable, green if safe, default cyan while checking.
     if (dwellMs >= kVulnCheckDwellMs) {
       if (showVulnWarning) {
-        lv_obj_set_style_text_color(g_nameLabel, lv_color_hex(0xFF0000), 0);  // red
+        Ui_SetTextColor(&g_nameUi, lv_color_hex(0xFF0000));  // red
       } else {
-        lv_obj_set_style_text_color(g_nameLabel, lv_color_hex(0x00FF00), 0);  // green
+        Ui_SetTextColor(&g_nameUi, lv_color_hex(0x00FF00));  // green
       }
     } else {
-      lv_obj_set_style_text_color(g_nameLabel, lv_color_hex(0x8BE9FD), 0);  // cyan (checking...)
+      Ui_SetTextColor(&g_nameUi, lv_color_hex(0x8BE9FD));  // cyan (checking...)
     }
 
-    lv_bar_set_value(g_bar, 100, LV_ANIM_OFF);
+    Ui_SetBarValue(&g_barUi, 100);
 
     // LED behavior.
     if (showVulnWarning) {
       // Vulnerable: steady red.
-      setLedColor(LED_RED, 100);
+      Led_Steady(LED_RED, 100);
     } else if (dwellMs >= kVulnCheckDwellMs) {
-      // Safe: blink green twice, then steady blue.
-      if (!g_safeBlinkTriggered) {
-        g_safeBlinkTriggered = true;
-        g_safeBlinkStartMs = nowMs;
-      }
-      const uint32_t blinkElapsed = nowMs - g_safeBlinkStartMs;
-      if (blinkElapsed < kBlinkDurationMs) {
-        // Two blinks in 600ms: on 0-100, off 100-200, on 200-300, off 300-400, then done.
-        const uint32_t phase = blinkElapsed % 200;
-        const uint32_t cycle = blinkElapsed / 200;
-        if (cycle < 2 && phase < 100) {
-          setLedColor(LED_GREEN, 100);  // Blink on.
-        } else {
-          setLedColor(LED_OFF, 0);      // Blink off.
-        }
-      } else {
-        setLedColor(LED_BLUE, 100);     // After blink, steady blue.
-      }
+      // Safe: blink green twice, then steady blue. Re-submitting the same effect every
+      // tick does not restart it; it restarts after the LED was set to anything else.
+      Led_BlinkThen(LED_GREEN, kSafeBlinkCount, kSafeBlinkOnMs, kSafeBlinkOffMs, LED_BLUE, 100);
     } else {
       // Still checking: steady blue.
-      setLedColor(LED_BLUE, 100);
+      Led_Steady(LED_BLUE, 100);
     }
     return;
   }
@@ -610,10 +613,10 @@ void updateLedAndUi() {
   // Close: steady green in [-50..-40)
   if (bestRssi >= kCloseStartRssiDbm) {
     const float ct = rssiToCloseT(bestRssi);
-    lv_label_set_text(g_stateLabel, "CLOSE");
-    lv_obj_add_flag(g_nameLabel, LV_OBJ_FLAG_HIDDEN);
-    lv_bar_set_value(g_bar, static_cast<int>(70.0f + ct * 30.0f + 0.5f), LV_ANIM_OFF);
-    setLedColor(LED_CYAN, 100);
+    Ui_SetText(&g_stateUi, "CLOSE");
+    Ui_SetHidden(&g_nameUi, true);
+    Ui_SetBarValue(&g_barUi, static_cast<int>(70.0f + ct * 30.0f + 0.5f));
+    Led_Steady(LED_CYAN, 100);
     return;
   }
 
@@ -627,18 +630,17 @@ void updateLedAndUi() {
   const uint8_t peak = static_cast<uint8_t>(kNearMinBrightness + (kNearMaxBrightness - kNearMinBrightness) * t);
   const uint8_t trough = static_cast<uint8_t>((kNearAvgBrightness > 20) ? (kNearAvgBrightness - 20) : 10);
 
-  const float phase = (static_cast<float>(nowMs) / 1000.0f) * (2.0f * kPi * hz);
-  const float s = 0.5f * (1.0f + sinf(phase)); // 0..1
-  const uint8_t b = static_cast<uint8_t>(trough + (peak - trough) * s);
+  const uint16_t periodMs = static_cast<uint16_t>(1000.0f / hz + 0.5f);
 
-  lv_label_set_text(g_stateLabel, "NEAR");
-  lv_obj_add_flag(g_nameLabel, LV_OBJ_FLAG_HIDDEN);
-  lv_bar_set_value(g_bar, static_cast<int>(t * 70.0f + 0.5f), LV_ANIM_OFF);
-  setLedColor(LED_GREEN, b);
+  Ui_SetText(&g_stateUi, "NEAR");
+  Ui_SetHidden(&g_nameUi, true);
+  Ui_SetBarValue(&g_barUi, static_cast<int>(t * 70.0f + 0.5f));
+  Led_Pulse(LED_GREEN, trough, peak, periodMs);  // Waveform runs in the LED driver
 }
 
 void uiTimerCb(lv_timer_t* t) {
   (void)t;
+  g_uiFallbackUpdates = g_uiFallbackUpdates + 1;
   updateLedAndUi();
 }
 
@@ -646,12 +648,62 @@ void uiTimerCb(lv_timer_t* t) {
 
 void Blewatch_Init(void) {
   // RGB LED init
-  g_rgb.begin();
-  g_rgb.setBrightness(255);
-  g_rgb.clear();
-  g_rgb.show();
+  Led_Init(kRgbPin, kRgbOrder, 255);
 
   buildUi();
+  Blewatch_StartScan();
+
+  g_uiTimer = lv_timer_create(uiTimerCb, kUiFallbackMs, nullptr);
+  updateLedAndUi();
+  Lvgl_SetService(Blewatch_ServiceEvents);
+}
+
+uint32_t Blewatch_ServiceEvents(void) {
+  if (!g_uiTimer || !g_uiEventPending.load(std::memory_order_acquire)) return LV_NO_TIMER_READY;
+  const uint32_t nowMs = millis();
+  const uint32_t sinceMs = nowMs - g_lastUiEventMs;
+  if (sinceMs < kUiEventMinMs) return kUiEventMinMs - sinceMs;  // Stays pending
+  g_uiEventPending.store(false, std::memory_order_relaxed);
+  g_lastUiEventMs = nowMs;
+  g_uiEventUpdates = g_uiEventUpdates + 1;
+  updateLedAndUi();
+  // Render now instead of on the next refresh period, and restart the fallback.
+  lv_timer_ready(lv_display_get_refr_timer(lv_display_get_default()));
+  lv_timer_reset(g_uiTimer);
+  return LV_NO_TIMER_READY;
+}
+
+void Blewatch_GetScanStats(BlewatchScanStats* out) {
+  out->advertisements = g_advReceived;
+  out->dropped = g_advDropped;
+  out->scanStarts = g_scanStarts;
+  out->scanOnMs = g_scanOnMs;
+  out->wallMs = g_scanWallMs;
+  out->windowPermille = static_cast<uint16_t>(kBleScanWindow * 1000u / kBleScanInterval);
+}
+
+void Blewatch_StartScan(void) {
+  static bool started = false;
+  if (started) return;
+  started = true;
+
+  Stats_Init("blewatch");
+  Stats_AddTimer("adv", &g_advStats);
+  Stats_AddCounter("adv", [] { return static_cast<uint32_t>(g_advReceived); });
+  Stats_AddCounter("adv_drops", [] { return static_cast<uint32_t>(g_advDropped); });
+  Stats_AddCounter("scan_starts", [] { return static_cast<uint32_t>(g_scanStarts); });
+  Stats_AddCounter("ui_events", [] { return static_cast<uint32_t>(g_uiEventUpdates); });
+  Stats_AddCounter("ui_fallbacks", [] { return static_cast<uint32_t>(g_uiFallbackUpdates); });
+  Stats_AddCounter("ui_flush_px", [] {
+    Ui_Stats st;
+    Ui_GetStats(&st);
+    return st.flushedPx;
+  });
+  Stats_AddCounter("ui_saved_px", [] {
+    Ui_Stats st;
+    Ui_GetStats(&st);
+    return st.savedPx;
+  });
 
   // Start BLE scan task
   xTaskCreatePinnedToCore(
@@ -663,7 +715,11 @@ void Blewatch_Init(void) {
     nullptr,
     0
   );
+}
 
-  lv_timer_create(uiTimerCb, kUiIntervalMs, nullptr);
-  updateLedAndUi();
+void Blewatch_PollSerial(void) {
+  while (Serial.available() > 0) {
+    if (Serial.read() == 's') Stats_Dump();
+  }
+  Stats_Poll();
 }
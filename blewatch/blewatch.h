@@ -1,11 +1,38 @@
 #pragma once
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 void Blewatch_Init(void);
 
+// Start the BLE scan task. Safe to call before the display or LVGL are up
+// (and again later; it only starts once).
+void Blewatch_StartScan(void);
+
+// Event-driven UI: the scan side wakes the LVGL task (Lvgl_Wake) when the displayed
+// device, its proximity band or the active count changes. This is the LVGL service
+// hook (Lvgl_SetService, set by Blewatch_Init): it applies a pending change and
+// returns the ms until it needs calling again, LV_NO_TIMER_READY (~0) when idle.
+uint32_t Blewatch_ServiceEvents(void);
+
+// Cumulative scan counters. Effective duty cycle = scanOnMs / wallMs * windowPermille.
+typedef struct {
+  uint32_t advertisements;  // Advertisement callbacks received
+  uint32_t dropped;         // Callbacks that could not be recorded (device table full)
+  uint32_t scanStarts;      // 1 while the continuous scan has never been interrupted
+  uint32_t scanOnMs;        // Time a scan was running
+  uint32_t wallMs;          // Time since the first scan start
+  uint16_t windowPermille;  // Scan window / interval
+} BlewatchScanStats;
+
+void Blewatch_GetScanStats(BlewatchScanStats* out);
+
+// Serial commands: 's' prints a hot-path stats JSON line (Hot_Stats.h). Call from loop().
+void Blewatch_PollSerial(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,12 +1,26 @@
 #include "Display_ST7789.h"
 #include "LVGL_Driver.h"
+#include "Boot_Timing.h"
+#include "blewatch.h"
 
 void setup() {
-  LCD_Init();
+  Boot_Mark("setup");
+  Serial.begin(115200);  // Serial commands (Blewatch_PollSerial)
+  // Only asserts panel reset (no waiting), so the reset settle overlaps BLE bring-up.
+  LCD_InitAsync();
+  // Scan before any UI work; the panel sequence continues from loop().
+  Blewatch_StartScan();
   Lvgl_Init();
 }
 
 void loop() {
-  Timer_Loop();
-  delay(5);
+  if (!LCD_InitStep()) {
+    // Panel init is still running; poll it without rendering.
+    delay(1);
+    return;
+  }
+  // Panel ready: LVGL runs in its own task, and scanning in bleTask.
+  Lvgl_StartTask();
+  Blewatch_PollSerial();
+  delay(20);
 }
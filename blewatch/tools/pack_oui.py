@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""Packs the IEEE OUI registry into the image read by Oui_Db.cpp.
+
+Usage:
+    pack_oui.py oui.csv [-o oui.bin] [--flags vulnerable_ouis.csv]
+
+oui.csv is the MA-L registry from https://standards-oui.ieee.org/oui/oui.csv.
+Write the result to the "oui" partition without touching the app:
+    parttool.py --port PORT write_partition --partition-name oui --input oui.bin
+
+Layout (little-endian), must match Oui_Db.cpp:
+    header  32 B  magic "OUI1", u16 version, u16 record size, u32 count,
+                  u32 records offset, u32 names offset, u32 names size,
+                  u32 CRC-32 (zlib) of records + names, u32 reserved
+    records 8 B   oui[3] big-endian, u8 flags, u32 name offset; sorted by OUI
+    names         deduplicated NUL-terminated vendor names
+"""
+
+import argparse
+import csv
+import os
+import re
+import struct
+import sys
+import zlib
+
+MAGIC = 0x3149554F
+VERSION = 1
+HEADER = struct.Struct("<IHHIIIIII")
+RECORD = struct.Struct("<3sBI")
+PARTITION_SIZE = 0xE0000  # partitions.csv
+
+FLAG_BITS = {"blueborne": 0x01, "sweyntooth": 0x02, "braktooth": 0x04, "legacy": 0x08}
+
+# Corporate suffixes dropped so names fit the 172 px label.
+SUFFIX = re.compile(
+    r"[\s,.]+(inc|incorporated|corp|corporation|co|company|ltd|limited|llc|gmbh|ag|sa|"
+    r"s\.a|bv|b\.v|oy|ab|plc|pte|pty|srl|spa|kg|as|technology|technologies|electronics)\.?$",
+    re.IGNORECASE)
+
+
+def parse_oui(text):
+    digits = re.sub(r"[^0-9A-Fa-f]", "", text)
+    if len(digits) != 6:
+        raise ValueError("bad OUI '%s'" % text)
+    return bytes.fromhex(digits)
+
+
+def short_name(name, max_len):
+    name = " ".join(name.split())
+    prev = None
+    while prev != name:
+        prev = name
+        name = SUFFIX.sub("", name).strip(" ,.")
+    if len(name) > max_len:
+        cut = name.rfind(" ", 0, max_len + 1)
+        name = name[:cut if cut > max_len // 2 else max_len].rstrip(" ,.-&")
+    return name or "?"
+
+
+def read_registry(path, max_len):
+    vendors = {}
+    with open(path, newline="", encoding="utf-8", errors="replace") as f:
+        for row in csv.DictReader(f):
+            oui = parse_oui(row["Assignment"])
+            vendors[oui] = short_name(row["Organization Name"], max_len)
+    return vendors
+
+
+def read_flags(path, vendors, max_len):
+    flags = {}
+    with open(path, newline="", encoding="utf-8") as f:
+        for line_no, row in enumerate(csv.reader(f), 1):
+            if not row or row[0].lstrip().startswith("#"):
+                continue
+            oui = parse_oui(row[0])
+            bits = 0
+            for name in row[1].split("|"):
+                name = name.strip().lower()
+                if name not in FLAG_BITS:
+                    sys.exit("%s:%d: unknown flag '%s'" % (path, line_no, name))
+                bits |= FLAG_BITS[name]
+            flags[oui] = flags.get(oui, 0) | bits
+            if oui not in vendors and len(row) > 2:
+                vendors[oui] = short_name(row[2], max_len)
+    return flags
+
+
+def pack(vendors, flags):
+    pool = bytearray()
+    offsets = {}
+    records = bytearray()
+    for oui in sorted(vendors):
+        name = vendors[oui]
+        if name not in offsets:
+            offsets[name] = len(pool)
+            pool += name.encode("utf-8") + b"\0"
+        records += RECORD.pack(oui, flags.get(oui, 0), offsets[name])
+    records_offset = HEADER.size
+    names_offset = records_offset + len(records)
+    crc = zlib.crc32(bytes(records) + bytes(pool)) & 0xFFFFFFFF
+    header = HEADER.pack(MAGIC, VERSION, RECORD.size, len(vendors), records_offset,
+                         names_offset, len(pool), crc, 0)
+    return header + bytes(records) + bytes(pool), len(offsets)
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("registry", help="IEEE MA-L oui.csv")
+    ap.add_argument("-o", "--output", default="oui.bin")
+    ap.add_argument("--flags", default=os.path.join(here, "vulnerable_ouis.csv"))
+    ap.add_argument("--max-name", type=int, default=20, help="vendor name length cap")
+    ap.add_argument("--partition-size", type=lambda s: int(s, 0), default=PARTITION_SIZE)
+    args = ap.parse_args()
+
+    vendors = read_registry(args.registry, args.max_name)
+    flags = read_flags(args.flags, vendors, args.max_name)
+    image, unique = pack(vendors, flags)
+    if len(image) > args.partition_size:
+        sys.exit("image is %d B, partition only %d B" % (len(image), args.partition_size))
+    with open(args.output, "wb") as f:
+        f.write(image)
+    print("%s: %d prefixes (%d flagged), %d unique names, %d B (%.0f%% of partition)" %
+          (args.output, len(vendors), sum(1 for v in flags.values() if v), unique, len(image),
+           100.0 * len(image) / args.partition_size))
+
+
+if __name__ == "__main__":
+    main()
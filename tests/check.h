@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Minimal assertion harness for the host tests: each test file is one executable,
+// CHECK failures are printed and counted, and main() returns checkResult().
+
+inline int& checkFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(cond)                                                                   \
+    do {                                                                              \
+        if (!(cond)) {                                                                \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);           \
+            checkFailures()++;                                                        \
+        }                                                                             \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                                \
+    do {                                                                              \
+        const long long va_ = static_cast<long long>(a);                              \
+        const long long vb_ = static_cast<long long>(b);                              \
+        if (va_ != vb_) {                                                             \
+            printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, \
+                   #a, #b, va_, vb_);                                                 \
+            checkFailures()++;                                                        \
+        }                                                                             \
+    } while (0)
+
+inline int checkResult(const char* name) {
+    if (checkFailures()) {
+        printf("%s: %d check(s) failed\n", name, checkFailures());
+        return EXIT_FAILURE;
+    }
+    printf("%s: ok\n", name);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,65 @@
+#include <string.h>
+#include "Adv_Parser.h"
+#include "check.h"
+
+namespace {
+
+void testTypicalPayload() {
+  const uint8_t p[] = {
+    0x02, kAdFlags, 0x06,
+    0x02, kAdTxPower, 0xF4,                            // -12 dBm
+    0x05, kAdShortName, 'P', 'h', 'o', 'n',
+    0x08, kAdCompleteName, 'P', 'h', 'o', 'n', 'e', ' ', '9',
+    0x05, kAdManufacturer, 0x4C, 0x00, 0x10, 0x05,     // Apple
+    0x05, kAdServiceData16, 0xAA, 0xFE, 0x01, 0x02,
+  };
+  AdvInfo a;
+  CHECK(advParse(p, sizeof(p), a));
+  CHECK(a.hasFlags);
+  CHECK_EQ(a.flags, 0x06);
+  CHECK(a.hasTxPower);
+  CHECK_EQ(a.txPowerDbm, -12);
+  CHECK(a.nameComplete);
+  CHECK_EQ(a.nameLen, 7);
+  CHECK(memcmp(a.name, "Phone 9", 7) == 0);
+  CHECK(a.hasCompanyId);
+  CHECK_EQ(a.companyId, 0x004C);
+  CHECK_EQ(a.mfgLen, 2);
+  CHECK(a.hasServiceData16);
+  CHECK_EQ(a.serviceData16Uuid, 0xFEAA);
+  CHECK_EQ(a.serviceDataLen, 2);
+}
+
+void testMalformed() {
+  // Second structure claims more bytes than are left: the first is kept.
+  const uint8_t p[] = {0x02, kAdFlags, 0x1A, 0x09, kAdCompleteName, 'a', 'b'};
+  AdvInfo a;
+  CHECK(!advParse(p, sizeof(p), a));
+  CHECK(a.hasFlags);
+  CHECK(a.name == nullptr);
+
+  // Zero padding ends the walk cleanly.
+  const uint8_t padded[] = {0x02, kAdTxPower, 0x00, 0x00, 0xFF, 0xFF};
+  AdvInfo b;
+  CHECK(advParse(padded, sizeof(padded), b));
+  CHECK(b.hasTxPower);
+
+  AdvInfo c;
+  CHECK(advParse(nullptr, 0, c));
+  CHECK(!advParse(nullptr, 3, c));
+
+  // Fields too short for their type are ignored.
+  const uint8_t shortMfg[] = {0x02, kAdManufacturer, 0x4C, 0x01, kAdTxPower};
+  AdvInfo d;
+  CHECK(advParse(shortMfg, sizeof(shortMfg), d));
+  CHECK(!d.hasCompanyId);
+  CHECK(!d.hasTxPower);
+}
+
+} // namespace
+
+int main() {
+  testTypicalPayload();
+  testMalformed();
+  return checkResult("test_adv_parser");
+}
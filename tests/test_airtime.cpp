@@ -0,0 +1,106 @@
+#include "Airtime.h"
+#include "Busy_Score.h"
+#include "Dwell_Metrics.h"
+#include "check.h"
+
+namespace {
+
+constexpr uint32_t kDwellUs = 260000;
+
+FrameRecord makeFrame(uint16_t len, uint8_t rate, uint32_t talker) {
+    FrameRecord rec{};
+    rec.len = len;
+    rec.rssi = -70;
+    rec.rate = rate;
+    rec.ta[0] = 0x02;
+    rec.ta[5] = static_cast<uint8_t>(talker);
+    return rec;
+}
+
+void testTable() {
+    CHECK_EQ(frameAirtimeUs(0x00, 200), 192 + 1600);  // 1 Mbps long preamble
+    CHECK_EQ(frameAirtimeUs(0x05, 200), 96 + 800);    // 2 Mbps short preamble
+    CHECK_EQ(frameAirtimeUs(0x0B, 100), 30 + 133);    // 6 Mbps OFDM; exact with padding is 166
+    CHECK_EQ(frameAirtimeUs(kAirtimeHeSu + 11, 200), 50 + 11);
+    CHECK_EQ(frameAirtimeUs(kAirtimeHt40 + 7, 1500), 42 + 89);
+    CHECK_EQ(frameAirtimeUs(kAirtimeHt20, 0), 42 + 3);  // SERVICE and tail alone
+    // Out-of-range indices fall back to the unknown entry.
+    CHECK_EQ(frameAirtimeUs(200, 300), frameAirtimeUs(kAirtimeUnknown, 300));
+    CHECK_EQ(frameAirtimeUs(kAirtimeUnknown, 300), frameAirtimeUs(kAirtimeHeSu, 300));
+
+    // Per rate family, faster entries never cost more.
+    const uint8_t families[][2] = {{kAirtimeHt20, 8}, {kAirtimeHt40, 8}, {kAirtimeHeSu, 12}, {kAirtimeHeErSu, 3}};
+    for (const auto& fam : families) {
+        for (uint8_t i = 1; i < fam[1]; i++) {
+            CHECK(frameAirtimeUs(fam[0] + i, 1500) < frameAirtimeUs(fam[0] + i - 1, 1500));
+        }
+    }
+}
+
+void testRateIndex() {
+    CHECK_EQ(airtimeRateIndex(kAirtimeBb11b, 0x00, 0), 0x00);
+    CHECK_EQ(airtimeRateIndex(kAirtimeBb11g, 0x0B, 0xFFFFFFFF), 0x0B);  // SIG ignored for non-HT
+    CHECK_EQ(airtimeRateIndex(kAirtimeBb11g, 0x1C, 0), 0x0C);          // Only the 4-bit rate code
+    CHECK_EQ(airtimeRateIndex(kAirtimeBbHt, 31, 0x05), kAirtimeHt20 + 5);
+    CHECK_EQ(airtimeRateIndex(kAirtimeBbHt, 0, 0x85), kAirtimeHt40 + 5);
+    CHECK_EQ(airtimeRateIndex(kAirtimeBbHt, 0, 0x0C), kAirtimeUnknown);  // Two streams
+    CHECK_EQ(airtimeRateIndex(kAirtimeBbHeSu, 0, 11u << 3 | 0x1), kAirtimeHeSu + 11);
+    CHECK_EQ(airtimeRateIndex(kAirtimeBbHeSu, 0, 13u << 3), kAirtimeUnknown);
+    CHECK_EQ(airtimeRateIndex(kAirtimeBbHeErSu, 0, 1u << 3), kAirtimeHeErSu + 1);
+    CHECK_EQ(airtimeRateIndex(kAirtimeBbHeErSu, 0, 3u << 3), kAirtimeUnknown);
+    CHECK_EQ(airtimeRateIndex(3, 0, 0), kAirtimeUnknown);  // VHT
+    CHECK_EQ(airtimeRateIndex(5, 0, 0), kAirtimeUnknown);  // HE MU
+
+    CHECK_EQ(airtimeLegacyIndex(2), 0x00);
+    CHECK_EQ(airtimeLegacyIndex(22), 0x03);
+    CHECK_EQ(airtimeLegacyIndex(12), 0x0B);
+    CHECK_EQ(airtimeLegacyIndex(108), 0x0C);
+    CHECK_EQ(airtimeLegacyIndex(0), kAirtimeUnknown);
+    CHECK_EQ(airtimeLegacyIndex(13), kAirtimeUnknown);
+}
+
+void testAccumulate() {
+    DwellAccum acc;
+    for (uint32_t i = 0; i < 10; i++) acc.add(makeFrame(200, 0x00, i), -65);
+    ChannelMetrics m = acc.snapshot(kDwellUs);
+    CHECK_EQ(m.airtimeUs, 10 * 1792);
+    CHECK_EQ(computeAirtimeScoreQ8(m, kDwellUs), 1764);  // 6.9% of the dwell
+
+    m.dwellUs = 0;  // Falls back to the nominal dwell
+    CHECK_EQ(computeAirtimeScoreQ8(m, kDwellUs), 1764);
+    CHECK_EQ(computeAirtimeScoreQ8(m, 0), 0);
+
+    m.airtimeUs = 2 * kDwellUs;  // Overlapping or misdecoded frames never exceed 100
+    CHECK_EQ(computeAirtimeScoreQ8(m, kDwellUs), kBusyScoreMax);
+
+    acc.clear();
+    CHECK_EQ(acc.snapshot(kDwellUs).airtimeUs, 0);
+}
+
+// Same frame and byte counts: the blended score cannot tell the rates apart.
+void testRateMatters() {
+    DwellAccum slow;
+    DwellAccum fast;
+    for (uint32_t i = 0; i < 40; i++) {
+        slow.add(makeFrame(300, 0x00, i), -65);
+        fast.add(makeFrame(300, kAirtimeHeSu + 11, i), -65);
+    }
+    const ChannelMetrics s = slow.snapshot(kDwellUs);
+    const ChannelMetrics f = fast.snapshot(kDwellUs);
+    CHECK_EQ(computeBusyScoreQ8(s, kDwellUs), computeBusyScoreQ8(f, kDwellUs));
+    const uint16_t slowAir = computeAirtimeScoreQ8(s, kDwellUs);
+    const uint16_t fastAir = computeAirtimeScoreQ8(f, kDwellUs);
+    CHECK_EQ(busyScorePoints(slowAir), 40);  // 40 x 2592 us in 260 ms
+    CHECK(fastAir > 0);
+    CHECK(slowAir > 30 * fastAir);
+}
+
+} // namespace
+
+int main() {
+    testTable();
+    testRateIndex();
+    testAccumulate();
+    testRateMatters();
+    return checkResult("test_airtime");
+}
@@ -0,0 +1,144 @@
+#include <math.h>
+#include "Busy_Score.h"
+#include "check.h"
+
+namespace {
+
+constexpr uint32_t kDwellUs = 260000;
+
+// The integer engine against the float formula it replaced, over a grid from idle to
+// far past saturation. One point is ~1% of the scale; the engine stays well within.
+void testMatchesFloatReference() {
+    const uint32_t frameCounts[] = {0, 1, 3, 10, 40, 100, 156, 400, 1000, 5000};
+    const uint32_t frameSizes[] = {60, 200, 1500};
+    const uint16_t uniques[] = {0, 1, 5, 20, 64, 300};
+    float worst = 0.0f;
+    for (uint32_t frames : frameCounts) {
+        for (uint32_t size : frameSizes) {
+            for (uint16_t unique : uniques) {
+                ChannelMetrics m;
+                m.frames = frames;
+                m.bytes = frames * size;
+                m.strong = static_cast<uint16_t>(frames / 3);
+                m.unique = unique;
+                m.dwellUs = kDwellUs;
+                const float ref = computeBusyScoreRef(m, kDwellUs);
+                const float q = computeBusyScoreQ8(m, kDwellUs) / static_cast<float>(kBusyScoreOne);
+                const float err = fabsf(ref - q);
+                if (err > worst) worst = err;
+            }
+        }
+    }
+    CHECK(worst < 0.05f);
+}
+
+void testBounds() {
+    ChannelMetrics idle;
+    CHECK_EQ(computeBusyScoreQ8(idle, kDwellUs), 0);
+    CHECK_EQ(computeBusyScoreQ8(idle, 0), 0);  // No dwell length at all
+
+    ChannelMetrics flood;
+    flood.frames = 100000;
+    flood.bytes = 100000 * 1500;
+    flood.strong = 60000;  // The strong term does not saturate: 0.2 * 0.6
+    flood.unique = 5000;
+    flood.dwellUs = kDwellUs;
+    const uint16_t s = computeBusyScoreQ8(flood, kDwellUs);
+    CHECK(busyScorePoints(s) == 92);
+    flood.strong = 0xFFFF;
+    flood.frames = 0xFFFF;
+    CHECK_EQ(computeBusyScoreQ8(flood, kDwellUs), kBusyScoreMax);
+
+    // dwellUs == 0 falls back to the nominal dwell.
+    ChannelMetrics m;
+    m.frames = 50;
+    m.bytes = 5000;
+    m.strong = 10;
+    m.unique = 4;
+    const uint16_t nominal = computeBusyScoreQ8(m, kDwellUs);
+    m.dwellUs = kDwellUs;
+    CHECK_EQ(computeBusyScoreQ8(m, kDwellUs), nominal);
+}
+
+void testMonotonicInFrames() {
+    uint16_t prev = 0;
+    for (uint32_t frames = 0; frames <= 2000; frames += 25) {
+        ChannelMetrics m;
+        m.frames = frames;
+        m.bytes = frames * 300;
+        m.dwellUs = kDwellUs;
+        const uint16_t s = computeBusyScoreQ8(m, kDwellUs);
+        CHECK(s >= prev);
+        prev = s;
+    }
+}
+
+void testLog2AndSqrt() {
+    CHECK_EQ(log2Q16(0), 0);
+    CHECK_EQ(log2Q16(1), 0);
+    CHECK_EQ(log2Q16(1024), 10u << 16);
+    for (uint64_t x = 3; x < (1ull << 40); x = x * 7 + 1) {
+        const double ref = log2(static_cast<double>(x)) * 65536.0;
+        CHECK(fabs(ref - log2Q16(x)) < 4.0);
+    }
+    CHECK_EQ(isqrt32(0), 0);
+    CHECK_EQ(isqrt32(1), 1);
+    CHECK_EQ(isqrt32(15), 3);
+    CHECK_EQ(isqrt32(16), 4);
+    CHECK_EQ(isqrt32(0xFFFFFFFFu), 65535);
+    for (uint32_t v = 0; v < 200000; v += 37) {
+        const uint32_t r = isqrt32(v);
+        CHECK(r * r <= v && (r + 1) * (r + 1) > v);
+    }
+}
+
+void testEma() {
+    constexpr uint16_t kAlpha = 14418;  // 0.22, as in bandwatch.cpp
+    uint16_t ema = 0;
+    uint32_t var = 0;
+    bool hasData = false;
+
+    updateBusyEma(ema, var, hasData, 40 * kBusyScoreOne, kAlpha);
+    CHECK(hasData);
+    CHECK_EQ(ema, 40 * kBusyScoreOne);  // First sample is taken as is
+    CHECK_EQ(var, 0);
+
+    // A constant input keeps the mean and lets the variance decay to zero.
+    for (int i = 0; i < 50; i++) updateBusyEma(ema, var, hasData, 40 * kBusyScoreOne, kAlpha);
+    CHECK_EQ(ema, 40 * kBusyScoreOne);
+    CHECK_EQ(var, 0);
+
+    // A step converges towards the new level and raises the spread on the way.
+    updateBusyEma(ema, var, hasData, 80 * kBusyScoreOne, kAlpha);
+    CHECK(ema > 40 * kBusyScoreOne && ema < 80 * kBusyScoreOne);
+    CHECK(busyStdDevQ8(var) > 5 * kBusyScoreOne);
+    for (int i = 0; i < 100; i++) updateBusyEma(ema, var, hasData, 80 * kBusyScoreOne, kAlpha);
+    CHECK(busyScorePoints(ema) >= 79 && busyScorePoints(ema) <= 80);
+    CHECK(busyStdDevQ8(var) < kBusyScoreOne);
+
+    // Float EMA of the same sequence.
+    ema = 0;
+    var = 0;
+    hasData = false;
+    float ref = 0.0f;
+    const uint16_t seq[] = {10, 70, 20, 90, 30, 30, 60, 5, 100, 45};
+    for (int round = 0; round < 5; round++) {
+        for (uint16_t p : seq) {
+            const uint16_t q = static_cast<uint16_t>(p * kBusyScoreOne);
+            ref = hasData ? ref + 0.22f * (p - ref) : p;
+            updateBusyEma(ema, var, hasData, q, kAlpha);
+        }
+    }
+    CHECK(fabsf(ref - ema / static_cast<float>(kBusyScoreOne)) < 0.5f);
+}
+
+} // namespace
+
+int main() {
+    testMatchesFloatReference();
+    testBounds();
+    testMonotonicInFrames();
+    testLog2AndSqrt();
+    testEma();
+    return checkResult("test_busy_score");
+}
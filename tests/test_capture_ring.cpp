@@ -0,0 +1,84 @@
+#include <thread>
+#include "Capture_Ring.h"
+#include "Dwell_Metrics.h"
+#include "check.h"
+
+namespace {
+
+void testFullAndEmpty() {
+    SpscRing<FrameRecord, 8> ring;
+    FrameRecord rec{};
+    CHECK(!ring.pop(rec));
+    for (uint16_t i = 0; i < 8; i++) {
+        rec.len = i;
+        CHECK(ring.push(rec));
+    }
+    CHECK(!ring.push(rec));
+    CHECK_EQ(ring.dropped(), 1);
+    CHECK_EQ(ring.size(), 8);
+    for (uint16_t i = 0; i < 8; i++) {
+        CHECK(ring.pop(rec));
+        CHECK_EQ(rec.len, i);
+    }
+    CHECK(!ring.pop(rec));
+}
+
+// One producer and one consumer thread: everything not counted as dropped arrives,
+// in order.
+void testConcurrent() {
+    static SpscRing<uint32_t, 64> ring;
+    constexpr uint32_t kItems = 200000;
+    uint32_t received = 0;
+    uint32_t last = 0;
+    bool ordered = true;
+    std::thread consumer([&] {
+        uint32_t v;
+        for (;;) {
+            if (!ring.pop(v)) {
+                std::this_thread::yield();
+                continue;
+            }
+            if (v == 0xFFFFFFFFu) break;
+            if (received > 0 && v <= last) ordered = false;
+            last = v;
+            received++;
+        }
+    });
+    for (uint32_t i = 1; i <= kItems; i++) ring.push(i);
+    const uint32_t dropped = ring.dropped();
+    while (!ring.push(0xFFFFFFFFu)) std::this_thread::yield();
+    consumer.join();
+    CHECK(ordered);
+    CHECK_EQ(received + dropped, kItems);
+}
+
+void testByteRing() {
+    static SpscByteRing<256> ring;
+    const uint8_t hdr[4] = {1, 2, 3, 4};
+    uint8_t data[100];
+    for (int i = 0; i < 100; i++) data[i] = static_cast<uint8_t>(i);
+    uint8_t out[104];
+    for (int round = 0; round < 20; round++) {  // Wraps the buffer several times
+        CHECK(ring.push(hdr, sizeof(hdr), data, sizeof(data)));
+        CHECK(ring.push(hdr, sizeof(hdr), data, sizeof(data)));
+        CHECK(!ring.push(hdr, sizeof(hdr), data, sizeof(data)));  // Dropped whole
+        for (int k = 0; k < 2; k++) {
+            CHECK(ring.read(out, sizeof(out)));
+            CHECK(memcmp(out, hdr, 4) == 0);
+            CHECK(memcmp(out + 4, data, 100) == 0);
+        }
+        CHECK_EQ(ring.available(), 0);
+    }
+    CHECK_EQ(ring.dropped(), 20);
+    CHECK_EQ(ring.droppedBytes(), 20 * 104);
+    CHECK(!ring.read(out, 1));
+}
+
+} // namespace
+
+int main() {
+    testFullAndEmpty();
+    testConcurrent();
+    testByteRing();
+    return checkResult("test_capture_ring");
+}
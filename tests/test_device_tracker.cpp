@@ -0,0 +1,168 @@
+#include "Device_Tracker.h"
+#include "check.h"
+
+namespace {
+
+constexpr int kVeryClose = -40;   // As kVeryCloseRssiDbm / kStickyRssiMarginDb in blewatch.cpp
+constexpr int kMargin = 10;
+constexpr uint8_t kNoMac[6] = {0};
+
+void macFor(uint32_t id, uint8_t mac[6]) {
+  mac[0] = 0xC0;
+  mac[1] = static_cast<uint8_t>(id >> 24);
+  mac[2] = static_cast<uint8_t>(id >> 16);
+  mac[3] = static_cast<uint8_t>(id >> 8);
+  mac[4] = static_cast<uint8_t>(id);
+  mac[5] = 0x42;
+}
+
+bool seen(DeviceTracker& t, uint32_t id, int rssi, uint32_t nowMs, const char* name = nullptr) {
+  uint8_t mac[6];
+  macFor(id, mac);
+  AdvInfo adv;
+  if (name) {
+    adv.name = name;
+    adv.nameLen = static_cast<uint8_t>(strlen(name));
+  }
+  return t.onAdvert(mac, rssi, adv, nowMs);
+}
+
+bool isDevice(const DeviceView* v, uint32_t id) {
+  uint8_t mac[6];
+  macFor(id, mac);
+  return v && memcmp(v->mac, mac, 6) == 0;
+}
+
+void testProximityRssi() {
+  DeviceSlot d;
+  d.lastRssi = -70;
+  CHECK_EQ(proximityRssi(d), -70);  // Unknown TX power: raw
+  d.txPowerDbm = -12;
+  CHECK_EQ(proximityRssi(d), -58);
+  d.txPowerDbm = -100;              // Implausible: compensation capped
+  CHECK_EQ(proximityRssi(d), -50);
+  d.lastRssi = -5;
+  d.txPowerDbm = -20;
+  CHECK_EQ(proximityRssi(d), 0);    // Never above 0 dBm
+}
+
+void testBestAndCount() {
+  DeviceTracker t;
+  uint32_t now = 1000;
+  for (uint32_t i = 0; i < 20; i++) CHECK(seen(t, i, -90 + static_cast<int>(i), now += 10));
+  const DeviceSummary& s = t.summary();
+  CHECK_EQ(activeCount(s, now), 20);
+  CHECK(isDevice(&s.best, 19));
+
+  // Repeat adverts from the same device do not inflate the count.
+  for (int k = 0; k < 10; k++) seen(t, 3, -80, now += 10);
+  CHECK_EQ(activeCount(t.summary(), now), 20);
+
+  // The name sticks across adverts that do not carry it.
+  seen(t, 19, -71, now += 10, "Pixel 9");
+  seen(t, 19, -71, now += 10);
+  CHECK(strcmp(t.summary().best.name, "Pixel 9") == 0);
+
+  const DisplayChoice c = chooseDisplayed(t.summary(), kNoMac, now, kVeryClose, kMargin);
+  CHECK_EQ(c.count, 20);
+  CHECK(isDevice(c.device, 19));
+}
+
+// Devices age out of the count and the best is recomputed when it fades.
+void testAging() {
+  DeviceTracker t;
+  uint32_t now = 5000;
+  seen(t, 1, -50, now);
+  seen(t, 2, -70, now + 100);
+  CHECK(isDevice(&t.summary().best, 1));
+
+  // Only device 2 keeps advertising.
+  for (now += 200; now < 5000 + kDeviceStaleMs + 1000; now += 100) seen(t, 2, -70, now);
+  CHECK_EQ(activeCount(t.summary(), now), 1);
+  CHECK(isDevice(&t.summary().best, 2));
+
+  // Nothing at all for longer than the stale window.
+  now += kDeviceStaleMs + 2 * kActiveBucketMs;
+  const DisplayChoice c = chooseDisplayed(t.summary(), kNoMac, now, kVeryClose, kMargin);
+  CHECK_EQ(c.count, 0);
+  CHECK(c.device == nullptr);
+}
+
+void testStickiness() {
+  DeviceTracker t;
+  uint32_t now = 1000;
+  seen(t, 7, -35, now);
+  uint8_t sticky[6];
+  macFor(7, sticky);
+  t.setSticky(sticky);
+  seen(t, 7, -35, now += 10);
+  CHECK(isDevice(&t.summary().sticky, 7));
+
+  // A slightly stronger device does not steal the display from a very close one...
+  seen(t, 8, -30, now += 10);
+  CHECK(isDevice(&t.summary().best, 8));
+  DisplayChoice c = chooseDisplayed(t.summary(), sticky, now, kVeryClose, kMargin);
+  CHECK(isDevice(c.device, 7));
+  CHECK_EQ(c.count, 2);
+
+  // ...a much stronger one does.
+  seen(t, 8, -20, now += 10);
+  c = chooseDisplayed(t.summary(), sticky, now, kVeryClose, kMargin);
+  CHECK(isDevice(c.device, 8));
+
+  // Once the sticky device drops out of VERY CLOSE the best wins again.
+  seen(t, 8, -32, now += 10);
+  seen(t, 7, -60, now += 10);
+  c = chooseDisplayed(t.summary(), sticky, now, kVeryClose, kMargin);
+  CHECK(isDevice(c.device, 8));
+
+  // Releasing the lock clears the tracked sticky device on the next advert.
+  t.setSticky(kNoMac);
+  seen(t, 8, -32, now += 10);
+  CHECK(!t.summary().sticky.valid);
+}
+
+// Far more devices over time than the table holds (rotating random addresses): stale
+// entries are reused or swept, so every advert is recorded.
+void testRotatingCrowd() {
+  DeviceTracker t;
+  uint32_t now = 1000;
+  int failed = 0;
+  for (uint32_t i = 0; i < 5000; i++) {
+    if (!seen(t, i, -60 - static_cast<int>(i % 30), now)) failed++;
+    now += 40;  // ~88 devices inside the stale window at any time
+  }
+  CHECK_EQ(failed, 0);
+  CHECK(t.table().size() <= DeviceTableT::kMaxLoad);
+  CHECK_EQ(t.table().lruEvicted(), 0);  // Live devices are never pushed out at this density
+  CHECK(t.table().staleReused() + t.table().sweptStale() > 4000);
+  const int active = activeCount(t.summary(), now);
+  CHECK(active >= 85 && active <= 89);
+}
+
+// A burst of new devices beyond the load limit: once probe paths are full the least
+// recently seen are evicted, and the active count follows the evictions.
+void testBurst() {
+  DeviceTracker t;
+  const uint32_t now = 1000;
+  int recorded = 0;
+  for (uint32_t i = 0; i < 2000; i++) {
+    if (seen(t, i, -70, now + i / 8)) recorded++;
+  }
+  CHECK(recorded >= 1900);
+  CHECK(t.table().size() < DeviceTableT::kCapacity);
+  CHECK(t.table().lruEvicted() > 0);
+  CHECK_EQ(activeCount(t.summary(), now + 250), static_cast<int>(t.table().size()));
+}
+
+} // namespace
+
+int main() {
+  testProximityRssi();
+  testBestAndCount();
+  testAging();
+  testStickiness();
+  testRotatingCrowd();
+  testBurst();
+  return checkResult("test_device_tracker");
+}
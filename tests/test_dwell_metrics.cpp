@@ -0,0 +1,135 @@
+#include "Dwell_Metrics.h"
+#include "check.h"
+
+namespace {
+
+FrameRecord makeFrame(uint16_t len, int8_t rssi, uint32_t talker) {
+    FrameRecord rec{};
+    rec.len = len;
+    rec.rssi = rssi;
+    rec.ta[0] = 0x02;
+    rec.ta[2] = static_cast<uint8_t>(talker >> 16);
+    rec.ta[3] = static_cast<uint8_t>(talker >> 8);
+    rec.ta[5] = static_cast<uint8_t>(talker);
+    return rec;
+}
+
+void testAccumulate() {
+    DwellAccum acc;
+    for (uint32_t i = 0; i < 100; i++) {
+        acc.add(makeFrame(100, (i % 4 == 0) ? -50 : -80, i % 10), -65);
+    }
+    const ChannelMetrics m = acc.snapshot(260000);
+    CHECK_EQ(m.frames, 100);
+    CHECK_EQ(m.bytes, 10000);
+    CHECK_EQ(m.strong, 25);
+    CHECK_EQ(m.unique, 10);  // Linear counting: exact this small
+    CHECK_EQ(m.dwellUs, 260000);
+
+    acc.clear();
+    const ChannelMetrics z = acc.snapshot(1);
+    CHECK_EQ(z.frames, 0);
+    CHECK_EQ(z.bytes, 0);
+    CHECK_EQ(z.strong, 0);
+    CHECK_EQ(z.unique, 0);
+}
+
+// The strong threshold is inclusive.
+void testStrongThreshold() {
+    DwellAccum acc;
+    acc.add(makeFrame(10, -65, 1), -65);
+    acc.add(makeFrame(10, -66, 1), -65);
+    CHECK_EQ(acc.snapshot(1).strong, 1);
+}
+
+void testTalkerEstimate() {
+    DwellAccum acc;
+    for (uint32_t i = 0; i < 2000; i++) acc.add(makeFrame(60, -70, i), -65);
+    const uint32_t u = acc.snapshot(1).unique;
+    CHECK(u > 1600 && u < 2400);  // 128 registers: ~9% standard error
+
+    DwellSketch a, b;
+    for (uint32_t i = 0; i < 50; i++) {
+        const FrameRecord r = makeFrame(1, 0, i);
+        a.add(hashMac48(r.ta));
+        const FrameRecord s = makeFrame(1, 0, i + 25);
+        b.add(hashMac48(s.ta));
+    }
+    a.merge(b);
+    const uint32_t merged = a.estimate();
+    CHECK(merged >= 68 && merged <= 82);  // Union of 0..49 and 25..74
+}
+
+// The integer estimate reproduces the original float formula (alpha * m^2 / sum, and
+// m * ln(m / zeros) for linear counting); expected values come from that formula.
+void testEstimateMatchesFloat() {
+    const uint32_t counts[] = {1, 5, 20, 60, 100, 200, 300, 320, 400, 1000, 5000, 50000};
+    const uint32_t expected[] = {1, 5, 22, 60, 101, 204, 266, 274, 394, 1085, 4992, 52242};
+    for (size_t k = 0; k < sizeof(counts) / sizeof(counts[0]); k++) {
+        DwellSketch s;
+        for (uint32_t i = 0; i < counts[k]; i++) {
+            const FrameRecord r = makeFrame(1, 0, i);
+            s.add(hashMac48(r.ta));
+        }
+        CHECK_EQ(s.estimate(), expected[k]);
+    }
+    DwellSketch empty;
+    CHECK_EQ(empty.estimate(), 0);
+}
+
+void testApplyDwell() {
+    ChannelState ch;
+    ChannelMetrics m;
+    m.frames = 10;
+    ch.applyDwell(m, 30 * kBusyScoreOne, 14418);
+    CHECK(ch.hasData);
+    CHECK_EQ(ch.busyCurrent, 30 * kBusyScoreOne);
+    CHECK_EQ(ch.busyEma, 30 * kBusyScoreOne);
+    CHECK_EQ(ch.metrics.frames, 10);
+    ch.applyDwell(m, 60 * kBusyScoreOne, 14418);
+    CHECK_EQ(ch.busyCurrent, 60 * kBusyScoreOne);
+    CHECK(ch.busyEma > 30 * kBusyScoreOne && ch.busyEma < 60 * kBusyScoreOne);
+}
+
+void testSortTop3() {
+    ChannelState chans[13];
+    int top[3];
+    sortTop3(chans, 13, top);
+    CHECK_EQ(top[0], -1);
+    CHECK_EQ(top[1], -1);
+    CHECK_EQ(top[2], -1);
+
+    chans[4].hasData = true;
+    chans[4].busyEma = 500;
+    sortTop3(chans, 13, top);
+    CHECK_EQ(top[0], 4);
+    CHECK_EQ(top[1], -1);
+
+    const uint16_t emas[13] = {100, 900, 300, 900, 500, 0, 50, 700, 10, 10, 10, 10, 899};
+    for (int i = 0; i < 13; i++) {
+        chans[i].hasData = true;
+        chans[i].busyEma = emas[i];
+    }
+    sortTop3(chans, 13, top);
+    CHECK_EQ(top[0], 1);   // Tie with 3: lower channel first
+    CHECK_EQ(top[1], 3);
+    CHECK_EQ(top[2], 12);
+
+    chans[1].hasData = false;  // No data never ranks, whatever its stale score
+    sortTop3(chans, 13, top);
+    CHECK_EQ(top[0], 3);
+    CHECK_EQ(top[1], 12);
+    CHECK_EQ(top[2], 7);
+}
+
+} // namespace
+
+int main() {
+    testAccumulate();
+    testStrongThreshold();
+    testTalkerEstimate();
+    testEstimateMatchesFloat();
+    testApplyDwell();
+    testSortTop3();
+    return checkResult("test_dwell_metrics");
+}
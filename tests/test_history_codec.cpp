@@ -0,0 +1,97 @@
+#include "History_Codec.h"
+#include "check.h"
+
+namespace {
+
+HistoryRecord makeRecord(uint32_t i) {
+    HistoryRecord r{};
+    r.timeMs = 10000 + i * 2600;
+    r.channel = static_cast<uint8_t>(1 + i % 13);
+    r.dwells = static_cast<uint16_t>(1 + i % 4);
+    r.frames = (i * 7919u) % 5000;
+    r.bytes = r.frames * (60 + i % 1400);
+    r.strong = r.frames / 3;
+    r.unique = static_cast<uint16_t>(i % 90);
+    r.scoreQ8 = static_cast<uint16_t>((i * 331u) % (100 * 256));
+    return r;
+}
+
+void testRoundTrip() {
+    uint8_t buf[64 * kHistoryMaxRecordBytes];
+    HistoryCodecState enc;
+    enc.reset(1000);
+    size_t len = 0;
+    for (uint32_t i = 0; i < 64; i++) {
+        const size_t n = historyEncode(enc, makeRecord(i), buf + len);
+        CHECK(n <= kHistoryMaxRecordBytes);
+        len += n;
+    }
+
+    HistoryCodecState dec;
+    dec.reset(1000);
+    const uint8_t* p = buf;
+    for (uint32_t i = 0; i < 64; i++) {
+        HistoryRecord r{};
+        CHECK(historyDecode(dec, p, buf + len, r));
+        const HistoryRecord want = makeRecord(i);
+        CHECK_EQ(r.timeMs, want.timeMs);
+        CHECK_EQ(r.channel, want.channel);
+        CHECK_EQ(r.dwells, want.dwells);
+        CHECK_EQ(r.frames, want.frames);
+        CHECK_EQ(r.bytes, want.bytes);
+        CHECK_EQ(r.strong, want.strong);
+        CHECK_EQ(r.unique, want.unique);
+        CHECK_EQ(r.scoreQ8, want.scoreQ8);
+    }
+    CHECK(p == buf + len);
+    HistoryRecord r{};
+    CHECK(!historyDecode(dec, p, buf + len, r));  // End of data
+}
+
+void testTruncatedAndCorrupt() {
+    uint8_t buf[kHistoryMaxRecordBytes];
+    HistoryCodecState enc;
+    enc.reset(0);
+    const size_t n = historyEncode(enc, makeRecord(5), buf);
+    for (size_t cut = 0; cut < n; cut++) {
+        HistoryCodecState dec;
+        dec.reset(0);
+        const uint8_t* p = buf;
+        HistoryRecord r{};
+        CHECK(!historyDecode(dec, p, buf + cut, r));
+    }
+    buf[0] = 0xFF;  // Erased flash
+    HistoryCodecState dec;
+    dec.reset(0);
+    const uint8_t* p = buf;
+    HistoryRecord r{};
+    CHECK(!historyDecode(dec, p, buf + n, r));
+}
+
+void testVarintAndCrc() {
+    const uint32_t values[] = {0, 1, 127, 128, 16383, 16384, 0xFFFFFFFFu};
+    for (uint32_t v : values) {
+        uint8_t buf[5];
+        const size_t n = historyPutVarint(buf, v);
+        const uint8_t* p = buf;
+        uint32_t out = 0;
+        CHECK(historyGetVarint(p, buf + n, out));
+        CHECK_EQ(out, v);
+        CHECK(p == buf + n);
+    }
+    CHECK_EQ(historyUnzigzag(historyZigzag(5, 9), 9), 5);
+    CHECK_EQ(historyZigzag(9, 10), 1);
+    CHECK_EQ(historyZigzag(10, 9), 2);
+
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    CHECK_EQ(historyCrc8(check, sizeof(check)), 0xF4);  // CRC-8/SMBUS check value
+}
+
+} // namespace
+
+int main() {
+    testRoundTrip();
+    testTruncatedAndCorrupt();
+    testVarintAndCrc();
+    return checkResult("test_history_codec");
+}
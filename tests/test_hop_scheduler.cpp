@@ -0,0 +1,117 @@
+#include "Hop_Scheduler.h"
+#include "check.h"
+
+namespace {
+
+constexpr int kChannels = 13;
+
+void testRoundRobin() {
+    HopScheduler<kChannels> hop;
+    hop.reset(0);
+    const uint16_t weights[kChannels] = {0};
+    int ch = 0;
+    for (int i = 1; i <= 2 * kChannels; i++) {
+        ch = hop.next(HopMode::RoundRobin, ch, i * 260, weights, 0, 4000, 3);
+        CHECK_EQ(ch, i % kChannels);
+    }
+}
+
+// Visits follow the weights when nothing is overdue.
+void testWeightedProportional() {
+    HopScheduler<kChannels> hop;
+    hop.reset(0);
+    uint16_t weights[kChannels] = {0};
+    weights[0] = 6;
+    weights[5] = 3;
+    weights[10] = 1;
+    int visits[kChannels] = {0};
+    int ch = 0;
+    for (int i = 0; i < 1000; i++) {
+        ch = hop.next(HopMode::Weighted, ch, 0, weights, 0, 0xFFFFFFFFu, 3);
+        visits[ch]++;
+    }
+    CHECK_EQ(visits[0], 600);
+    CHECK_EQ(visits[5], 300);
+    CHECK_EQ(visits[10], 100);
+}
+
+// Unweighted channels are still revisited within the revisit window, spaced out.
+void testRevisitFloor() {
+    HopScheduler<kChannels> hop;
+    hop.reset(0);
+    uint16_t weights[kChannels] = {0};
+    weights[0] = 1;
+    uint32_t lastSeen[kChannels] = {0};
+    uint32_t worstGap = 0;
+    int ch = 0;
+    int forcedRun = 0;
+    int worstForcedRun = 0;
+    for (uint32_t t = 260; t < 120000; t += 260) {
+        ch = hop.next(HopMode::Weighted, ch, t, weights, 0, 4000, 3);
+        forcedRun = (ch == 0) ? 0 : forcedRun + 1;
+        if (forcedRun > worstForcedRun) worstForcedRun = forcedRun;
+        for (int i = 0; i < kChannels; i++) {
+            if (i == ch) lastSeen[i] = t;
+            if (t - lastSeen[i] > worstGap) worstGap = t - lastSeen[i];
+        }
+    }
+    CHECK_EQ(worstForcedRun, 1);  // forceSpacing keeps catch-up visits apart
+    // Quiet channels take turns at one forced visit per forceSpacing + 1 hops, each
+    // once it is past revisitMs: 12 * 4 hops of 260 ms on top of the revisit window.
+    CHECK(worstGap <= 4000 + 12 * 4 * 260);
+}
+
+void testFocus() {
+    HopScheduler<kChannels> hop;
+    hop.reset(0);
+    const uint16_t weights[kChannels] = {9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9};
+    const uint16_t focus = (1u << 2) | (1u << 7);
+    int ch = 0;
+    for (int i = 0; i < 20; i++) {
+        ch = hop.next(HopMode::Focus, ch, 0, weights, focus, 0xFFFFFFFFu, 3);
+        CHECK(ch == 2 || ch == 7);
+    }
+}
+
+} // namespace
+
+// A node's channel share: picks never leave the mask, and one bit pins the channel.
+void testAllowMask() {
+    HopScheduler<kChannels> hop;
+    hop.reset(0);
+    uint16_t weights[kChannels];
+    for (int i = 0; i < kChannels; i++) weights[i] = static_cast<uint16_t>(10 + 20 * i);
+    const uint16_t share = (1u << 0) | (1u << 5) | (1u << 10);
+    int visits[kChannels] = {0};
+    int ch = 0;
+    for (int i = 1; i <= 300; i++) {
+        ch = hop.next(HopMode::Weighted, ch, i * 260, weights, 0, 4000, 1, share);
+        visits[ch]++;
+    }
+    int inShare = 0;
+    for (int i = 0; i < kChannels; i++) {
+        if (share & (1u << i)) {
+            CHECK(visits[i] > 0);
+            inShare += visits[i];
+        }
+    }
+    CHECK_EQ(inShare, 300);
+
+    for (int i = 1; i <= 2 * kChannels; i++) {
+        ch = hop.next(HopMode::RoundRobin, ch, 100000 + i * 260, weights, 0, 4000, 1, share);
+        CHECK(share & (1u << ch));
+    }
+    for (int i = 1; i <= 20; i++) {
+        ch = hop.next(HopMode::Weighted, ch, 200000 + i * 260, weights, 0, 4000, 1, 1u << 6);
+        CHECK_EQ(ch, 6);
+    }
+}
+
+int main() {
+    testRoundRobin();
+    testWeightedProportional();
+    testRevisitFloor();
+    testFocus();
+    testAllowMask();
+    return checkResult("test_hop_scheduler");
+}
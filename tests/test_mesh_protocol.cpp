@@ -0,0 +1,125 @@
+#include "Mesh_Protocol.h"
+#include "check.h"
+
+namespace {
+
+constexpr int kChannels = 13;
+constexpr uint16_t kAllChannels = (1u << kChannels) - 1;
+
+void makeMac(uint8_t last, uint8_t mac[6]) {
+    const uint8_t base[6] = {0x40, 0x4C, 0xCA, 0x10, 0x20, last};
+    memcpy(mac, base, 6);
+}
+
+// Every channel has exactly one owner and shares differ by at most one.
+void checkPartition(const MeshNodeTable& t) {
+    uint16_t seen = 0;
+    int minShare = kChannels;
+    int maxShare = 0;
+    for (uint8_t i = 0; i < t.count(); i++) {
+        const uint16_t m = t.node(i).channelMask;
+        CHECK_EQ(seen & m, 0);
+        seen |= m;
+        const int share = __builtin_popcount(m);
+        if (share < minShare) minShare = share;
+        if (share > maxShare) maxShare = share;
+    }
+    CHECK_EQ(seen, kAllChannels);
+    CHECK(maxShare - minShare <= 1);
+}
+
+void testAloneOwnsEverything() {
+    MeshNodeTable t;
+    uint8_t self[6];
+    makeMac(5, self);
+    t.reset(self, 0, kChannels);
+    CHECK_EQ(t.count(), 1);
+    CHECK_EQ(t.maskFor(self), kAllChannels);
+}
+
+void testJoinAndRebalance() {
+    MeshNodeTable t;
+    uint8_t self[6], a[6], b[6];
+    makeMac(5, self);
+    makeMac(2, a);
+    makeMac(9, b);
+    t.reset(self, 0, kChannels);
+
+    CHECK(t.heard(a, 8));
+    CHECK(!t.heard(a, 16));   // Known node: no reassignment
+    CHECK(t.heard(b, 16));
+    CHECK_EQ(t.count(), 3);
+    checkPartition(t);
+    CHECK_EQ(t.maskFor(a) & 1, 1);  // Lowest MAC is dealt channel 1
+    CHECK_EQ(__builtin_popcount(t.maskFor(a)), 5);
+
+    // b goes silent: its channels return to the others; the coordinator never expires.
+    t.heard(a, 48);
+    CHECK(!t.expire(48, 32));
+    CHECK(t.expire(56, 32));
+    CHECK_EQ(t.count(), 2);
+    CHECK_EQ(t.maskFor(b), 0);
+    checkPartition(t);
+    CHECK(t.expire(200, 32));
+    CHECK_EQ(t.count(), 1);
+    CHECK_EQ(t.maskFor(self), kAllChannels);
+}
+
+void testTableLimit() {
+    MeshNodeTable t;
+    uint8_t mac[6];
+    makeMac(0, mac);
+    t.reset(mac, 0, kChannels);
+    for (uint8_t i = 1; i < 20; i++) {
+        makeMac(i, mac);
+        t.heard(mac, i);
+    }
+    CHECK_EQ(t.count(), kMeshMaxNodes);
+    checkPartition(t);  // A full table pins every node to one channel
+    for (uint8_t i = 0; i < t.count(); i++) CHECK_EQ(__builtin_popcount(t.node(i).channelMask), 1);
+    makeMac(19, mac);
+    CHECK_EQ(t.maskFor(mac), 0);
+}
+
+void testMessageChecks() {
+    MeshReport r{};
+    meshInitHeader(r.hdr, kMeshReport, 24);
+    r.count = 3;
+    const size_t len = meshReportLen(3);
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&r);
+    CHECK_EQ(meshCheck(p, len), kMeshReport);
+    CHECK_EQ(meshCheck(p, len - 1), 0);           // Truncated dwell list
+    CHECK_EQ(meshCheck(p, len + 1), 0);           // Trailing bytes
+    uint8_t big[kMeshMaxPayload] = {};
+    memcpy(big, &r, sizeof(r));
+    CHECK_EQ(meshCheck(big, sizeof(big)), 0);      // Would not fit a MeshReport
+    r.count = kMeshMaxDwells + 1;
+    CHECK_EQ(meshCheck(p, sizeof(r)), 0);
+
+    MeshBeacon b{};
+    meshInitHeader(b.hdr, kMeshBeacon, 8);
+    b.nodeCount = 2;
+    const uint8_t* q = reinterpret_cast<const uint8_t*>(&b);
+    CHECK_EQ(meshCheck(q, meshBeaconLen(2)), kMeshBeacon);
+    CHECK_EQ(meshCheck(q, meshBeaconLen(1)), 0);
+    CHECK_EQ(meshCheck(q, meshBeaconLen(3)), 0);
+    memcpy(big, &b, sizeof(b));
+    CHECK_EQ(meshCheck(big, sizeof(big)), 0);      // 250 bytes against a 120-byte beacon
+    b.hdr.version = kMeshVersion + 1;
+    CHECK_EQ(meshCheck(q, meshBeaconLen(2)), 0);
+    CHECK_EQ(meshCheck(q, 4), 0);
+
+    CHECK(meshIsSyncSlot(0));
+    CHECK(!meshIsSyncSlot(1));
+    CHECK(meshIsSyncSlot(kMeshSyncEvery * 3));
+}
+
+} // namespace
+
+int main() {
+    testAloneOwnsEverything();
+    testJoinAndRebalance();
+    testTableLimit();
+    testMessageChecks();
+    return checkResult("test_mesh_protocol");
+}
@@ -0,0 +1,98 @@
+#include <string.h>
+#include <vector>
+#include "Oui_Image.h"
+#include "check.h"
+
+namespace {
+
+// Builds an image the way tools/pack_oui.py lays it out (CRC left at 0: checked on
+// the device only).
+std::vector<uint8_t> buildImage(const std::vector<OuiRecord>& records, const char* names, size_t namesSize) {
+  OuiImageHeader h{};
+  h.magic = kOuiImageMagic;
+  h.version = kOuiImageVersion;
+  h.recordSize = sizeof(OuiRecord);
+  h.count = static_cast<uint32_t>(records.size());
+  h.recordsOffset = sizeof(OuiImageHeader);
+  h.namesOffset = h.recordsOffset + h.count * sizeof(OuiRecord);
+  h.namesSize = static_cast<uint32_t>(namesSize);
+  std::vector<uint8_t> img(h.namesOffset + namesSize);
+  memcpy(img.data(), &h, sizeof(h));
+  memcpy(img.data() + h.recordsOffset, records.data(), records.size() * sizeof(OuiRecord));
+  memcpy(img.data() + h.namesOffset, names, namesSize);
+  return img;
+}
+
+void testLookup() {
+  std::vector<OuiRecord> records;
+  for (uint32_t i = 0; i < 1000; i++) {
+    const uint32_t key = i * 97 + 5;
+    OuiRecord r{};
+    r.oui[0] = static_cast<uint8_t>(key >> 16);
+    r.oui[1] = static_cast<uint8_t>(key >> 8);
+    r.oui[2] = static_cast<uint8_t>(key);
+    r.flags = static_cast<uint8_t>(i & 0x0F);
+    r.nameOffset = (i % 2) ? 4 : 0;
+    records.push_back(r);
+  }
+  const char names[] = "Foo\0Bar";
+  const std::vector<uint8_t> img = buildImage(records, names, sizeof(names));
+  CHECK_EQ(ouiCheckHeader(img.data(), static_cast<uint32_t>(img.size())), kOuiImageOk);
+
+  const OuiRecord* recs = reinterpret_cast<const OuiRecord*>(img.data() + sizeof(OuiImageHeader));
+  for (uint32_t i = 0; i < 1000; i++) {
+    const uint32_t key = i * 97 + 5;
+    const int32_t idx = ouiFindRecord(recs, 1000, key);
+    CHECK_EQ(idx, static_cast<int32_t>(i));
+    CHECK_EQ(ouiFindRecord(recs, 1000, key + 1), -1);
+  }
+  CHECK_EQ(ouiFindRecord(recs, 1000, 0), -1);
+  CHECK_EQ(ouiFindRecord(recs, 1000, 0xFFFFFF), -1);
+  CHECK_EQ(ouiFindRecord(recs, 0, 5), -1);
+
+  const uint8_t mac[6] = {0x00, 0x00, 0x05, 0x11, 0x22, 0x33};
+  CHECK_EQ(ouiKey(mac), 5);
+}
+
+void testBadHeaders() {
+  std::vector<OuiRecord> one(1);
+  const char names[] = "X";
+  const std::vector<uint8_t> good = buildImage(one, names, sizeof(names));
+  const uint32_t size = static_cast<uint32_t>(good.size());
+
+  std::vector<uint8_t> erased(64, 0xFF);
+  CHECK_EQ(ouiCheckHeader(erased.data(), 64), kOuiImageEmpty);
+  CHECK_EQ(ouiCheckHeader(good.data(), 16), kOuiImageEmpty);  // Shorter than a header
+
+  auto mutate = [&](void (*fn)(OuiImageHeader&)) {
+    std::vector<uint8_t> img = good;
+    OuiImageHeader h;
+    memcpy(&h, img.data(), sizeof(h));
+    fn(h);
+    memcpy(img.data(), &h, sizeof(h));
+    return ouiCheckHeader(img.data(), size);
+  };
+  CHECK_EQ(mutate([](OuiImageHeader& h) { h.version = 2; }), kOuiImageBadHeader);
+  CHECK_EQ(mutate([](OuiImageHeader& h) { h.recordSize = 12; }), kOuiImageBadHeader);
+  CHECK_EQ(mutate([](OuiImageHeader& h) { h.count = 0; }), kOuiImageBadHeader);
+  CHECK_EQ(mutate([](OuiImageHeader& h) { h.count = 1000000; }), kOuiImageBadHeader);
+  CHECK_EQ(mutate([](OuiImageHeader& h) { h.namesSize += 1; }), kOuiImageBadHeader);
+  CHECK_EQ(mutate([](OuiImageHeader& h) { h.recordsOffset = 2; }), kOuiImageBadHeader);
+
+  std::vector<uint8_t> unterminated = good;
+  unterminated.back() = 'Y';
+  CHECK_EQ(ouiCheckHeader(unterminated.data(), size), kOuiImageBadHeader);
+
+  // A larger partition than the image is fine (the rest is erased flash).
+  std::vector<uint8_t> padded = good;
+  padded.resize(4096, 0xFF);
+  CHECK_EQ(ouiCheckHeader(padded.data(), 4096), kOuiImageOk);
+}
+
+} // namespace
+
+int main() {
+  testLookup();
+  testBadHeaders();
+  return checkResult("test_oui_image");
+}
@@ -0,0 +1,116 @@
+#include <vector>
+#include "Pcap_Trace.h"
+#include "check.h"
+
+namespace {
+
+void put16(std::vector<uint8_t>& v, uint16_t x) {
+    v.push_back(static_cast<uint8_t>(x));
+    v.push_back(static_cast<uint8_t>(x >> 8));
+}
+
+void put32(std::vector<uint8_t>& v, uint32_t x) {
+    put16(v, static_cast<uint16_t>(x));
+    put16(v, static_cast<uint16_t>(x >> 16));
+}
+
+// Global header plus one record shaped like Pcap_Logger's: radiotap with Flags,
+// Channel and antenna signal, then a 24-byte beacon header.
+std::vector<uint8_t> loggerCapture(uint8_t channel, int8_t rssi, uint32_t payloadLen) {
+    std::vector<uint8_t> v;
+    put32(v, kPcapMagicUs);
+    put16(v, 2);
+    put16(v, 4);
+    put32(v, 0);
+    put32(v, 0);
+    put32(v, 4095);
+    put32(v, kPcapLinkRadiotap);
+
+    std::vector<uint8_t> rt = {0, 0};
+    put16(rt, 15);
+    put32(rt, (1u << 1) | (1u << 3) | (1u << 5));
+    rt.push_back(0x10);  // Flags: FCS at end
+    rt.push_back(0);     // Channel alignment
+    put16(rt, static_cast<uint16_t>(2407 + 5 * channel));
+    put16(rt, 0x0080);
+    rt.push_back(static_cast<uint8_t>(rssi));
+
+    std::vector<uint8_t> mac = {0x80, 0x00, 0, 0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                                0x02, 0x11, 0x22, 0x33, 0x44, 0x55, 0x02, 0x11, 0x22, 0x33, 0x44, 0x55, 0, 0};
+    mac.resize(mac.size() + payloadLen, 0xAB);
+
+    const uint32_t incl = static_cast<uint32_t>(rt.size() + mac.size());
+    put32(v, 3);        // 3.000250 s
+    put32(v, 250);
+    put32(v, incl);
+    put32(v, incl + 4);  // FCS not captured
+    v.insert(v.end(), rt.begin(), rt.end());
+    v.insert(v.end(), mac.begin(), mac.end());
+    return v;
+}
+
+void testLoggerFormat() {
+    const std::vector<uint8_t> cap = loggerCapture(11, -58, 100);
+    PcapTraceInfo info;
+    CHECK(pcapParseGlobal(cap.data(), cap.size(), info));
+    CHECK_EQ(info.linkType, kPcapLinkRadiotap);
+    CHECK(!info.nanoseconds);
+
+    PcapTraceFrame f;
+    size_t used = 0;
+    const uint8_t* p = cap.data() + kPcapGlobalHdrLen;
+    const size_t left = cap.size() - kPcapGlobalHdrLen;
+    CHECK(pcapNextFrame(info, p, left, f, used));
+    CHECK_EQ(used, left);
+    CHECK_EQ(f.tsUs, 3000250);
+    CHECK_EQ(f.channel, 11);
+    CHECK_EQ(f.rssi, -58);
+    CHECK_EQ(f.capLen, 124);
+    CHECK_EQ(f.origLen, 128);
+
+    FrameRecord rec{};
+    CHECK(pcapToFrameRecord(f, 7, rec));
+    CHECK_EQ(rec.len, 128);  // sig_len includes the FCS on the device too
+    CHECK_EQ(rec.rssi, -58);
+    CHECK_EQ(rec.type, 0);
+    CHECK_EQ(rec.epoch, 7);
+    CHECK_EQ(rec.ta[0], 0x02);
+    CHECK_EQ(rec.ta[5], 0x55);
+    CHECK_EQ(rec.rate, kAirtimeUnknown);  // The logger records no rate
+
+    CHECK(!pcapNextFrame(info, p + used, 0, f, used));
+}
+
+void testTruncatedAndForeign() {
+    std::vector<uint8_t> cap = loggerCapture(1, -70, 10);
+    PcapTraceInfo info;
+    CHECK(pcapParseGlobal(cap.data(), cap.size(), info));
+    PcapTraceFrame f;
+    size_t used = 0;
+    CHECK(!pcapNextFrame(info, cap.data() + kPcapGlobalHdrLen, cap.size() - kPcapGlobalHdrLen - 1, f, used));
+
+    std::vector<uint8_t> ether = cap;
+    ether[20] = 1;  // LINKTYPE_ETHERNET
+    CHECK(!pcapParseGlobal(ether.data(), ether.size(), info));
+    std::vector<uint8_t> swapped = cap;
+    swapped[0] = 0xA1;
+    swapped[3] = 0xD4;
+    CHECK(!pcapParseGlobal(swapped.data(), swapped.size(), info));
+
+    // A control frame too short for addr2 is skipped, as promiscuousCb would.
+    PcapTraceFrame ack{};
+    const uint8_t ackBytes[10] = {0xD4, 0};
+    ack.frame = ackBytes;
+    ack.capLen = sizeof(ackBytes);
+    ack.origLen = 14;
+    FrameRecord rec{};
+    CHECK(!pcapToFrameRecord(ack, 0, rec));
+}
+
+} // namespace
+
+int main() {
+    testLoggerFormat();
+    testTruncatedAndForeign();
+    return checkResult("test_pcap_trace");
+}
@@ -0,0 +1,124 @@
+#include "Top_Talkers.h"
+#include "check.h"
+
+namespace {
+
+using Talkers = TopTalkers<32>;
+
+void makeMac(uint32_t id, uint8_t mac[6]) {
+    mac[0] = 0x02;
+    mac[1] = 0x00;
+    mac[2] = static_cast<uint8_t>(id >> 24);
+    mac[3] = static_cast<uint8_t>(id >> 16);
+    mac[4] = static_cast<uint8_t>(id >> 8);
+    mac[5] = static_cast<uint8_t>(id);
+}
+
+// Below capacity every count is exact.
+void testExactWhenSmall() {
+    Talkers t;
+    uint8_t mac[6];
+    for (uint32_t i = 0; i < 20; i++) {
+        makeMac(i, mac);
+        for (uint32_t n = 0; n <= i; n++) t.add(mac, 100, 0);
+    }
+    CHECK_EQ(t.size(), 20);
+    for (uint32_t i = 0; i < 20; i++) {
+        makeMac(i, mac);
+        const Talkers::Entry* e = t.find(mac);
+        CHECK(e != nullptr);
+        if (!e) continue;
+        CHECK_EQ(e->frames, i + 1);
+        CHECK_EQ(e->bytes, (i + 1) * 100);
+        CHECK_EQ(e->error, 0);
+    }
+
+    Talkers::Entry top[4];
+    CHECK_EQ(t.top(top, 4), 4);
+    CHECK_EQ(top[0].frames, 20);
+    CHECK_EQ(top[1].frames, 19);
+    CHECK_EQ(top[3].frames, 17);
+}
+
+// Four transmitters with 10% of the frames each survive a long tail of one-off
+// addresses, rank first, and their counts bracket the truth.
+void testHeavyHittersSurvive() {
+    Talkers t;
+    uint8_t mac[6];
+    uint32_t tail = 1000;
+    const uint32_t rounds = 5000;
+    for (uint32_t r = 0; r < rounds; r++) {
+        for (uint32_t h = 0; h < 4; h++) {
+            makeMac(h, mac);
+            t.add(mac, 200, 0);
+        }
+        for (int k = 0; k < 6; k++) {
+            makeMac(tail++, mac);
+            t.add(mac, 60, 0);
+        }
+    }
+    CHECK_EQ(t.size(), 32);
+
+    Talkers::Entry top[4];
+    CHECK_EQ(t.top(top, 4), 4);
+    for (int i = 0; i < 4; i++) {
+        CHECK(top[i].mac[2] == 0 && top[i].mac[3] == 0 && top[i].mac[4] == 0 && top[i].mac[5] < 4);
+        CHECK(top[i].frames >= rounds);
+        CHECK(top[i].frames - top[i].error <= rounds);
+    }
+
+    // Every counter is still reachable through the index after ~30k replacements.
+    for (uint32_t h = 0; h < 4; h++) {
+        makeMac(h, mac);
+        CHECK(t.find(mac) != nullptr);
+    }
+    makeMac(tail - 1, mac);
+    CHECK(t.find(mac) != nullptr);  // Newest arrival always holds a counter
+    makeMac(1000, mac);
+    CHECK(t.find(mac) == nullptr);  // Oldest one-off long evicted
+}
+
+// Channels are attached when the dwell closes; marks from a discarded dwell are dropped.
+void testAssignChannel() {
+    Talkers t;
+    uint8_t a[6], b[6];
+    makeMac(1, a);
+    makeMac(2, b);
+    t.add(a, 100, 7);
+    t.add(b, 100, 6);   // Dwell 6 was discarded without a close
+    t.assignChannel(7, 11);
+    CHECK_EQ(t.find(a)->channel, 11);
+    CHECK_EQ(t.find(b)->channel, 0);
+
+    t.add(b, 100, 8);
+    t.assignChannel(8, 3);
+    CHECK_EQ(t.find(a)->channel, 11);  // Not heard in dwell 8: keeps its last channel
+    CHECK_EQ(t.find(b)->channel, 3);
+}
+
+void testDecay() {
+    Talkers t;
+    uint8_t mac[6];
+    makeMac(5, mac);
+    for (int i = 0; i < 9; i++) t.add(mac, 100, 0);
+    t.decay();
+    CHECK_EQ(t.find(mac)->frames, 4);
+    CHECK_EQ(t.find(mac)->bytes, 450);
+
+    // A decayed-to-zero counter is not listed, and is the first to be replaced.
+    Talkers::Entry top[2];
+    t.decay();
+    t.decay();
+    t.decay();
+    CHECK_EQ(t.top(top, 2), 0);
+}
+
+} // namespace
+
+int main() {
+    testExactWhenSmall();
+    testHeavyHittersSurvive();
+    testAssignChannel();
+    testDecay();
+    return checkResult("test_top_talkers");
+}